@@ -0,0 +1,106 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Throughput of the core generators.
+ *
+ * This benchmark is built twice by `make bench`: once calling into
+ * build/librandom.a and once with LIBRANDOM_INLINE defined, in which case the
+ * generators are inlined into the timing loops (see src/inline.h).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "dcmt.h"
+#include "kiss.h"
+#include "lfsr.h"
+#include "mt19937.h"
+
+#ifdef LIBRANDOM_INLINE
+#define MODE "inline"
+#else
+#define MODE "library"
+#endif
+
+/* Number of calls made to each generator. */
+#define CALLS 100000000L
+
+/* Number of outputs of each call of the bulk routines. */
+#define BLOCK 1024
+
+/* Time CALLS evaluations of the expression `call`, reporting ns per call. */
+#define BENCH(name, type, call)                                          \
+  do {                                                                   \
+    type sum = 0;                                                        \
+    clock_t start = clock();                                             \
+    for (long i = 0; i < CALLS; i++)                                     \
+      sum ^= (call);                                                     \
+    double ns = 1e9 * (double)(clock() - start) / CLOCKS_PER_SEC / CALLS; \
+    printf("%-8s %-14s %6.2f ns/call  (%llx)\n", MODE, name, ns,         \
+           (unsigned long long) sum);                                    \
+  } while (0)
+
+/* Time CALLS outputs of the bulk routine `fill` of the generator with the
+ * given state, BLOCK at a time, reporting ns per output. */
+#define BENCH_FILL(name, type, fill, state)                              \
+  do {                                                                   \
+    static type buffer[BLOCK];                                           \
+    type sum = 0;                                                        \
+    clock_t start = clock();                                             \
+    for (long i = 0; i < CALLS; i += BLOCK)                              \
+    {                                                                    \
+      fill(state, buffer, BLOCK);                                        \
+      sum ^= buffer[i % BLOCK];                                          \
+    }                                                                    \
+    double ns = 1e9 * (double)(clock() - start) / CLOCKS_PER_SEC / CALLS; \
+    printf("%-8s %-14s %6.2f ns/call  (%llx)\n", MODE, name, ns,         \
+           (unsigned long long) sum);                                    \
+  } while (0)
+
+int main(void)
+{
+  kiss32_state_t kiss32_state = { 123456789, 362436000, 521288629, 7654321 };
+  kiss32a_state_t kiss32a_state = { 123456789, 362436069, 21288629,
+                                    14921776, 0 };
+  kiss64_state_t kiss64_state = { UINT64_C(1066149217761810),
+                                  UINT64_C(362436362436362436),
+                                  UINT64_C(1234567890987654321),
+                                  UINT64_C(123456123456123456) };
+  taus88_state_t taus88_state = { 12345, 12345, 12345 };
+  lfsr113_state_t lfsr113_state = { 12345, 12345, 12345, 12345 };
+  lfsr258_state_t lfsr258_state = { UINT64_C(12345987654321),
+                                    UINT64_C(12345987654321),
+                                    UINT64_C(12345987654321),
+                                    UINT64_C(12345987654321),
+                                    UINT64_C(12345987654321) };
+
+  const dcmt_params_t dcmt_params = DCMT_PARAMS_MT19937;
+  mt19937ar_state_t mt19937ar_state;
+  dcmt_state_t dcmt_state;
+
+  init_mt19937ar(UINT32_C(5489));
+  init_mt19937_64(UINT32_C(5489));
+  init_mt19937ar_r(&mt19937ar_state, UINT32_C(5489));
+  init_dcmt(&dcmt_state, &dcmt_params, UINT32_C(5489));
+
+  BENCH("kiss32", uint32_t, kiss32(&kiss32_state));
+  BENCH("kiss32a", uint32_t, kiss32a(&kiss32a_state));
+  BENCH("kiss64", uint64_t, kiss64(&kiss64_state));
+  BENCH("taus88", uint32_t, taus88(&taus88_state));
+  BENCH("lfsr113", uint32_t, lfsr113(&lfsr113_state));
+  BENCH("lfsr258", uint64_t, lfsr258(&lfsr258_state));
+  BENCH("mt19937ar", uint32_t, mt19937ar());
+  BENCH("mt19937_64", uint64_t, mt19937_64());
+  BENCH("dcmt", uint32_t, dcmt(&dcmt_state));
+
+  /* dcmt with the parameters of MT19937 against the hard-coded generator,
+   * from the same seed. */
+  init_dcmt(&dcmt_state, &dcmt_params, UINT32_C(5489));
+  BENCH_FILL("mt19937ar_fill", uint32_t, mt19937ar_fill, &mt19937ar_state);
+  BENCH_FILL("dcmt_fill", uint32_t, dcmt_fill, &dcmt_state);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,352 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Banks of independent streams stored in structure-of-arrays layout. */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+
+#include "bank.h"
+
+/* Number of 32-bit words per aligned block. */
+#define ALIGN_WORDS (RANDOM_BANK_ALIGN / sizeof(uint32_t))
+
+/* Allocate k aligned arrays of n 32-bit words as one block, storing the
+ * address of each in words[0..k-1]. Returns zero on success; on failure the
+ * addresses are NULL, so that the bank may still be freed. */
+static int alloc_arrays (uint32_t **words[], int k, size_t n)
+{
+  size_t stride = (n + ALIGN_WORDS - 1) / ALIGN_WORDS * ALIGN_WORDS;
+  void *base;
+  int j;
+
+  for (j = 0; j < k; j++)
+    *words[j] = NULL;
+
+  if (stride == 0)
+    stride = ALIGN_WORDS;
+  if (stride > (size_t) -1 / sizeof(uint32_t) / k)
+    return -1;
+  if (posix_memalign(&base, RANDOM_BANK_ALIGN, k * stride * sizeof(uint32_t)))
+    return -1;
+
+  for (j = 0; j < k; j++)
+    *words[j] = (uint32_t *) base + j * stride;
+
+  return 0;
+}
+
+/* The loops below are written so that they vectorise: the arrays are passed
+ * to the kernels as restrict qualified parameters, the loop bodies are free
+ * of branches, and masked streams are handled by blending the old and the
+ * new state with an all-ones or all-zeros mask word rather than by skipping
+ * them. The output is blended in the same way, so out[i] is read and
+ * rewritten for every stream; a conditional store would vectorise only with
+ * the masked stores of AVX and later. */
+
+/* Select a where the mask word m is all ones and b where it is zero. */
+#define BLEND(m, a, b) (((a) & (m)) | ((b) & ~(m)))
+
+#ifdef UINT64_C
+
+int kiss32_bank_init (kiss32_bank_t *bank, size_t n)
+{
+  uint32_t **words[] = { &bank->mx, &bank->my, &bank->mz, &bank->mc };
+
+  bank->n = n;
+  return alloc_arrays(words, 4, n);
+}
+
+void kiss32_bank_free (kiss32_bank_t *bank)
+{
+  free(bank->mx);
+  bank->mx = bank->my = bank->mz = bank->mc = NULL;
+  bank->n = 0;
+}
+
+void kiss32_bank_load (kiss32_bank_t *bank, const kiss32_state_t *states)
+{
+  size_t i;
+
+  for (i = 0; i < bank->n; i++)
+  {
+    bank->mx[i] = states[i].mx;
+    bank->my[i] = states[i].my;
+    bank->mz[i] = states[i].mz;
+    bank->mc[i] = states[i].mc;
+  }
+}
+
+void kiss32_bank_store (const kiss32_bank_t *bank, kiss32_state_t *states)
+{
+  size_t i;
+
+  for (i = 0; i < bank->n; i++)
+  {
+    states[i].mx = bank->mx[i];
+    states[i].my = bank->my[i];
+    states[i].mz = bank->mz[i];
+    states[i].mc = bank->mc[i];
+  }
+}
+
+static void kiss32_step (size_t n, uint32_t *restrict mx,
+                         uint32_t *restrict my, uint32_t *restrict mz,
+                         uint32_t *restrict mc, uint32_t *restrict o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    uint32_t x = 69069*mx[i] + 12345;
+    uint32_t y = my[i];
+    uint64_t t = UINT64_C(698769069)*mz[i] + mc[i];
+
+    y ^= (y << 13);
+    y ^= (y >> 17);
+    y ^= (y <<  5);
+
+    mx[i] = x;
+    my[i] = y;
+    mz[i] = (uint32_t) t;
+    mc[i] = (uint32_t) (t >> 32);
+    o[i] = x + y + (uint32_t) t;
+  }
+}
+
+void kiss32_bank_step_all (kiss32_bank_t *bank, uint32_t *out)
+{
+  kiss32_step(bank->n, bank->mx, bank->my, bank->mz, bank->mc, out);
+}
+
+static void kiss32_step_masked (size_t n, uint32_t *restrict mx,
+                                uint32_t *restrict my, uint32_t *restrict mz,
+                                uint32_t *restrict mc,
+                                const uint8_t *restrict m,
+                                uint32_t *restrict o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    uint32_t x = 69069*mx[i] + 12345;
+    uint32_t y = my[i];
+    uint64_t t = UINT64_C(698769069)*mz[i] + mc[i];
+    uint32_t on = -(uint32_t) (m[i] != 0);
+
+    y ^= (y << 13);
+    y ^= (y >> 17);
+    y ^= (y <<  5);
+
+    mx[i] = BLEND(on, x, mx[i]);
+    my[i] = BLEND(on, y, my[i]);
+    mz[i] = BLEND(on, (uint32_t) t, mz[i]);
+    mc[i] = BLEND(on, (uint32_t) (t >> 32), mc[i]);
+    o[i] = BLEND(on, x + y + (uint32_t) t, o[i]);
+  }
+}
+
+void kiss32_bank_step_masked (kiss32_bank_t *bank, const uint8_t *mask,
+                              uint32_t *out)
+{
+  kiss32_step_masked(bank->n, bank->mx, bank->my, bank->mz, bank->mc, mask,
+                     out);
+}
+
+#endif /* ifdef UINT64_C */
+
+#define TAUSWORTHE(s,a,b,c,d) (((s&c)<<d) ^ (((s <<a) ^ s)>>b))
+
+int taus88_bank_init (taus88_bank_t *bank, size_t n)
+{
+  uint32_t **words[] = { &bank->s1, &bank->s2, &bank->s3 };
+
+  bank->n = n;
+  return alloc_arrays(words, 3, n);
+}
+
+void taus88_bank_free (taus88_bank_t *bank)
+{
+  free(bank->s1);
+  bank->s1 = bank->s2 = bank->s3 = NULL;
+  bank->n = 0;
+}
+
+void taus88_bank_load (taus88_bank_t *bank, const taus88_state_t *states)
+{
+  size_t i;
+
+  for (i = 0; i < bank->n; i++)
+  {
+    bank->s1[i] = states[i].s1;
+    bank->s2[i] = states[i].s2;
+    bank->s3[i] = states[i].s3;
+  }
+}
+
+void taus88_bank_store (const taus88_bank_t *bank, taus88_state_t *states)
+{
+  size_t i;
+
+  for (i = 0; i < bank->n; i++)
+  {
+    states[i].s1 = bank->s1[i];
+    states[i].s2 = bank->s2[i];
+    states[i].s3 = bank->s3[i];
+  }
+}
+
+static void taus88_step (size_t n, uint32_t *restrict s1,
+                         uint32_t *restrict s2, uint32_t *restrict s3,
+                         uint32_t *restrict o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    uint32_t z1 = TAUSWORTHE(s1[i], 13, 19, UINT32_C(4294967294), 12);
+    uint32_t z2 = TAUSWORTHE(s2[i],  2, 25, UINT32_C(4294967288),  4);
+    uint32_t z3 = TAUSWORTHE(s3[i],  3, 11, UINT32_C(4294967280), 17);
+
+    s1[i] = z1;
+    s2[i] = z2;
+    s3[i] = z3;
+    o[i] = z1 ^ z2 ^ z3;
+  }
+}
+
+void taus88_bank_step_all (taus88_bank_t *bank, uint32_t *out)
+{
+  taus88_step(bank->n, bank->s1, bank->s2, bank->s3, out);
+}
+
+static void taus88_step_masked (size_t n, uint32_t *restrict s1,
+                                uint32_t *restrict s2, uint32_t *restrict s3,
+                                const uint8_t *restrict m,
+                                uint32_t *restrict o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    uint32_t z1 = TAUSWORTHE(s1[i], 13, 19, UINT32_C(4294967294), 12);
+    uint32_t z2 = TAUSWORTHE(s2[i],  2, 25, UINT32_C(4294967288),  4);
+    uint32_t z3 = TAUSWORTHE(s3[i],  3, 11, UINT32_C(4294967280), 17);
+    uint32_t on = -(uint32_t) (m[i] != 0);
+
+    s1[i] = BLEND(on, z1, s1[i]);
+    s2[i] = BLEND(on, z2, s2[i]);
+    s3[i] = BLEND(on, z3, s3[i]);
+    o[i] = BLEND(on, z1 ^ z2 ^ z3, o[i]);
+  }
+}
+
+void taus88_bank_step_masked (taus88_bank_t *bank, const uint8_t *mask,
+                              uint32_t *out)
+{
+  taus88_step_masked(bank->n, bank->s1, bank->s2, bank->s3, mask, out);
+}
+
+int lfsr113_bank_init (lfsr113_bank_t *bank, size_t n)
+{
+  uint32_t **words[] = { &bank->s1, &bank->s2, &bank->s3, &bank->s4 };
+
+  bank->n = n;
+  return alloc_arrays(words, 4, n);
+}
+
+void lfsr113_bank_free (lfsr113_bank_t *bank)
+{
+  free(bank->s1);
+  bank->s1 = bank->s2 = bank->s3 = bank->s4 = NULL;
+  bank->n = 0;
+}
+
+void lfsr113_bank_load (lfsr113_bank_t *bank, const lfsr113_state_t *states)
+{
+  size_t i;
+
+  for (i = 0; i < bank->n; i++)
+  {
+    bank->s1[i] = states[i].s1;
+    bank->s2[i] = states[i].s2;
+    bank->s3[i] = states[i].s3;
+    bank->s4[i] = states[i].s4;
+  }
+}
+
+void lfsr113_bank_store (const lfsr113_bank_t *bank, lfsr113_state_t *states)
+{
+  size_t i;
+
+  for (i = 0; i < bank->n; i++)
+  {
+    states[i].s1 = bank->s1[i];
+    states[i].s2 = bank->s2[i];
+    states[i].s3 = bank->s3[i];
+    states[i].s4 = bank->s4[i];
+  }
+}
+
+static void lfsr113_step (size_t n, uint32_t *restrict s1,
+                          uint32_t *restrict s2, uint32_t *restrict s3,
+                          uint32_t *restrict s4, uint32_t *restrict o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    uint32_t z1 = TAUSWORTHE(s1[i],  6, 13, UINT32_C(4294967294), 18);
+    uint32_t z2 = TAUSWORTHE(s2[i],  2, 27, UINT32_C(4294967288),  2);
+    uint32_t z3 = TAUSWORTHE(s3[i], 13, 21, UINT32_C(4294967280),  7);
+    uint32_t z4 = TAUSWORTHE(s4[i],  3, 12, UINT32_C(4294967168), 13);
+
+    s1[i] = z1;
+    s2[i] = z2;
+    s3[i] = z3;
+    s4[i] = z4;
+    o[i] = z1 ^ z2 ^ z3 ^ z4;
+  }
+}
+
+void lfsr113_bank_step_all (lfsr113_bank_t *bank, uint32_t *out)
+{
+  lfsr113_step(bank->n, bank->s1, bank->s2, bank->s3, bank->s4, out);
+}
+
+static void lfsr113_step_masked (size_t n, uint32_t *restrict s1,
+                                 uint32_t *restrict s2, uint32_t *restrict s3,
+                                 uint32_t *restrict s4,
+                                 const uint8_t *restrict m,
+                                 uint32_t *restrict o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    uint32_t z1 = TAUSWORTHE(s1[i],  6, 13, UINT32_C(4294967294), 18);
+    uint32_t z2 = TAUSWORTHE(s2[i],  2, 27, UINT32_C(4294967288),  2);
+    uint32_t z3 = TAUSWORTHE(s3[i], 13, 21, UINT32_C(4294967280),  7);
+    uint32_t z4 = TAUSWORTHE(s4[i],  3, 12, UINT32_C(4294967168), 13);
+    uint32_t on = -(uint32_t) (m[i] != 0);
+
+    s1[i] = BLEND(on, z1, s1[i]);
+    s2[i] = BLEND(on, z2, s2[i]);
+    s3[i] = BLEND(on, z3, s3[i]);
+    s4[i] = BLEND(on, z4, s4[i]);
+    o[i] = BLEND(on, z1 ^ z2 ^ z3 ^ z4, o[i]);
+  }
+}
+
+void lfsr113_bank_step_masked (lfsr113_bank_t *bank, const uint8_t *mask,
+                               uint32_t *out)
+{
+  lfsr113_step_masked(bank->n, bank->s1, bank->s2, bank->s3, bank->s4, mask,
+                      out);
+}
+
+#undef TAUSWORTHE
+#undef BLEND
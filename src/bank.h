@@ -0,0 +1,104 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Banks of independent streams stored in structure-of-arrays layout.
+ *
+ * Simulations which keep one generator per particle typically store an array
+ * of state structs, e.g. an array of lfsr113_state_t. Stepping every stream
+ * then accesses the state words with a stride, which prevents the loop from
+ * being vectorised. A bank instead stores the n states of a generator as one
+ * array per state word, so that word j of stream i is sj[i], with each array
+ * aligned to RANDOM_BANK_ALIGN bytes. The kernels below then step all streams
+ * with unit-stride, vectorisable loops; build with e.g. -march=native to use
+ * the widest vector instructions of the host.
+ *
+ * Each kernel advances every (selected) stream by exactly one step, so that
+ * stream i of a bank produces the same sequence as the corresponding
+ * generator called with state i. States are copied into and out of a bank
+ * with the _bank_load and _bank_store routines.
+ *
+ * The _bank_init routines return zero on success or -1 if the memory could
+ * not be allocated. Banks are released with the corresponding _bank_free,
+ * which may also be called on a bank whose initialisation failed.
+ */
+
+#ifndef BANK_H_
+#define BANK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kiss.h"
+#include "lfsr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Alignment in bytes of each array of a bank: a cache line, and the width of
+ * the widest vector registers. */
+#define RANDOM_BANK_ALIGN 64
+
+#ifdef UINT64_C
+
+/* Bank of n kiss32 streams. */
+typedef struct {
+  size_t n;
+  uint32_t *mx, *my, *mz, *mc;
+} kiss32_bank_t;
+
+/* Allocate a bank of n kiss32 streams, with unspecified states. */
+int kiss32_bank_init (kiss32_bank_t *bank, size_t n);
+void kiss32_bank_free (kiss32_bank_t *bank);
+
+/* Copy states[0..n-1] into, or out of, the n streams of the bank. */
+void kiss32_bank_load (kiss32_bank_t *bank, const kiss32_state_t *states);
+void kiss32_bank_store (const kiss32_bank_t *bank, kiss32_state_t *states);
+
+/* Step every stream i of the bank, storing its output in out[i]. */
+void kiss32_bank_step_all (kiss32_bank_t *bank, uint32_t *out);
+
+/* Step only the streams i for which mask[i] is non-zero, storing the output
+ * in out[i]. Other streams do not advance and out[i] keeps its value, so out
+ * must be initialised: every element is read, and rewritten, whatever the
+ * mask, and must not be written concurrently by another thread. */
+void kiss32_bank_step_masked (kiss32_bank_t *bank, const uint8_t *mask,
+                              uint32_t *out);
+
+#endif /* ifdef UINT64_C */
+
+/* Bank of n taus88 streams. */
+typedef struct {
+  size_t n;
+  uint32_t *s1, *s2, *s3;
+} taus88_bank_t;
+
+int taus88_bank_init (taus88_bank_t *bank, size_t n);
+void taus88_bank_free (taus88_bank_t *bank);
+void taus88_bank_load (taus88_bank_t *bank, const taus88_state_t *states);
+void taus88_bank_store (const taus88_bank_t *bank, taus88_state_t *states);
+void taus88_bank_step_all (taus88_bank_t *bank, uint32_t *out);
+void taus88_bank_step_masked (taus88_bank_t *bank, const uint8_t *mask,
+                              uint32_t *out);
+
+/* Bank of n lfsr113 streams. */
+typedef struct {
+  size_t n;
+  uint32_t *s1, *s2, *s3, *s4;
+} lfsr113_bank_t;
+
+int lfsr113_bank_init (lfsr113_bank_t *bank, size_t n);
+void lfsr113_bank_free (lfsr113_bank_t *bank);
+void lfsr113_bank_load (lfsr113_bank_t *bank, const lfsr113_state_t *states);
+void lfsr113_bank_store (const lfsr113_bank_t *bank, lfsr113_state_t *states);
+void lfsr113_bank_step_all (lfsr113_bank_t *bank, uint32_t *out);
+void lfsr113_bank_step_masked (lfsr113_bank_t *bank, const uint8_t *mask,
+                               uint32_t *out);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* BANK_H_ */
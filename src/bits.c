@@ -0,0 +1,157 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Random bits and bit-sliced Bernoulli trials. */
+
+#include <math.h>
+
+#include "bits.h"
+
+static uint64_t next_word (random_bits_t *bits)
+{
+  if (bits->next == RANDOM_BITS_BUFFER)
+  {
+    random_fill64_distribution(bits->rng, bits->buffer, RANDOM_BITS_BUFFER);
+    bits->next = 0;
+  }
+
+  return bits->buffer[bits->next++];
+}
+
+void random_bits_init (random_bits_t *bits, random_t *rng)
+{
+  bits->rng = rng;
+  bits->word = 0;
+  bits->count = 0;
+  bits->next = RANDOM_BITS_BUFFER;
+}
+
+uint64_t random_bits_refill (random_bits_t *bits, unsigned k)
+{
+  /* The count bits left, then k - count from the bottom of a new word. */
+  const unsigned used = k - bits->count;
+  const uint64_t w = next_word(bits);
+  uint64_t v = bits->word | (w << bits->count);
+
+  if (k < 64)
+    v &= (UINT64_C(1) << k) - 1;
+
+  if (used == 64)
+  {
+    bits->word = 0;
+    bits->count = 0;
+  }
+  else
+  {
+    bits->word = w >> used;
+    bits->count = 64 - used;
+  }
+
+  return v;
+}
+
+void random_bits_fill (random_bits_t *bits, uint64_t *out, size_t n)
+{
+  const size_t words = n / 64;
+  size_t i = 0;
+
+  if (bits->count == 0)
+  {
+    /* Whole words: those buffered, then directly from the generator. */
+    while (i < words && bits->next < RANDOM_BITS_BUFFER)
+      out[i++] = bits->buffer[bits->next++];
+    if (i < words)
+      random_fill64_distribution(bits->rng, out + i, words - i);
+  }
+  else
+  {
+    for (; i < words; i++)
+      out[i] = random_bits(bits, 64);
+  }
+
+  if (n % 64 != 0)
+    out[words] = random_bits(bits, n % 64);
+}
+
+/* The binary expansion of p in (0, 1): zeros leading digits, then the 53
+ * bits of mantissa, most significant first. */
+typedef struct {
+  int zeros;
+  uint64_t mantissa;
+} expansion_t;
+
+static expansion_t expand (double p)
+{
+  expansion_t x;
+  int e;
+
+  x.mantissa = (uint64_t) ldexp(frexp(p, &e), 53);
+  x.zeros = -e;
+
+  return x;
+}
+
+/* Lanes are undecided while their digits equal those of p. A lane with a
+ * zero where p has a one is less than p, and one with a one where p has a
+ * zero is greater; the lanes equal to p where its digits end are not less
+ * than it. */
+static uint64_t bernoulli (random_bits_t *bits, expansion_t x)
+{
+  uint64_t undecided = ~UINT64_C(0), result = 0, m = x.mantissa;
+  int i;
+
+  for (i = 0; i < x.zeros && undecided != 0; i++)
+    undecided &= ~random_bits(bits, 64);
+
+  for (; m != 0 && undecided != 0; m = (m << 1) & ((UINT64_C(1) << 53) - 1))
+  {
+    const uint64_t u = random_bits(bits, 64);
+
+    if (m & (UINT64_C(1) << 52))
+    {
+      result |= undecided & ~u;
+      undecided &= u;
+    }
+    else
+    {
+      undecided &= ~u;
+    }
+  }
+
+  return result;
+}
+
+uint64_t random_bernoulli64 (random_bits_t *bits, double p)
+{
+  if (!(p > 0))
+    return 0;
+  if (p >= 1)
+    return ~UINT64_C(0);
+
+  return bernoulli(bits, expand(p));
+}
+
+void random_bernoulli_fill (random_bits_t *bits, double p, uint64_t *out,
+                            size_t n)
+{
+  const size_t words = (n + 63) / 64;
+  size_t i;
+
+  if (!(p > 0) || p >= 1)
+  {
+    for (i = 0; i < words; i++)
+      out[i] = p >= 1 ? ~UINT64_C(0) : 0;
+  }
+  else
+  {
+    const expansion_t x = expand(p);
+
+    for (i = 0; i < words; i++)
+      out[i] = bernoulli(bits, x);
+  }
+
+  if (n % 64 != 0)
+    out[words - 1] &= (UINT64_C(1) << (n % 64)) - 1;
+}
@@ -0,0 +1,111 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Random bits and bit-sliced Bernoulli trials from any of the generators of
+ * generator.h.
+ *
+ * A random_bits_t hands out the bits of the 64-bit words of a generator (see
+ * random_fill64()) one or a few at a time, from the least significant bit of
+ * each word up, so that no output is wasted on a single bit or a small
+ * field. The common case, taking bits from the current word, is inline.
+ *
+ * random_bernoulli64() makes 64 independent Bernoulli(p) trials at once,
+ * lane i of each word standing for trial i. Trial i succeeds if the uniform
+ * deviate U_i = 0.u_1 u_2 u_3 ... (binary), whose bits u_k are bit i of
+ * successive words, is less than p = 0.p_1 p_2 p_3 ... . The digits are
+ * compared from the first, 64 lanes at a time with bitwise operations, until
+ * every lane has differed from p: a lane with u_k < p_k succeeds, and one
+ * with u_k > p_k fails. As each word decides half the undecided lanes,
+ * whatever the digit of p, a mask takes on average fewer than 8 words for any
+ * p, rather than the 64 of comparing a uniform deviate per trial, and fewer
+ * still if the expansion of p is short: 0.5 takes a single word. The trials
+ * are exact, as p is compared to all of its binary digits.
+ *
+ * Words consumed are counted as outputs of the distribution API of stats.h.
+ */
+
+#ifndef BITS_H_
+#define BITS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of words drawn from the generator at a time. */
+#define RANDOM_BITS_BUFFER 32
+
+/* Stream of random bits. */
+typedef struct {
+  random_t *rng;
+  uint64_t word;     /* Bits not yet used, in the low count bits. */
+  unsigned count;
+  size_t next;       /* Index of the next unused word of buffer. */
+  uint64_t buffer[RANDOM_BITS_BUFFER];
+} random_bits_t;
+
+/* Start a stream of bits drawn from rng, which must outlive the stream. */
+void random_bits_init (random_bits_t *bits, random_t *rng);
+
+/* Return the next k bits, 0 <= k <= 64, as the low k bits of the result; the
+ * first bit is the least significant. Called by random_bits() when the
+ * current word has fewer than k bits left. */
+uint64_t random_bits_refill (random_bits_t *bits, unsigned k);
+
+/* Return the next k bits of the stream, as random_bits_refill(). */
+static inline uint64_t random_bits (random_bits_t *bits, unsigned k)
+{
+  uint64_t v;
+
+  if (k > bits->count)
+    return random_bits_refill(bits, k);
+
+  if (k == 64)
+  {
+    v = bits->word;
+    bits->word = 0;
+  }
+  else
+  {
+    v = bits->word & ((UINT64_C(1) << k) - 1);
+    bits->word >>= k;
+  }
+  bits->count -= k;
+
+  return v;
+}
+
+/* Return the next bit of the stream. */
+static inline unsigned random_bit (random_bits_t *bits)
+{
+  return (unsigned) random_bits(bits, 1);
+}
+
+/* Store the next n bits of the stream in out[0..(n + 63) / 64 - 1], packed
+ * 64 to a word from the least significant bit, with any unused bits of the
+ * last word zero. Equivalent to calls of random_bits(bits, 64), and a final
+ * random_bits(bits, n % 64). */
+void random_bits_fill (random_bits_t *bits, uint64_t *out, size_t n);
+
+/* Return a mask of 64 independent Bernoulli(p) trials: each bit is set with
+ * probability p, or never if p <= 0 (or NaN) and always if p >= 1. The words
+ * compared are whole 64-bit fields of the stream. */
+uint64_t random_bernoulli64 (random_bits_t *bits, double p);
+
+/* Store n independent Bernoulli(p) trials in out, packed as by
+ * random_bits_fill(): as random_bernoulli64() for each word, with any
+ * unused bits of the last word zero. */
+void random_bernoulli_fill (random_bits_t *bits, double p, uint64_t *out,
+                            size_t n);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* BITS_H_ */
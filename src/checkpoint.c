@@ -0,0 +1,597 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Binary checkpoints of arrays of generator states. */
+
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+#include "checkpoint.h"
+#include "dcmt.h"
+#include "mt19937.h"
+#include "pcg.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAVE_MMAP 1
+#endif
+
+static const char MAGIC[8] = { 'L', 'I', 'B', 'R', 'N', 'D', 'C', 'K' };
+
+#define CHECKSUM_BASIS UINT64_C(0xcbf29ce484222325)
+#define CHECKSUM_PRIME UINT64_C(0x100000001b3)
+
+/* Number of bytes of the header covered by the checksum. */
+#define CHECKSUM_HEADER_SIZE 32
+
+/* Returned by map_file() if the records do not have the layout of the state
+ * type on this machine, and must be read instead. */
+#define MAP_UNSUITABLE 1
+
+/* Records are encoded and decoded CHUNK_RECORDS at a time. A multiple of 8,
+ * so that all but the last chunk are a whole number of 64-bit words. */
+#define CHUNK_RECORDS 4096
+
+static void store_le32 (unsigned char *p, uint32_t x)
+{
+  p[0] = (unsigned char) x;         p[1] = (unsigned char)(x >> 8);
+  p[2] = (unsigned char)(x >> 16);  p[3] = (unsigned char)(x >> 24);
+}
+
+static void store_le64 (unsigned char *p, uint64_t x)
+{
+  store_le32(p, (uint32_t) x);
+  store_le32(p + 4, (uint32_t)(x >> 32));
+}
+
+static uint32_t load_le32 (const unsigned char *p)
+{
+  return (uint32_t) p[0] | (uint32_t) p[1] << 8
+       | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static uint64_t load_le64 (const unsigned char *p)
+{
+  return (uint64_t) load_le32(p) | (uint64_t) load_le32(p + 4) << 32;
+}
+
+static int host_little_endian (void)
+{
+  const uint32_t one = 1;
+  unsigned char first;
+
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+/* Size of the record of a state: its words and index, without padding. */
+static size_t record_size (const random_generator_info_t *info)
+{
+  return info->state_words * (info->word_bits / 8)
+         + (info->state_index ? 4 : 0);
+}
+
+/* Whether the state type of generator id holds pcg128_t values whose words
+ * are in the opposite order to that of the records, low word first. */
+static int swap_pairs (random_generator_id_t id)
+{
+#ifdef PCG_HAS_UINT128
+  return (id == RANDOM_PCG64 || id == RANDOM_PCG64_DXSM
+          || id == RANDOM_LCG128) && !host_little_endian();
+#else
+  (void) id;
+  return 0;
+#endif
+}
+
+/* Whether the n states of generator id can be stepped without reading or
+ * writing outside them: the index of the Mersenne Twister states must lie in
+ * [0, nn + 1], and the parameters of the dcmt states must be valid. */
+static int states_valid (random_generator_id_t id,
+                         const unsigned char *states, size_t n)
+{
+  const random_generator_info_t *info = random_generator_info(id);
+  const size_t offset = info->state_words * (info->word_bits / 8);
+
+  if (!info->state_index)
+    return 1;
+
+  for (; n > 0; n--, states += info->state_size)
+  {
+    dcmt_params_t params;
+    uint32_t nn = 0;
+    int32_t index;
+
+    switch (id)
+    {
+      case RANDOM_MT19937AR:
+        nn = MT19937AR_N;
+        break;
+      case RANDOM_MT19937_64:
+        nn = MT19937_64_NN;
+        break;
+      case RANDOM_DCMT:
+        memcpy(&params, states, sizeof(params));
+        if (!dcmt_params_valid(&params))
+          return 0;
+        nn = params.nn;
+        break;
+      default:
+        break;
+    }
+
+    memcpy(&index, states + offset, 4);
+    if (index < 0 || (uint32_t) index > nn + 1)
+      return 0;
+  }
+
+  return 1;
+}
+
+/* Add the n bytes at p to the checksum h. Unless this is the final call, n
+ * must be a multiple of 8. */
+static uint64_t checksum_update (uint64_t h, const unsigned char *p, size_t n)
+{
+  for (; n >= 8; p += 8, n -= 8)
+  {
+    h = (h ^ load_le64(p)) * CHECKSUM_PRIME;
+    h ^= h >> 32;
+  }
+
+  if (n > 0)
+  {
+    unsigned char tail[8] = { 0 };
+
+    memcpy(tail, p, n);
+    h = (h ^ load_le64(tail)) * CHECKSUM_PRIME;
+    h ^= h >> 32;
+  }
+
+  return h;
+}
+
+/* Encode n states of generator id as records. */
+static void encode_records (random_generator_id_t id,
+                            const unsigned char *states,
+                            unsigned char *records, size_t n)
+{
+  const random_generator_info_t *info = random_generator_info(id);
+  const size_t bytes = info->word_bits / 8;
+  const size_t offset = info->state_words * bytes;
+  const size_t size = record_size(info);
+  const size_t swap = swap_pairs(id) ? 1 : 0;
+
+  for (; n > 0; n--)
+  {
+    size_t i;
+
+    for (i = 0; i < info->state_words; i++)
+    {
+      if (bytes == 4)
+      {
+        uint32_t w;
+        memcpy(&w, states + 4*i, 4);
+        store_le32(records + 4*i, w);
+      }
+      else
+      {
+        uint64_t w;
+        memcpy(&w, states + 8*(i ^ swap), 8);
+        store_le64(records + 8*i, w);
+      }
+    }
+
+    if (info->state_index)
+    {
+      int32_t index;
+      memcpy(&index, states + offset, 4);
+      store_le32(records + offset, (uint32_t) index);
+    }
+
+    states += info->state_size;
+    records += size;
+  }
+}
+
+/* Decode n records as states of generator id. Any padding of the states is
+ * left unchanged. */
+static void decode_records (random_generator_id_t id,
+                            const unsigned char *records,
+                            unsigned char *states, size_t n)
+{
+  const random_generator_info_t *info = random_generator_info(id);
+  const size_t bytes = info->word_bits / 8;
+  const size_t offset = info->state_words * bytes;
+  const size_t size = record_size(info);
+  const size_t swap = swap_pairs(id) ? 1 : 0;
+
+  for (; n > 0; n--)
+  {
+    size_t i;
+
+    for (i = 0; i < info->state_words; i++)
+    {
+      if (bytes == 4)
+      {
+        uint32_t w = load_le32(records + 4*i);
+        memcpy(states + 4*i, &w, 4);
+      }
+      else
+      {
+        uint64_t w = load_le64(records + 8*i);
+        memcpy(states + 8*(i ^ swap), &w, 8);
+      }
+    }
+
+    if (info->state_index)
+    {
+      int32_t index = (int32_t) load_le32(records + offset);
+      memcpy(states + offset, &index, 4);
+    }
+
+    states += info->state_size;
+    records += size;
+  }
+}
+
+static void encode_header (unsigned char *raw, random_generator_id_t id,
+                           uint64_t count, uint64_t checksum)
+{
+  const random_generator_info_t *info = random_generator_info(id);
+
+  memset(raw, 0, RANDOM_CHECKPOINT_HEADER_SIZE);
+  memcpy(raw, MAGIC, sizeof(MAGIC));
+  store_le32(raw + 8, RANDOM_CHECKPOINT_VERSION);
+  store_le32(raw + 12, (uint32_t) id);
+  store_le32(raw + 16, info->word_bits);
+  store_le32(raw + 20, (uint32_t) record_size(info));
+  store_le64(raw + 24, count);
+  store_le64(raw + 32, checksum);
+}
+
+static int decode_header (const unsigned char *raw,
+                          random_checkpoint_header_t *header)
+{
+  const random_generator_info_t *info;
+  uint32_t id;
+
+  if (memcmp(raw, MAGIC, sizeof(MAGIC)) != 0)
+    return RANDOM_CHECKPOINT_EFORMAT;
+
+  header->version = load_le32(raw + 8);
+  if (header->version != RANDOM_CHECKPOINT_VERSION)
+    return RANDOM_CHECKPOINT_EVERSION;
+
+  id = load_le32(raw + 12);
+  info = random_generator_info((random_generator_id_t) id);
+  if (info == NULL)
+    return RANDOM_CHECKPOINT_EGENERATOR;
+
+  if (load_le32(raw + 16) != info->word_bits
+      || load_le32(raw + 20) != record_size(info))
+    return RANDOM_CHECKPOINT_EFORMAT;
+
+  header->generator = (random_generator_id_t) id;
+  header->count = load_le64(raw + 24);
+  header->checksum = load_le64(raw + 32);
+
+  if (header->count > SIZE_MAX / info->state_size
+      || header->count > SIZE_MAX / record_size(info))
+    return RANDOM_CHECKPOINT_EFORMAT;
+
+  return RANDOM_CHECKPOINT_OK;
+}
+
+int random_checkpoint_write (FILE *stream, random_generator_id_t id,
+                             const void *states, size_t count)
+{
+  const random_generator_info_t *info = random_generator_info(id);
+  const unsigned char *s = states;
+  unsigned char raw[RANDOM_CHECKPOINT_HEADER_SIZE];
+  unsigned char *buffer;
+  uint64_t checksum;
+  size_t size, i, n;
+
+  if (info == NULL)
+    return RANDOM_CHECKPOINT_EGENERATOR;
+
+  size = record_size(info);
+  buffer = malloc(CHUNK_RECORDS * size);
+  if (buffer == NULL)
+    return RANDOM_CHECKPOINT_EIO;
+
+  /* The checksum precedes the records, so the records are encoded twice
+   * rather than requiring a seekable stream. */
+  encode_header(raw, id, count, 0);
+  checksum = checksum_update(CHECKSUM_BASIS, raw, CHECKSUM_HEADER_SIZE);
+
+  for (i = 0; i < count; i += n)
+  {
+    n = (count - i < CHUNK_RECORDS) ? count - i : CHUNK_RECORDS;
+    encode_records(id, s + i * info->state_size, buffer, n);
+    checksum = checksum_update(checksum, buffer, n * size);
+  }
+
+  encode_header(raw, id, count, checksum);
+  if (fwrite(raw, sizeof(raw), 1, stream) != 1)
+    goto error;
+
+  for (i = 0; i < count; i += n)
+  {
+    n = (count - i < CHUNK_RECORDS) ? count - i : CHUNK_RECORDS;
+    encode_records(id, s + i * info->state_size, buffer, n);
+    if (fwrite(buffer, size, n, stream) != n)
+      goto error;
+  }
+
+  free(buffer);
+  return RANDOM_CHECKPOINT_OK;
+
+error:
+  free(buffer);
+  return RANDOM_CHECKPOINT_EIO;
+}
+
+/* Read the header of a checkpoint, keeping its raw bytes. */
+static int read_header (FILE *stream, random_checkpoint_header_t *header,
+                        unsigned char *raw)
+{
+  if (fread(raw, RANDOM_CHECKPOINT_HEADER_SIZE, 1, stream) != 1)
+    return ferror(stream) ? RANDOM_CHECKPOINT_EIO : RANDOM_CHECKPOINT_EFORMAT;
+
+  return decode_header(raw, header);
+}
+
+int random_checkpoint_read_header (FILE *stream,
+                                   random_checkpoint_header_t *header)
+{
+  unsigned char raw[RANDOM_CHECKPOINT_HEADER_SIZE];
+
+  return read_header(stream, header, raw);
+}
+
+int random_checkpoint_read (FILE *stream, random_generator_id_t id,
+                            void *states, size_t capacity, size_t *count)
+{
+  const random_generator_info_t *info;
+  random_checkpoint_header_t header;
+  unsigned char raw[RANDOM_CHECKPOINT_HEADER_SIZE];
+  unsigned char *s = states;
+  unsigned char *buffer;
+  uint64_t checksum;
+  size_t size, i, n;
+  int status;
+
+  status = read_header(stream, &header, raw);
+  if (status != RANDOM_CHECKPOINT_OK)
+    return status;
+
+  if (header.generator != id)
+    return RANDOM_CHECKPOINT_EGENERATOR;
+  if (header.count > capacity)
+    return RANDOM_CHECKPOINT_ECOUNT;
+
+  info = random_generator_info(id);
+  size = record_size(info);
+  buffer = malloc(CHUNK_RECORDS * size);
+  if (buffer == NULL)
+    return RANDOM_CHECKPOINT_EIO;
+
+  checksum = checksum_update(CHECKSUM_BASIS, raw, CHECKSUM_HEADER_SIZE);
+
+  for (i = 0; i < header.count; i += n)
+  {
+    n = (header.count - i < CHUNK_RECORDS) ? header.count - i : CHUNK_RECORDS;
+    if (fread(buffer, size, n, stream) != n)
+    {
+      status = ferror(stream) ? RANDOM_CHECKPOINT_EIO
+                              : RANDOM_CHECKPOINT_EFORMAT;
+      free(buffer);
+      return status;
+    }
+    checksum = checksum_update(checksum, buffer, n * size);
+    decode_records(id, buffer, s + i * info->state_size, n);
+  }
+
+  free(buffer);
+
+  if (checksum != header.checksum)
+    return RANDOM_CHECKPOINT_ECHECKSUM;
+  if (!states_valid(id, s, header.count))
+    return RANDOM_CHECKPOINT_ESTATE;
+
+  *count = header.count;
+  return RANDOM_CHECKPOINT_OK;
+}
+
+int random_checkpoint_save (const char *path, random_generator_id_t id,
+                            const void *states, size_t count)
+{
+  FILE *stream = fopen(path, "wb");
+  int status;
+
+  if (stream == NULL)
+    return RANDOM_CHECKPOINT_EIO;
+
+  status = random_checkpoint_write(stream, id, states, count);
+  if (fclose(stream) != 0 && status == RANDOM_CHECKPOINT_OK)
+    status = RANDOM_CHECKPOINT_EIO;
+
+  return status;
+}
+
+int random_checkpoint_load (const char *path, random_generator_id_t id,
+                            void *states, size_t capacity, size_t *count)
+{
+  FILE *stream = fopen(path, "rb");
+  int status;
+
+  if (stream == NULL)
+    return RANDOM_CHECKPOINT_EIO;
+
+  status = random_checkpoint_read(stream, id, states, capacity, count);
+  fclose(stream);
+
+  return status;
+}
+
+/* Map the checkpoint at path read-write and private, without reading it.
+ * Returns MAP_UNSUITABLE if its records are not usable as states here. */
+static int map_file (const char *path, random_checkpoint_map_t *map,
+                     int verify)
+{
+#ifdef HAVE_MMAP
+  const random_generator_info_t *info;
+  const unsigned char *base;
+  struct stat st;
+  uint64_t checksum;
+  int fd, status;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return RANDOM_CHECKPOINT_EIO;
+
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return RANDOM_CHECKPOINT_EIO;
+  }
+
+  if ((uint64_t) st.st_size < RANDOM_CHECKPOINT_HEADER_SIZE
+      || (uint64_t) st.st_size > SIZE_MAX)
+  {
+    close(fd);
+    return RANDOM_CHECKPOINT_EFORMAT;
+  }
+
+  map->length = (size_t) st.st_size;
+  map->base = mmap(NULL, map->length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   fd, 0);
+  close(fd);
+
+  if (map->base == MAP_FAILED)
+  {
+    map->base = NULL;
+    return RANDOM_CHECKPOINT_EIO;
+  }
+  map->mapped = 1;
+
+  base = map->base;
+  status = decode_header(base, &map->header);
+  if (status != RANDOM_CHECKPOINT_OK)
+    return status;
+
+  info = random_generator_info(map->header.generator);
+  if (map->length - RANDOM_CHECKPOINT_HEADER_SIZE
+      != map->header.count * record_size(info))
+    return RANDOM_CHECKPOINT_EFORMAT;
+
+  /* The records have the layout of the state type unless it is padded, or
+   * its words are reordered. */
+  if (record_size(info) != info->state_size
+      || swap_pairs(map->header.generator))
+    return MAP_UNSUITABLE;
+
+  if (verify)
+  {
+    checksum = checksum_update(CHECKSUM_BASIS, base, CHECKSUM_HEADER_SIZE);
+    checksum = checksum_update(checksum, base + RANDOM_CHECKPOINT_HEADER_SIZE,
+                               map->length - RANDOM_CHECKPOINT_HEADER_SIZE);
+    if (checksum != map->header.checksum)
+      return RANDOM_CHECKPOINT_ECHECKSUM;
+  }
+
+  /* Even unverified, the states must be safe to step. */
+  if (!states_valid(map->header.generator,
+                    base + RANDOM_CHECKPOINT_HEADER_SIZE, map->header.count))
+    return RANDOM_CHECKPOINT_ESTATE;
+
+  map->states = (unsigned char *) map->base + RANDOM_CHECKPOINT_HEADER_SIZE;
+  return RANDOM_CHECKPOINT_OK;
+#else
+  (void) path; (void) map; (void) verify;
+  return RANDOM_CHECKPOINT_EIO;
+#endif /* ifdef HAVE_MMAP */
+}
+
+/* Read the checkpoint at path into allocated memory. */
+static int read_file (const char *path, random_checkpoint_map_t *map)
+{
+  const random_generator_info_t *info;
+  FILE *stream = fopen(path, "rb");
+  size_t count;
+  int status;
+
+  if (stream == NULL)
+    return RANDOM_CHECKPOINT_EIO;
+
+  status = random_checkpoint_read_header(stream, &map->header);
+  if (status == RANDOM_CHECKPOINT_OK)
+  {
+    info = random_generator_info(map->header.generator);
+    map->length = (size_t) map->header.count * info->state_size;
+    map->base = malloc(map->length ? map->length : 1);
+    if (map->base == NULL)
+      status = RANDOM_CHECKPOINT_EIO;
+  }
+
+  if (status == RANDOM_CHECKPOINT_OK)
+  {
+    rewind(stream);
+    status = random_checkpoint_read(stream, map->header.generator, map->base,
+                                    (size_t) map->header.count, &count);
+  }
+
+  fclose(stream);
+
+  map->states = map->base;
+  return status;
+}
+
+int random_checkpoint_map (const char *path, random_checkpoint_map_t *map,
+                           int verify)
+{
+  int status;
+
+  memset(map, 0, sizeof(*map));
+
+#ifdef HAVE_MMAP
+  if (host_little_endian())
+  {
+    status = map_file(path, map, verify);
+    if (status == MAP_UNSUITABLE)
+    {
+      random_checkpoint_unmap(map);
+      status = read_file(path, map);
+    }
+  }
+  else
+#endif
+    status = read_file(path, map);
+
+  if (status != RANDOM_CHECKPOINT_OK)
+    random_checkpoint_unmap(map);
+
+  return status;
+}
+
+void random_checkpoint_unmap (random_checkpoint_map_t *map)
+{
+#ifdef HAVE_MMAP
+  if (map->mapped && map->base != NULL)
+    munmap(map->base, map->length);
+  else
+#endif
+    free(map->base);
+
+  memset(map, 0, sizeof(*map));
+}
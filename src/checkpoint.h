@@ -0,0 +1,130 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Binary checkpoints of arrays of generator states.
+ *
+ * A checkpoint holds `count` states of a single generator, for example one
+ * stream per particle of a simulation, so that a job can be restarted from
+ * exactly the point at which it was saved. The format is versioned and
+ * independent of the endianness of the machine that wrote it:
+ *
+ *   offset  size  contents (all integers little-endian)
+ *        0     8  magic "LIBRNDCK"
+ *        8     4  format version, currently 1
+ *       12     4  generator identifier, see generator.h
+ *       16     4  word size of the generator in bits, 32 or 64
+ *       20     4  record size in bytes, see below
+ *       24     8  number of states
+ *       32     8  checksum
+ *       40    24  reserved, zero
+ *       64        packed array of records, one per state
+ *
+ * Each record is the state_words words of the state (see generator.h) in
+ * order, each of word_bits bits, followed by the int32_t index of the state
+ * types that have one, with no padding: its size is independent of the ABI.
+ * The pcg128_t values of pcg.h are stored as their low word followed by
+ * their high word, whether or not unsigned __int128 is used. The records
+ * start at offset 64, so on a little-endian machine, and for state types
+ * without trailing padding, a checkpoint mapped into memory is directly
+ * usable as an array of states; see random_checkpoint_map().
+ *
+ * The checksum is computed over bytes 0 to 31 of the header followed by the
+ * records, taken as little-endian 64-bit words w (the final word padded with
+ * zeros): starting from h = 0xcbf29ce484222325, for each word
+ * h = (h ^ w) * 0x100000001b3 followed by h ^= h >> 32, modulo 2^64.
+ *
+ * The checksum only detects accidental corruption. Whether or not it is
+ * verified, every state read or mapped is checked to be safe to step: the
+ * index of a Mersenne Twister state must lie in [0, N + 1] for its N words,
+ * and the parameters of a dcmt state must satisfy dcmt_params_valid(). The
+ * states of mt19937ar() and mt19937_64() themselves may be checkpointed with
+ * mt19937ar_get_state() and mt19937ar_set_state() and their 64-bit
+ * counterparts.
+ *
+ * All routines return RANDOM_CHECKPOINT_OK (zero) on success or one of the
+ * negative error codes below.
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RANDOM_CHECKPOINT_VERSION 1
+#define RANDOM_CHECKPOINT_HEADER_SIZE 64
+
+/* Error codes. */
+#define RANDOM_CHECKPOINT_OK           0
+#define RANDOM_CHECKPOINT_EIO        (-1) /* I/O or mapping failed; errno. */
+#define RANDOM_CHECKPOINT_EFORMAT    (-2) /* Not a checkpoint, or truncated. */
+#define RANDOM_CHECKPOINT_EVERSION   (-3) /* Unsupported format version. */
+#define RANDOM_CHECKPOINT_EGENERATOR (-4) /* Unknown or unexpected generator. */
+#define RANDOM_CHECKPOINT_ECOUNT     (-5) /* More states than requested. */
+#define RANDOM_CHECKPOINT_ECHECKSUM  (-6) /* Checksum mismatch. */
+#define RANDOM_CHECKPOINT_ESTATE     (-7) /* Invalid index or parameters. */
+
+/* Decoded checkpoint header. */
+typedef struct {
+  uint32_t version;
+  random_generator_id_t generator;
+  uint64_t count;
+  uint64_t checksum;
+} random_checkpoint_header_t;
+
+/* Write states[0..count-1] of generator id to stream as a checkpoint. */
+int random_checkpoint_write (FILE *stream, random_generator_id_t id,
+                             const void *states, size_t count);
+
+/* Read a checkpoint of generator id from stream into states[], which has
+ * room for capacity states, verifying its checksum. The number of states
+ * read is stored in *count. */
+int random_checkpoint_read (FILE *stream, random_generator_id_t id,
+                            void *states, size_t capacity, size_t *count);
+
+/* Read and validate only the header of a checkpoint from stream. */
+int random_checkpoint_read_header (FILE *stream,
+                                   random_checkpoint_header_t *header);
+
+/* Convenience wrappers of the above, taking the path of a file. */
+int random_checkpoint_save (const char *path, random_generator_id_t id,
+                            const void *states, size_t count);
+int random_checkpoint_load (const char *path, random_generator_id_t id,
+                            void *states, size_t capacity, size_t *count);
+
+/* A checkpoint mapped into memory. */
+typedef struct {
+  random_checkpoint_header_t header;
+  void *states;  /* header.count states, writable. */
+  void *base;    /* Start of the mapping or allocation. */
+  size_t length; /* Length of the mapping. */
+  int mapped;    /* Non-zero if base was mapped rather than allocated. */
+} random_checkpoint_map_t;
+
+/* Map the checkpoint at path into memory, without copying or parsing its
+ * records where possible, and point map->states at its array of states.
+ *
+ * On little-endian POSIX systems the file is mapped privately: states may be
+ * stepped in place, with pages copied only as they are modified, and the file
+ * itself is never changed. Elsewhere, or if the records differ from the state
+ * type in size, the checkpoint is read into allocated memory. When mapped,
+ * the checksum is only verified if verify is non-zero, which reads the whole
+ * file. Release with random_checkpoint_unmap(). */
+int random_checkpoint_map (const char *path, random_checkpoint_map_t *map,
+                           int verify);
+void random_checkpoint_unmap (random_checkpoint_map_t *map);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CHECKPOINT_H_ */
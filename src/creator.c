@@ -0,0 +1,868 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Dynamic Creator: search for Mersenne Twister parameters. */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "creator.h"
+#include "generator.h"
+#include "parallel.h"
+
+static const unsigned exponents[] = {
+  521, 607, 1279, 2203, 2281, 3217, 4253, 4423
+};
+
+/* Polynomials with an irreducible factor of degree at most SIEVE are
+ * rejected before the full irreducibility test. */
+#define SIEVE 16
+
+/* Seed of the state from which the characteristic polynomial is found. */
+#define CHARPOLY_SEED UINT32_C(4357)
+
+int dcmt_supported (unsigned mexp)
+{
+  size_t i;
+
+  for (i = 0; i < sizeof(exponents) / sizeof(exponents[0]); i++)
+  {
+    if (exponents[i] == mexp)
+      return 1;
+  }
+
+  return 0;
+}
+
+/* Polynomials over GF(2) and bit vectors are arrays of words, in which bit i
+ * of word j is the coefficient of x^(64 j + i). */
+
+#define BIT(a, i) (((a)[(i) / 64] >> ((i) % 64)) & 1)
+
+/* Return the degree of a[0..n-1], or -1 if a is zero. */
+static long degree (const uint64_t *a, size_t n)
+{
+  size_t i;
+
+  for (i = n; i-- > 0;)
+  {
+    if (a[i])
+    {
+      uint64_t w = a[i];
+      long d = 64 * (long) i;
+
+#if defined(__GNUC__)
+      return d + 63 - __builtin_clzll(w);
+#else
+      while (w >>= 1)
+        d++;
+      return d;
+#endif
+    }
+  }
+
+  return -1;
+}
+
+/* r ^= a * x^shift, where a has n words and r has n + shift / 64 + 1. */
+static void xor_shifted (uint64_t *r, const uint64_t *a, size_t n,
+                         size_t shift)
+{
+  const size_t w = shift / 64, s = shift % 64;
+  size_t i;
+
+  if (s == 0)
+  {
+    for (i = 0; i < n; i++)
+      r[w + i] ^= a[i];
+    return;
+  }
+
+  r[w] ^= a[0] << s;
+  for (i = 1; i < n; i++)
+    r[w + i] ^= (a[i] << s) | (a[i - 1] >> (64 - s));
+  r[w + n] ^= a[n - 1] >> (64 - s);
+}
+
+/* Spread the 32 bits of x to the even bits of the result, which squares x as
+ * a polynomial. */
+static uint64_t spread (uint64_t x)
+{
+  x &= UINT64_C(0xffffffff);
+  x = (x | (x << 16)) & UINT64_C(0x0000ffff0000ffff);
+  x = (x | (x << 8)) & UINT64_C(0x00ff00ff00ff00ff);
+  x = (x | (x << 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+  x = (x | (x << 2)) & UINT64_C(0x3333333333333333);
+  x = (x | (x << 1)) & UINT64_C(0x5555555555555555);
+
+  return x;
+}
+
+/* Workspace of a search. Polynomials of degree at most mexp, and vectors of
+ * mexp bits, have n words. */
+typedef struct {
+  unsigned mexp;
+  size_t n;
+  dcmt_state_t state;
+  uint32_t scratch[DCMT_MAX_N];
+
+  /* Arithmetic modulo the characteristic polynomial phi. */
+  uint64_t *phi;
+  uint64_t *shifted; /* phi * x^s for s = 0, ..., 63, n + 1 words each. */
+  uint64_t *product; /* 2 n + 2 words. */
+  uint64_t *t, *u, *acc, *g0, *g1; /* n + 1 words each. */
+
+  /* Berlekamp-Massey: sequence reversed, and three polynomials. */
+  size_t m;
+  uint64_t *seq, *c, *b, *tc; /* m words each. */
+
+  /* Equidistribution: outputs[j * mexp + i] is output j of the generator
+   * from the state with only bit i set, before tempering. */
+  uint32_t *outputs;
+  uint32_t *tempered;
+  uint64_t *rows;   /* Basis vectors, n words each. */
+  long *pivot;      /* pivot[h] is the basis vector of degree h, or -1. */
+  uint64_t *column;
+} search_t;
+
+static void search_free (search_t *s)
+{
+  if (s)
+  {
+    free(s->phi);
+    free(s->outputs);
+    free(s->tempered);
+    free(s->rows);
+    free(s->pivot);
+    free(s);
+  }
+}
+
+static search_t *search_alloc (unsigned mexp)
+{
+  search_t *s = calloc(1, sizeof(search_t));
+  size_t n, m, words;
+
+  if (s == NULL)
+    return NULL;
+
+  s->mexp = mexp;
+  s->n = n = mexp / 64 + 1;
+  s->m = m = 2 * mexp / 64 + 2;
+
+  words = n + 64 * (n + 1) + (2 * n + 2) + 5 * (n + 1) + 4 * m + n;
+  s->phi = calloc(words, sizeof(uint64_t));
+  s->outputs = malloc((size_t) mexp * mexp * sizeof(uint32_t));
+  s->tempered = malloc(mexp * sizeof(uint32_t));
+  s->rows = malloc((size_t) mexp * n * sizeof(uint64_t));
+  s->pivot = malloc(mexp * sizeof(long));
+
+  if (s->phi == NULL || s->outputs == NULL || s->tempered == NULL
+      || s->rows == NULL || s->pivot == NULL)
+  {
+    search_free(s);
+    return NULL;
+  }
+
+  s->shifted = s->phi + n;
+  s->product = s->shifted + 64 * (n + 1);
+  s->t = s->product + 2 * n + 2;
+  s->u = s->t + n + 1;
+  s->acc = s->u + n + 1;
+  s->g0 = s->acc + n + 1;
+  s->g1 = s->g0 + n + 1;
+  s->seq = s->g1 + n + 1;
+  s->c = s->seq + m;
+  s->b = s->c + m;
+  s->tc = s->b + m;
+  s->column = s->tc + m;
+
+  return s;
+}
+
+/* Reduce s->product modulo phi into r. */
+static void reduce (search_t *s, uint64_t *r)
+{
+  const long mexp = (long) s->mexp;
+  const size_t n = s->n;
+  long i;
+  size_t k;
+
+  for (i = 2 * mexp; i >= mexp; i--)
+  {
+    if (BIT(s->product, (size_t) i))
+    {
+      const size_t o = (size_t) (i - mexp);
+      const uint64_t *p = s->shifted + (o % 64) * (n + 1);
+      uint64_t *q = s->product + o / 64;
+
+      for (k = 0; k < n + 1; k++)
+        q[k] ^= p[k];
+    }
+  }
+
+  memcpy(r, s->product, n * sizeof(uint64_t));
+}
+
+/* r = a^2 mod phi; r may be a. */
+static void square (search_t *s, const uint64_t *a, uint64_t *r)
+{
+  size_t i;
+
+  memset(s->product, 0, (2 * s->n + 2) * sizeof(uint64_t));
+  for (i = 0; i < s->n; i++)
+  {
+    s->product[2 * i] = spread(a[i]);
+    s->product[2 * i + 1] = spread(a[i] >> 32);
+  }
+
+  reduce(s, r);
+}
+
+/* r = a b mod phi; r may be a or b. */
+static void multiply (search_t *s, const uint64_t *a, const uint64_t *b,
+                      uint64_t *r)
+{
+  size_t i;
+
+  memset(s->product, 0, (2 * s->n + 2) * sizeof(uint64_t));
+  for (i = 0; i < s->mexp; i++)
+  {
+    if (BIT(b, i))
+      xor_shifted(s->product, a, s->n, i);
+  }
+
+  reduce(s, r);
+}
+
+/* Return non-zero if gcd(phi, a) = 1. */
+static int coprime (search_t *s, const uint64_t *a)
+{
+  const size_t n = s->n;
+  uint64_t *f = s->g0, *g = s->g1, *t;
+  long df, dg;
+
+  memcpy(f, s->phi, n * sizeof(uint64_t));
+  memcpy(g, a, n * sizeof(uint64_t));
+  f[n] = g[n] = 0;
+  df = degree(f, n);
+  dg = degree(g, n);
+
+  while (dg >= 0)
+  {
+    while (df >= dg)
+    {
+      xor_shifted(f, g, (size_t) dg / 64 + 1, (size_t) (df - dg));
+      df = degree(f, n);
+    }
+
+    t = f; f = g; g = t;
+    df = dg;
+    dg = degree(g, n);
+  }
+
+  return df == 0;
+}
+
+/* Return non-zero if phi, of prime degree mexp, is irreducible: that is, if
+ * x^(2^mexp) = x mod phi. */
+static int irreducible (search_t *s)
+{
+  const size_t n = s->n;
+  unsigned d;
+  size_t i;
+
+  for (i = 0; i < 64; i++)
+  {
+    uint64_t *p = s->shifted + i * (n + 1);
+
+    memset(p, 0, (n + 1) * sizeof(uint64_t));
+    xor_shifted(p, s->phi, n, i);
+  }
+
+  /* Sieve: the product of x^(2^d) - x for d = 1, ..., SIEVE is divisible by
+   * every irreducible polynomial of degree at most SIEVE. */
+  memset(s->t, 0, n * sizeof(uint64_t));
+  memset(s->acc, 0, n * sizeof(uint64_t));
+  s->t[0] = 2;
+  s->acc[0] = 1;
+  for (d = 1; d <= SIEVE; d++)
+  {
+    square(s, s->t, s->t);
+    memcpy(s->u, s->t, n * sizeof(uint64_t));
+    s->u[0] ^= 2;
+    multiply(s, s->acc, s->u, s->acc);
+  }
+
+  if (!coprime(s, s->acc))
+    return 0;
+
+  for (; d <= s->mexp; d++)
+    square(s, s->t, s->t);
+
+  s->t[0] ^= 2;
+  return degree(s->t, n) < 0;
+}
+
+/* Set phi to the minimal polynomial of the sequence of the low bits of the
+ * words of the recurrence of params, by the Berlekamp-Massey algorithm, and
+ * return its degree. */
+static long charpoly (search_t *s, const dcmt_params_t *params)
+{
+  const size_t nbits = 2 * s->mexp, m = s->m;
+  const size_t nn = params->nn;
+  long l = 0, i;
+  size_t k, j, shift = 1;
+
+  /* seq holds the sequence reversed: bit nbits - 1 - k is term k. */
+  memset(s->seq, 0, m * sizeof(uint64_t));
+  init_dcmt(&s->state, params, CHARPOLY_SEED);
+  for (k = 0; k < nbits; k += nn)
+  {
+    dcmt_fill(&s->state, s->scratch, nn); /* Regenerate s->state.mt. */
+    for (j = 0; j < nn && k + j < nbits; j++)
+    {
+      const size_t p = nbits - 1 - (k + j);
+
+      s->seq[p / 64] |= (uint64_t) (s->state.mt[j] & 1) << (p % 64);
+    }
+  }
+
+  memset(s->c, 0, m * sizeof(uint64_t));
+  memset(s->b, 0, m * sizeof(uint64_t));
+  s->c[0] = s->b[0] = 1;
+
+  for (k = 0; k < nbits; k++)
+  {
+    /* Discrepancy: the sum of c_i s_{k-i}, where s_{k-i} is bit
+     * nbits - 1 - k + i of seq. */
+    const size_t o = nbits - 1 - k, ow = o / 64, os = o % 64;
+    uint64_t d = 0;
+
+    for (j = 0; j <= (size_t) l / 64; j++)
+    {
+      uint64_t w = s->seq[ow + j] >> os;
+
+      if (os != 0 && ow + j + 1 < m)
+        w |= s->seq[ow + j + 1] << (64 - os);
+      d ^= s->c[j] & w;
+    }
+
+    d ^= d >> 32; d ^= d >> 16; d ^= d >> 8;
+    d ^= d >> 4; d ^= d >> 2; d ^= d >> 1;
+
+    if ((d & 1) == 0)
+    {
+      shift++;
+      continue;
+    }
+
+    memcpy(s->tc, s->c, m * sizeof(uint64_t));
+    xor_shifted(s->c, s->b, m - shift / 64 - 1, shift);
+
+    if (2 * (size_t) l <= k)
+    {
+      l = (long) (k + 1) - l;
+      memcpy(s->b, s->tc, m * sizeof(uint64_t));
+      shift = 1;
+    }
+    else
+    {
+      shift++;
+    }
+  }
+
+  /* The minimal polynomial is the reciprocal of c, of degree l. */
+  if (l > (long) s->mexp)
+    return l;
+
+  memset(s->phi, 0, s->n * sizeof(uint64_t));
+  for (i = 0; i <= l; i++)
+  {
+    if (BIT(s->c, (size_t) (l - i)))
+      s->phi[i / 64] |= UINT64_C(1) << (i % 64);
+  }
+
+  return l;
+}
+
+/* Return non-zero if params has a primitive characteristic polynomial of
+ * degree mexp, that is a period of 2^mexp - 1. */
+static int primitive (search_t *s, const dcmt_params_t *params)
+{
+  return charpoly(s, params) == (long) s->mexp && irreducible(s);
+}
+
+/* Compute s->outputs for the recurrence of params. */
+static void outputs (search_t *s, const dcmt_params_t *params)
+{
+  const size_t mexp = s->mexp, nn = params->nn;
+  const unsigned upper = 32 - params->rr;
+  size_t i, j, l;
+
+  s->state.params = *params;
+
+  for (i = 0; i < mexp; i++)
+  {
+    memset(s->state.mt, 0, sizeof(s->state.mt));
+    if (i < upper)
+      s->state.mt[0] = UINT32_C(1) << (params->rr + i);
+    else
+      s->state.mt[1 + (i - upper) / 32] = UINT32_C(1) << ((i - upper) % 32);
+    s->state.mti = (int32_t) nn;
+
+    for (j = 0; j < mexp; j += nn)
+    {
+      dcmt_fill(&s->state, s->scratch, nn);
+      for (l = 0; l < nn && j + l < mexp; l++)
+        s->outputs[(j + l) * mexp + i] = s->state.mt[l];
+    }
+  }
+}
+
+static uint32_t temper (const dcmt_params_t *params, uint32_t y)
+{
+  y ^= (y >> params->shift0);
+  y ^= (y << params->shiftB) & params->maskB;
+  y ^= (y << params->shiftC) & params->maskC;
+  y ^= (y >> params->shift1);
+
+  return y;
+}
+
+/* Add v to the basis, returning non-zero if it was independent. v is
+ * overwritten. */
+static int insert (search_t *s, uint64_t *v, size_t *rank)
+{
+  const size_t n = s->n;
+
+  for (;;)
+  {
+    long h = degree(v, n);
+    const uint64_t *row;
+    size_t i;
+
+    if (h < 0)
+      return 0;
+
+    if (s->pivot[h] < 0)
+    {
+      memcpy(s->rows + *rank * n, v, n * sizeof(uint64_t));
+      s->pivot[h] = (long) (*rank)++;
+      return 1;
+    }
+
+    row = s->rows + (size_t) s->pivot[h] * n;
+    for (i = 0; i <= (size_t) h / 64; i++)
+      v[i] ^= row[i];
+  }
+}
+
+/* Return k(v) for the tempering of params, given s->outputs. */
+static unsigned equidistribution (search_t *s, const dcmt_params_t *params,
+                                  unsigned v)
+{
+  const size_t mexp = s->mexp;
+  const unsigned bound = s->mexp / v;
+  size_t i, rank = 0;
+  unsigned j, b;
+
+  for (i = 0; i < mexp; i++)
+    s->pivot[i] = -1;
+
+  for (j = 0; j < bound; j++)
+  {
+    const uint32_t *u = s->outputs + j * mexp;
+
+    for (i = 0; i < mexp; i++)
+      s->tempered[i] = temper(params, u[i]);
+
+    for (b = 0; b < v; b++)
+    {
+      memset(s->column, 0, s->n * sizeof(uint64_t));
+      for (i = 0; i < mexp; i++)
+        s->column[i / 64] |= (uint64_t) ((s->tempered[i] >> (31 - b)) & 1)
+                             << (i % 64);
+
+      if (!insert(s, s->column, &rank))
+        return j;
+    }
+  }
+
+  return bound;
+}
+
+/* Choose the tempering masks of params, given s->outputs. Starting from
+ * masks of all (effective) ones, the bits at position 32 - v of B and C are
+ * set to whichever of the four combinations gives the largest k(v), for v
+ * from 1 to 32. Changing a bit at a position may affect k(v) at higher
+ * positions through C, which the greedy search does not revisit. */
+static void tempering (search_t *s, dcmt_params_t *params)
+{
+  unsigned v, c;
+
+  params->maskB = UINT32_C(0xffffffff) << params->shiftB;
+  params->maskC = UINT32_C(0xffffffff) << params->shiftC;
+
+  for (v = 1; v <= 32; v++)
+  {
+    const uint32_t bit = UINT32_C(1) << (32 - v);
+    const unsigned bound = s->mexp / v;
+    dcmt_params_t best = *params, trial = *params;
+    unsigned k = equidistribution(s, params, v);
+
+    for (c = 0; c < 4 && k < bound; c++)
+    {
+      trial.maskB = (params->maskB & ~bit) | ((c & 1) ? bit : 0);
+      trial.maskC = (params->maskC & ~bit) | ((c & 2) ? bit : 0);
+      trial.maskB &= UINT32_C(0xffffffff) << params->shiftB;
+      trial.maskC &= UINT32_C(0xffffffff) << params->shiftC;
+
+      if (trial.maskB == params->maskB && trial.maskC == params->maskC)
+        continue;
+
+      unsigned kt = equidistribution(s, &trial, v);
+      if (kt > k)
+      {
+        k = kt;
+        best = trial;
+      }
+    }
+
+    *params = best;
+  }
+}
+
+/* Number of candidates for a of each stream: the top bit is set and the low
+ * 16 bits hold the id, so 15 bits remain. */
+#define CANDIDATES (UINT32_C(1) << 15)
+
+/* Search for the parameters of stream id. Returns zero on success or -1 if
+ * no candidate for a gives a primitive characteristic polynomial. */
+static int search (search_t *s, uint64_t seed, unsigned id,
+                   dcmt_params_t *params)
+{
+  const unsigned mexp = s->mexp;
+  uint32_t mul, add, k;
+  random_t rng;
+
+  /* The candidates for a depend only on (mexp, seed, id). */
+  random_init(&rng, RANDOM_KISS64, seed, ((uint64_t) mexp << 16) | id);
+
+  params->mexp = mexp;
+  params->nn = (mexp + 31) / 32;
+  params->mm = params->nn / 2;
+  params->rr = 32 * params->nn - mexp;
+  params->shift0 = 12;
+  params->shiftB = 7;
+  params->shiftC = 15;
+  params->shift1 = 18;
+  params->maskB = params->maskC = 0;
+
+  /* The candidates are tried once each, in the order of the permutation
+   * k -> (mul k + add) mod 2^15, for odd mul. The top bit of a makes the
+   * twist, and so the recurrence, invertible. */
+  mul = (uint32_t) (kiss64(&rng.state.kiss64) >> 32) | 1;
+  add = (uint32_t) (kiss64(&rng.state.kiss64) >> 32);
+
+  for (k = 0; k < CANDIDATES; k++)
+  {
+    const uint32_t r = (mul * k + add) & (CANDIDATES - 1);
+
+    params->aaa = UINT32_C(0x80000000) | (r << 16) | id;
+    if (primitive(s, params))
+      break;
+  }
+
+  if (k == CANDIDATES)
+    return -1;
+
+  outputs(s, params);
+  tempering(s, params);
+
+  return 0;
+}
+
+#undef CANDIDATES
+
+/* Return non-zero if the fields of params are consistent. */
+static int consistent (const dcmt_params_t *params)
+{
+  return dcmt_supported(params->mexp) && dcmt_params_valid(params)
+         && (params->aaa >> 31) == 1;
+}
+
+/* A set of searches run by random_parallel_for(). */
+typedef struct {
+  unsigned mexp;
+  uint64_t seed;
+  unsigned first_id;
+  dcmt_params_t *params;
+  const size_t *index; /* Task c searches for params[index[c]]. */
+  int *status;
+} job_t;
+
+static void task (void *arg, size_t c)
+{
+  job_t *job = arg;
+  const size_t i = job->index ? job->index[c] : c;
+  search_t *s = search_alloc(job->mexp);
+
+  if (s == NULL)
+  {
+    job->status[c] = ENOMEM;
+    return;
+  }
+
+  if (search(s, job->seed, job->first_id + (unsigned) i, &job->params[i]))
+    job->status[c] = EDOM;
+  else
+    job->status[c] = 0;
+  search_free(s);
+}
+
+static int run (job_t *job, size_t count, unsigned nthreads)
+{
+  size_t c;
+  int error = 0;
+
+  job->status = malloc(count * sizeof(int));
+  if (job->status == NULL)
+  {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  random_parallel_for(count, nthreads, task, job);
+
+  /* A failure to allocate is reported in preference to a stream without
+   * parameters. */
+  for (c = 0; c < count; c++)
+  {
+    if (job->status[c] == ENOMEM)
+      error = ENOMEM;
+    else if (error == 0)
+      error = job->status[c];
+  }
+
+  free(job->status);
+
+  if (error)
+  {
+    errno = error;
+    return -1;
+  }
+
+  return 0;
+}
+
+int dcmt_create (unsigned mexp, uint64_t seed, unsigned id,
+                 dcmt_params_t *params)
+{
+  return dcmt_create_parallel(mexp, seed, id, 1, params, 1);
+}
+
+int dcmt_create_parallel (unsigned mexp, uint64_t seed, unsigned first_id,
+                          size_t count, dcmt_params_t params[],
+                          unsigned nthreads)
+{
+  job_t job;
+
+  if (!dcmt_supported(mexp) || first_id > DCMT_MAX_ID
+      || count > DCMT_MAX_ID - first_id + 1)
+    return -1;
+
+  job.mexp = mexp;
+  job.seed = seed;
+  job.first_id = first_id;
+  job.params = params;
+  job.index = NULL;
+
+  return run(&job, count, nthreads);
+}
+
+/* Format of a line of the parameter database. */
+#define DB_HEADER "# librandom dcmt parameters: mexp seed id nn mm rr aaa " \
+                  "shift0 shiftB shiftC shift1 maskB maskC\n"
+
+/* Look up the streams in the database stream, setting found[i] for each
+ * stream first_id + i found. */
+static void db_read (FILE *stream, unsigned mexp, uint64_t seed,
+                     unsigned first_id, size_t count, dcmt_params_t params[],
+                     char found[])
+{
+  char line[256];
+
+  while (fgets(line, sizeof(line), stream))
+  {
+    dcmt_params_t p;
+    uint64_t s;
+    unsigned id;
+
+    if (line[0] == '#')
+      continue;
+
+    /* Malformed lines, e.g. from a writer which failed, are skipped. */
+    if (sscanf(line, "%" SCNu32 " %" SCNu64 " %u %" SCNu32 " %" SCNu32
+               " %" SCNu32 " %" SCNx32 " %" SCNu32 " %" SCNu32 " %" SCNu32
+               " %" SCNu32 " %" SCNx32 " %" SCNx32,
+               &p.mexp, &s, &id, &p.nn, &p.mm, &p.rr, &p.aaa, &p.shift0,
+               &p.shiftB, &p.shiftC, &p.shift1, &p.maskB, &p.maskC) != 13)
+      continue;
+
+    if (p.mexp == mexp && s == seed && id >= first_id
+        && id - first_id < count && (p.aaa & DCMT_MAX_ID) == id
+        && consistent(&p))
+    {
+      params[id - first_id] = p;
+      found[id - first_id] = 1;
+    }
+  }
+}
+
+static int db_write (FILE *stream, uint64_t seed, unsigned first_id,
+                     const dcmt_params_t params[], const size_t index[],
+                     size_t count)
+{
+  size_t c;
+  int error = 0;
+
+  /* One write per line, so that lines of concurrent writers appending to
+   * the database are not interleaved. */
+  setvbuf(stream, NULL, _IOLBF, 0);
+
+  if (fseek(stream, 0, SEEK_END) != 0)
+    return -1;
+  if (ftell(stream) == 0)
+    error |= fputs(DB_HEADER, stream) < 0;
+
+  for (c = 0; c < count && !error; c++)
+  {
+    const dcmt_params_t *p = &params[index[c]];
+
+    error |= fprintf(stream, "%" PRIu32 " %" PRIu64 " %u %" PRIu32 " %" PRIu32
+                     " %" PRIu32 " 0x%08" PRIx32 " %" PRIu32 " %" PRIu32
+                     " %" PRIu32 " %" PRIu32 " 0x%08" PRIx32 " 0x%08" PRIx32
+                     "\n", p->mexp, seed, first_id + (unsigned) index[c],
+                     p->nn, p->mm, p->rr, p->aaa, p->shift0, p->shiftB,
+                     p->shiftC, p->shift1, p->maskB, p->maskC) < 0;
+  }
+
+  return error ? -1 : 0;
+}
+
+int dcmt_create_cached (const char *path, unsigned mexp, uint64_t seed,
+                        unsigned first_id, size_t count,
+                        dcmt_params_t params[], unsigned nthreads)
+{
+  FILE *stream;
+  char *found;
+  size_t *index, missing = 0, i;
+  job_t job;
+  int status = 0;
+
+  if (!dcmt_supported(mexp) || first_id > DCMT_MAX_ID
+      || count > DCMT_MAX_ID - first_id + 1)
+    return -1;
+
+  found = calloc(count + 1, 1);
+  index = malloc((count + 1) * sizeof(size_t));
+  if (found == NULL || index == NULL)
+  {
+    free(found);
+    free(index);
+    return -1;
+  }
+
+  stream = fopen(path, "r");
+  if (stream)
+  {
+    db_read(stream, mexp, seed, first_id, count, params, found);
+    status = ferror(stream) ? -1 : 0;
+    fclose(stream);
+  }
+  else if (errno != ENOENT)
+  {
+    status = -1;
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    if (!found[i])
+      index[missing++] = i;
+  }
+
+  if (status == 0 && missing > 0)
+  {
+    job.mexp = mexp;
+    job.seed = seed;
+    job.first_id = first_id;
+    job.params = params;
+    job.index = index;
+    status = run(&job, missing, nthreads);
+
+    if (status == 0)
+    {
+      stream = fopen(path, "a");
+      if (stream == NULL)
+        status = -1;
+      else
+      {
+        status = db_write(stream, seed, first_id, params, index, missing);
+        if (fclose(stream) != 0)
+          status = -1;
+      }
+    }
+  }
+
+  free(found);
+  free(index);
+
+  return status;
+}
+
+int dcmt_check_params (const dcmt_params_t *params)
+{
+  search_t *s;
+  int result;
+
+  if (!consistent(params))
+    return 0;
+
+  s = search_alloc(params->mexp);
+  if (s == NULL)
+    return 0;
+
+  result = primitive(s, params);
+  search_free(s);
+
+  return result;
+}
+
+int dcmt_equidistribution (const dcmt_params_t *params, unsigned k[32])
+{
+  search_t *s;
+  unsigned v;
+
+  if (!consistent(params))
+    return -1;
+
+  s = search_alloc(params->mexp);
+  if (s == NULL)
+    return -1;
+
+  outputs(s, params);
+  for (v = 1; v <= 32; v++)
+    k[v - 1] = equidistribution(s, params, v);
+
+  search_free(s);
+
+  return 0;
+}
+
+#undef BIT
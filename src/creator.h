@@ -0,0 +1,110 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Dynamic Creator: search for Mersenne Twister parameters, one set per
+ * stream, for use with dcmt() of dcmt.h.
+ *
+ * For stream identifier id the search draws twist vectors a whose low 16
+ * bits are id, and keeps the first whose characteristic polynomial is
+ * primitive of degree mexp. Since each id gives a different recurrence,
+ * streams with different identifiers have different characteristic
+ * polynomials, and their output sequences are independent in the sense of
+ * Matsumoto and Nishimura. The characteristic polynomial is found by the
+ * Berlekamp-Massey algorithm; as mexp is a Mersenne exponent, it is primitive
+ * if it is irreducible, which is checked by computing x^(2^mexp) modulo it,
+ * after sieving out polynomials with small factors.
+ *
+ * The tempering masks B and C are then chosen greedily, from the top bit
+ * down, to maximise k(v), the dimension to which the top v bits of the
+ * output are equidistributed, for v = 1, ..., 32. k(v) is the largest k for
+ * which the top v bits of k successive outputs are a linear map of rank vk
+ * from the state, which is found by Gaussian elimination.
+ *
+ * The search is deterministic: the parameters depend only on (mexp, seed,
+ * id), and not on the number of threads used. It is also costly, growing
+ * roughly as the cube of mexp: from a fraction of a second per stream for
+ * mexp = 521 to minutes for 4423, the largest exponent supported. Results
+ * are therefore best kept in a parameter database with
+ * dcmt_create_cached(), so that later runs find them at once.
+ *
+ * See:
+ *  - Matsumoto, M and Nishimura, T, *Dynamic Creation of Pseudorandom
+ *    Number Generators*, in Monte Carlo and Quasi-Monte Carlo Methods 1998,
+ *    Springer, 56-69 (2000).
+ *  - Matsumoto, M and Nishimura, T, *Mersenne Twister: A 623-dimensionally
+ *    equidistributed uniform pseudorandom number generator*, ACM
+ *    Transactions on Modeling and Computer Simulation **8**, 3-30 (1998).
+ */
+
+#ifndef CREATOR_H_
+#define CREATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dcmt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest stream identifier: identifiers occupy the low 16 bits of a. */
+#define DCMT_MAX_ID 0xffff
+
+/* Return non-zero if mexp is a Mersenne exponent for which the search is
+ * supported: 521, 607, 1279, 2203, 2281, 3217, 4253 or 4423. */
+int dcmt_supported (unsigned mexp);
+
+/* Find the parameters of stream id for period 2^mexp - 1.
+ *
+ * Each of the 2^15 candidates for the twist vector a of the stream, whose
+ * low 16 bits are the id, is tried at most once, in an order given by the
+ * seed. For a few ids, with probability about exp(-2^15 / mexp) each, none
+ * gives period 2^mexp - 1, whatever the seed; such ids cannot be used.
+ *
+ * A search allocates about 4 mexp^2 bytes, 78 MB for mexp = 4423, for the
+ * duration of the search.
+ *
+ * Returns zero on success or -1 if mexp is not supported, id is greater than
+ * DCMT_MAX_ID, memory could not be allocated (errno is then ENOMEM) or the
+ * stream has no parameters (errno is then EDOM). */
+int dcmt_create (unsigned mexp, uint64_t seed, unsigned id,
+                 dcmt_params_t *params);
+
+/* As dcmt_create() for the count streams first_id, ..., first_id + count - 1,
+ * storing the parameters of stream first_id + i in params[i]. The searches
+ * run on nthreads threads, or one per online processor if nthreads is zero,
+ * each with the memory of one search. */
+int dcmt_create_parallel (unsigned mexp, uint64_t seed, unsigned first_id,
+                          size_t count, dcmt_params_t params[],
+                          unsigned nthreads);
+
+/* As dcmt_create_parallel(), but first looking up each stream in the
+ * parameter database at path, which need not exist, and adding the streams
+ * which had to be searched for to it.
+ *
+ * The database is a text file with one parameter set per line, appended a
+ * line per write, so that several processes may share it; lines starting
+ * with # are comments. Returns zero on success or -1 on failure, when errno
+ * describes any error reading or writing the database. */
+int dcmt_create_cached (const char *path, unsigned mexp, uint64_t seed,
+                        unsigned first_id, size_t count,
+                        dcmt_params_t params[], unsigned nthreads);
+
+/* Return non-zero if params is a valid Mersenne Twister of period
+ * 2^mexp - 1, for mexp supported by dcmt_supported(). */
+int dcmt_check_params (const dcmt_params_t *params);
+
+/* Store in k[v-1] the dimension of equidistribution k(v) of the top v bits
+ * of the output of params, for v = 1, ..., 32. The upper bound of k(v) is
+ * mexp / v. Returns zero on success or -1 if mexp is not supported or memory
+ * could not be allocated. */
+int dcmt_equidistribution (const dcmt_params_t *params, unsigned k[32]);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CREATOR_H_ */
@@ -0,0 +1,124 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Mersenne Twisters with parameters given at run time.
+ *
+ * The routines follow mt19937ar_generate() and mt19937ar_temper() of
+ * mt19937.c, with the constants replaced by parameters which are loaded into
+ * locals once per block, so that the inner loops are the same as those of
+ * the hard-coded generator.
+ */
+
+#include "dcmt.h"
+#include "generator.h"
+#include "stats.h"
+
+/* Generate nn words of the state vector mt[] at once. */
+static inline void dcmt_generate (const dcmt_params_t *params, uint32_t mt[])
+{
+  const int nn = (int) params->nn, mm = (int) params->mm;
+  const uint32_t aaa = params->aaa;
+  const uint32_t upper = UINT32_C(0xffffffff) << params->rr;
+  const uint32_t lower = ~upper;
+  uint32_t y;
+  int kk;
+
+  for (kk = 0; kk < nn - mm; kk++)
+  {
+    y = (mt[kk] & upper) | (mt[kk+1] & lower);
+    mt[kk] = mt[kk+mm] ^ (y >> 1) ^ (-(y & 1) & aaa);
+  }
+
+  for (; kk < nn - 1; kk++)
+  {
+    y = (mt[kk] & upper) | (mt[kk+1] & lower);
+    mt[kk] = mt[kk+(mm-nn)] ^ (y >> 1) ^ (-(y & 1) & aaa);
+  }
+
+  y = (mt[nn-1] & upper) | (mt[0] & lower);
+  mt[nn-1] = mt[mm-1] ^ (y >> 1) ^ (-(y & 1) & aaa);
+}
+
+/* Tempering of a single word of the state vector. */
+static inline uint32_t dcmt_temper (const dcmt_params_t *params, uint32_t y)
+{
+  y ^= (y >> params->shift0);
+  y ^= (y << params->shiftB) & params->maskB;
+  y ^= (y << params->shiftC) & params->maskC;
+  y ^= (y >> params->shift1);
+
+  return y;
+}
+
+LIBRANDOM_API void init_dcmt (dcmt_state_t *state,
+                              const dcmt_params_t *params, uint32_t seed)
+{
+  uint32_t *mt = state->mt;
+  int i;
+
+  state->params = *params;
+
+  mt[0] = seed;
+  for (i = 1; i < (int) params->nn; i++)
+    mt[i] = UINT32_C(1812433253) * (mt[i-1] ^ (mt[i-1] >> 30)) + (uint32_t) i;
+
+  state->mti = (int32_t) params->nn;
+}
+
+LIBRANDOM_API int dcmt_params_valid (const dcmt_params_t *params)
+{
+  return params->nn <= DCMT_MAX_N && params->mm >= 1
+         && params->mm < params->nn && params->rr < 32
+         && params->mexp == 32 * params->nn - params->rr
+         && params->shift0 < 32 && params->shiftB < 32
+         && params->shiftC < 32 && params->shift1 < 32;
+}
+
+LIBRANDOM_API uint32_t dcmt (dcmt_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_DCMT, RANDOM_STATS_SCALAR, 1);
+
+  if (state->mti >= (int32_t) state->params.nn)
+  {
+    RANDOM_STATS_REGENERATE(RANDOM_DCMT,
+                            dcmt_generate(&state->params, state->mt));
+    state->mti = 0;
+  }
+
+  return dcmt_temper(&state->params, state->mt[state->mti++]);
+}
+
+/* Fill out[n] with the next n words, tempering a block at a time. */
+LIBRANDOM_API void dcmt_fill (dcmt_state_t *state, uint32_t *out, size_t n)
+{
+  const dcmt_params_t params = state->params; /* Not aliased by out. */
+  const int32_t nn = (int32_t) params.nn;
+
+  RANDOM_STATS_COUNT(RANDOM_DCMT, RANDOM_STATS_FILL, n);
+
+  while (n > 0)
+  {
+    const uint32_t *mt;
+    size_t i, k;
+
+    if (state->mti >= nn)
+    {
+      RANDOM_STATS_REGENERATE(RANDOM_DCMT,
+                              dcmt_generate(&params, state->mt));
+      state->mti = 0;
+    }
+
+    k = (size_t)(nn - state->mti);
+    if (k > n) k = n;
+
+    mt = state->mt + state->mti;
+    for (i = 0; i < k; i++)
+      out[i] = dcmt_temper(&params, mt[i]);
+
+    state->mti += (int32_t)k;
+    out += k;
+    n -= k;
+  }
+}
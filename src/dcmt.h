@@ -0,0 +1,104 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Mersenne Twisters with parameters given at run time, as produced by the
+ * Dynamic Creator (DCMT) of Matsumoto and Nishimura.
+ *
+ * Streams of one Mersenne Twister separated by jumping ahead all follow the
+ * same recurrence. The Dynamic Creator instead finds a different Mersenne
+ * Twister for each stream: the identifier of the stream is encoded in the
+ * low 16 bits of the twist vector a, so that distinct streams have distinct,
+ * and so coprime, characteristic polynomials. See creator.h for the search
+ * and a cache of its results.
+ *
+ * This file provides the generator itself, dcmt(), which takes its
+ * parameters from the state rather than from compile time constants. The
+ * word size is fixed at 32 bits; the Mersenne exponent, which determines the
+ * period 2^mexp - 1 and the size of the state, may be any of the Mersenne
+ * exponents up to 19937.
+ *
+ * See:
+ *  - Matsumoto, M and Nishimura, T, *Dynamic Creation of Pseudorandom
+ *    Number Generators*, in Monte Carlo and Quasi-Monte Carlo Methods 1998,
+ *    Springer, 56-69 (2000).
+ *  - <http://www.math.sci.hiroshima-u.ac.jp/~m-mat/MT/DC/dc.html>.
+ */
+
+#ifndef DCMT_H_
+#define DCMT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest number of 32-bit words in the state vector, for mexp = 19937. */
+#define DCMT_MAX_N 624
+
+/* Parameters of a Mersenne Twister with 32-bit words. The recurrence is
+ *
+ *   x[k+nn] = x[k+mm] ^ ((x[k] & upper | x[k+1] & lower) A)
+ *
+ * where upper selects the top 32 - rr bits, lower the bottom rr bits and A
+ * the twist by aaa, and mexp = 32 nn - rr. The output is tempered by
+ *
+ *   y ^= y >> shift0; y ^= (y << shiftB) & maskB;
+ *   y ^= (y << shiftC) & maskC; y ^= y >> shift1.
+ *
+ * All fields are 32-bit words so that the state below is a sequence of
+ * words (see generator.h). */
+typedef struct {
+  uint32_t mexp, nn, mm, rr;
+  uint32_t aaa;
+  uint32_t shift0, shiftB, shiftC, shift1;
+  uint32_t maskB, maskC;
+} dcmt_params_t;
+
+/* Initialiser of a dcmt_params_t giving the standard MT19937. */
+#define DCMT_PARAMS_MT19937 \
+  { 19937, 624, 397, 31, UINT32_C(0x9908b0df), 11, 7, 15, 18, \
+    UINT32_C(0x9d2c5680), UINT32_C(0xefc60000) }
+
+/* Number of words in the dcmt_params_t prefix of the state. */
+#define DCMT_PARAMS_WORDS 11
+
+/* State type for the dcmt generator. */
+typedef struct {
+  dcmt_params_t params;
+  uint32_t mt[DCMT_MAX_N]; /* State vector, of which mt[0..nn-1] are used. */
+  int32_t mti; /* State index: mti==nn means mt[] must be regenerated. */
+} dcmt_state_t;
+
+/* Initialise state with params and a scalar seed, as init_mt19937ar_r(), so
+ * that with DCMT_PARAMS_MT19937 dcmt() reproduces mt19937ar_r(). params must
+ * have nn <= DCMT_MAX_N. */
+LIBRANDOM_API void init_dcmt (dcmt_state_t *state,
+                              const dcmt_params_t *params, uint32_t seed);
+
+/* Return non-zero if params describe a Mersenne Twister which dcmt() can
+ * run: 1 <= mm < nn <= DCMT_MAX_N, mexp = 32 nn - rr with rr < 32, and
+ * every shift less than 32. Whether the period is 2^mexp - 1 is not
+ * checked. */
+LIBRANDOM_API int dcmt_params_valid (const dcmt_params_t *params);
+
+/* Return a 32-bit pseudo-random integer on the interval [0,0xffffffff]. */
+LIBRANDOM_API uint32_t dcmt (dcmt_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of dcmt(state). */
+LIBRANDOM_API void dcmt_fill (dcmt_state_t *state, uint32_t *out, size_t n);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#ifdef LIBRANDOM_INLINE
+#include "dcmt.c"
+#endif /* ifdef LIBRANDOM_INLINE */
+
+#endif /* DCMT_H_ */
@@ -0,0 +1,66 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Common base of the C++ engines of librandom.hpp and tausworthe.hpp. */
+
+#ifndef ENGINE_HPP_
+#define ENGINE_HPP_
+
+#include <cstddef>
+#include <limits>
+
+namespace librandom {
+
+namespace detail {
+
+/* Members common to every engine. Engine is the derived engine class, which
+ * must provide operator() and fill(out, n). */
+template <class Engine, class UIntType>
+class engine_base
+{
+public:
+  typedef UIntType result_type;
+
+  static constexpr result_type min () { return 0; }
+
+  static constexpr result_type max ()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /* Advance the engine by z steps. */
+  constexpr void discard (unsigned long long z)
+  {
+    for (; z; z--)
+      self()();
+  }
+
+  /* Fill [first, last) with successive outputs of the engine. */
+  void generate (result_type *first, result_type *last)
+  {
+    self().fill(first, static_cast<std::size_t>(last - first));
+  }
+
+  template <class OutputIt>
+  constexpr void generate (OutputIt first, OutputIt last)
+  {
+    for (; first != last; ++first)
+      *first = self()();
+  }
+
+  friend constexpr bool operator!= (const Engine &a, const Engine &b)
+  {
+    return !(a == b);
+  }
+
+private:
+  constexpr Engine &self () { return static_cast<Engine &>(*this); }
+};
+
+} /* namespace detail */
+
+} /* namespace librandom */
+
+#endif /* ENGINE_HPP_ */
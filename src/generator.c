@@ -0,0 +1,326 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Identifiers and descriptions of the generators of librandom. */
+
+#include <string.h>
+
+#include "generator.h"
+#include "stats.h"
+
+static const random_generator_info_t generators[RANDOM_GENERATOR_COUNT] = {
+  [RANDOM_KISS32] = { "kiss32", 32, sizeof(kiss32_state_t), 4, 0 },
+  [RANDOM_KISS32A] = { "kiss32a", 32, sizeof(kiss32a_state_t), 5, 0 },
+  [RANDOM_KISS64] = { "kiss64", 64, sizeof(kiss64_state_t), 4, 0 },
+  [RANDOM_TAUS88] = { "taus88", 32, sizeof(taus88_state_t), 3, 0 },
+  [RANDOM_LFSR113] = { "lfsr113", 32, sizeof(lfsr113_state_t), 4, 0 },
+  [RANDOM_LFSR258] = { "lfsr258", 64, sizeof(lfsr258_state_t), 5, 0 },
+  [RANDOM_MT19937AR] = { "mt19937ar", 32, sizeof(mt19937ar_state_t),
+                         MT19937AR_N, 1 },
+  [RANDOM_MT19937_64] = { "mt19937_64", 64, sizeof(mt19937_64_state_t),
+                          MT19937_64_NN, 1 },
+  [RANDOM_TINYMT32] = { "tinymt32", 32, sizeof(tinymt32_state_t), 7, 0 },
+  [RANDOM_TINYMT64] = { "tinymt64", 64, sizeof(tinymt64_state_t), 5, 0 },
+  [RANDOM_DCMT] = { "dcmt", 32, sizeof(dcmt_state_t),
+                    DCMT_PARAMS_WORDS + DCMT_MAX_N, 1 },
+  [RANDOM_PCG64] = { "pcg64", 64, sizeof(pcg64_state_t), 4, 0 },
+  [RANDOM_PCG64_DXSM] = { "pcg64_dxsm", 64, sizeof(pcg64_dxsm_state_t), 4, 0 },
+  [RANDOM_LCG128] = { "lcg128", 64, sizeof(lcg128_state_t), 4, 0 },
+};
+
+const random_generator_info_t *random_generator_info (
+  random_generator_id_t id)
+{
+  if ((unsigned) id >= RANDOM_GENERATOR_COUNT)
+    return NULL;
+
+  return &generators[id];
+}
+
+random_generator_id_t random_generator_find (const char *name)
+{
+  int id;
+
+  for (id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    if (strcmp(generators[id].name, name) == 0)
+      break;
+  }
+
+  return (random_generator_id_t) id;
+}
+
+/* SplitMix64 of Steele, Lea and Flood: a Weyl sequence with increment
+ * GOLDEN, the odd integer closest to 2^64 divided by the golden ratio,
+ * followed by the finalising mix of Stafford's variant 13 of MurmurHash3. */
+#define GOLDEN UINT64_C(0x9e3779b97f4a7c15)
+
+static uint64_t mix64 (uint64_t z)
+{
+  z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return z ^ (z >> 31);
+}
+
+static uint64_t splitmix64 (uint64_t *x)
+{
+  return mix64(*x += GOLDEN);
+}
+
+/* Return s if s > min, and s + min + 1, which is then greater than min,
+ * otherwise. */
+#define ABOVE(s, min) ((s) > (min) ? (s) : (s) + (min) + 1)
+
+int random_init_by_key (random_t *rng, random_generator_id_t id,
+                        const uint64_t key[], size_t n)
+{
+  random_state_t *state = &rng->state;
+  uint64_t x = 0, stream = n >= 2 ? key[1] : 0;
+  size_t i;
+
+  if ((unsigned) id >= RANDOM_GENERATOR_COUNT)
+    return -1;
+
+  for (i = 0; i < n; i++)
+    x = mix64((x ^ key[i]) + GOLDEN);
+
+  /* Zero the padding of the state too, so that equal states compare equal
+   * byte for byte. */
+  memset(rng, 0, sizeof(*rng));
+  rng->id = id;
+
+  switch (id)
+  {
+    case RANDOM_KISS32:
+      state->kiss32.mx = (uint32_t) splitmix64(&x);
+      state->kiss32.my = (uint32_t) splitmix64(&x);
+      state->kiss32.mz = (uint32_t) splitmix64(&x);
+      /* 0 < mc < 698769068 avoids both fixed points of the MWC, whatever
+       * the value of mz. */
+      state->kiss32.mc = 1 + (uint32_t) (splitmix64(&x) % 698769067);
+      if (state->kiss32.my == 0)
+        state->kiss32.my = UINT32_C(362436069);
+      break;
+
+    case RANDOM_KISS32A:
+      state->kiss32a.mx = (uint32_t) splitmix64(&x);
+      state->kiss32a.my = (uint32_t) splitmix64(&x);
+      state->kiss32a.mz = (uint32_t) splitmix64(&x) & UINT32_C(0x7fffffff);
+      state->kiss32a.mw = (uint32_t) splitmix64(&x) & UINT32_C(0x7fffffff);
+      state->kiss32a.mc = (uint32_t) splitmix64(&x) & 1;
+      if (state->kiss32a.my == 0)
+        state->kiss32a.my = UINT32_C(362436069);
+      /* Multiples of 7559, including zero, are not allowed. Since 2^31 - 1
+       * is prime, adding one stays below 2^31. */
+      if (state->kiss32a.mz % 7559 == 0)
+        state->kiss32a.mz++;
+      if (state->kiss32a.mw % 7559 == 0)
+        state->kiss32a.mw++;
+      break;
+
+    case RANDOM_KISS64:
+      state->kiss64.mx = splitmix64(&x);
+      state->kiss64.my = splitmix64(&x);
+      state->kiss64.mz = splitmix64(&x);
+      /* The carry is less than 2^58 and must not be zero with mz. */
+      state->kiss64.mc = (splitmix64(&x) >> 6) | 1;
+      if (state->kiss64.my == 0)
+        state->kiss64.my = UINT64_C(362436362436362436);
+      break;
+
+    case RANDOM_TAUS88:
+      state->taus88.s1 = ABOVE((uint32_t) splitmix64(&x), 1);
+      state->taus88.s2 = ABOVE((uint32_t) splitmix64(&x), 7);
+      state->taus88.s3 = ABOVE((uint32_t) splitmix64(&x), 15);
+      break;
+
+    case RANDOM_LFSR113:
+      state->lfsr113.s1 = ABOVE((uint32_t) splitmix64(&x), 1);
+      state->lfsr113.s2 = ABOVE((uint32_t) splitmix64(&x), 7);
+      state->lfsr113.s3 = ABOVE((uint32_t) splitmix64(&x), 15);
+      state->lfsr113.s4 = ABOVE((uint32_t) splitmix64(&x), 127);
+      break;
+
+    case RANDOM_LFSR258:
+      state->lfsr258.s1 = ABOVE(splitmix64(&x), 1);
+      state->lfsr258.s2 = ABOVE(splitmix64(&x), 511);
+      state->lfsr258.s3 = ABOVE(splitmix64(&x), 4095);
+      state->lfsr258.s4 = ABOVE(splitmix64(&x), 131071);
+      state->lfsr258.s5 = ABOVE(splitmix64(&x), 8388607);
+      break;
+
+    case RANDOM_MT19937AR:
+      for (i = 0; i < MT19937AR_N; i++)
+        state->mt19937ar.mt[i] = (uint32_t) splitmix64(&x);
+      /* As init_by_array(): the top bit of mt[0] guarantees a non-zero
+       * state. */
+      state->mt19937ar.mt[0] = UINT32_C(0x80000000);
+      state->mt19937ar.mti = MT19937AR_N;
+      break;
+
+    case RANDOM_MT19937_64:
+      for (i = 0; i < MT19937_64_NN; i++)
+        state->mt19937_64.mt[i] = splitmix64(&x);
+      state->mt19937_64.mt[0] = UINT64_C(1) << 63;
+      state->mt19937_64.mti = MT19937_64_NN;
+      break;
+
+    case RANDOM_TINYMT32:
+      init_tinymt32(&state->tinymt32,
+                    tinymt32_params(stream % TINYMT32_PARAMS_COUNT), 0);
+      for (i = 0; i < 4; i++)
+        state->tinymt32.status[i] = (uint32_t) splitmix64(&x);
+      /* The top bit of status[0] is not part of the state, which must not
+       * otherwise be zero. */
+      if ((state->tinymt32.status[0] & UINT32_C(0x7fffffff)) == 0
+          && state->tinymt32.status[1] == 0 && state->tinymt32.status[2] == 0
+          && state->tinymt32.status[3] == 0)
+        state->tinymt32.status[3] = 1;
+      break;
+
+    case RANDOM_TINYMT64:
+      init_tinymt64(&state->tinymt64,
+                    tinymt64_params(stream % TINYMT64_PARAMS_COUNT), 0);
+      state->tinymt64.status[0] = splitmix64(&x);
+      state->tinymt64.status[1] = splitmix64(&x);
+      if ((state->tinymt64.status[0] & UINT64_C(0x7fffffffffffffff)) == 0
+          && state->tinymt64.status[1] == 0)
+        state->tinymt64.status[1] = 1;
+      break;
+
+    case RANDOM_DCMT:
+    {
+      const dcmt_params_t params = DCMT_PARAMS_MT19937;
+
+      init_dcmt(&state->dcmt, &params, 0);
+      for (i = 0; i < DCMT_MAX_N; i++)
+        state->dcmt.mt[i] = (uint32_t) splitmix64(&x);
+      state->dcmt.mt[0] = UINT32_C(0x80000000);
+      break;
+    }
+
+    /* Any seed is valid, and the increment is made odd. */
+    case RANDOM_PCG64:
+    case RANDOM_PCG64_DXSM:
+    case RANDOM_LCG128:
+    {
+      uint64_t w[4];
+      pcg128_t seed, inc;
+
+      for (i = 0; i < 4; i++)
+        w[i] = splitmix64(&x);
+      seed = PCG128(w[0], w[1]);
+      inc = PCG128(w[2], w[3]);
+
+      if (id == RANDOM_PCG64)
+        init_pcg64(&state->pcg64, seed, inc);
+      else if (id == RANDOM_PCG64_DXSM)
+        init_pcg64_dxsm(&state->pcg64_dxsm, seed, inc);
+      else
+        init_lcg128(&state->lcg128, seed, inc);
+      break;
+    }
+
+    default:
+      return -1;
+  }
+
+  return 0;
+}
+
+#undef ABOVE
+
+int random_init (random_t *rng, random_generator_id_t id, uint64_t seed,
+                 uint64_t stream)
+{
+  uint64_t key[2];
+
+  key[0] = seed;
+  key[1] = stream;
+
+  return random_init_by_key(rng, id, key, 2);
+}
+
+void random_fill (random_t *rng, void *out, size_t n)
+{
+  random_state_t *state = &rng->state;
+
+  switch (rng->id)
+  {
+    case RANDOM_KISS32:
+      kiss32_fill(&state->kiss32, out, n);
+      break;
+    case RANDOM_KISS32A:
+      kiss32a_fill(&state->kiss32a, out, n);
+      break;
+    case RANDOM_KISS64:
+      kiss64_fill(&state->kiss64, out, n);
+      break;
+    case RANDOM_TAUS88:
+      taus88_fill(&state->taus88, out, n);
+      break;
+    case RANDOM_LFSR113:
+      lfsr113_fill(&state->lfsr113, out, n);
+      break;
+    case RANDOM_LFSR258:
+      lfsr258_fill(&state->lfsr258, out, n);
+      break;
+    case RANDOM_MT19937AR:
+      mt19937ar_fill(&state->mt19937ar, out, n);
+      break;
+    case RANDOM_MT19937_64:
+      mt19937_64_fill(&state->mt19937_64, out, n);
+      break;
+    case RANDOM_TINYMT32:
+      tinymt32_fill(&state->tinymt32, out, n);
+      break;
+    case RANDOM_TINYMT64:
+      tinymt64_fill(&state->tinymt64, out, n);
+      break;
+    case RANDOM_DCMT:
+      dcmt_fill(&state->dcmt, out, n);
+      break;
+    case RANDOM_PCG64:
+      pcg64_fill(&state->pcg64, out, n);
+      break;
+    case RANDOM_PCG64_DXSM:
+      pcg64_dxsm_fill(&state->pcg64_dxsm, out, n);
+      break;
+    case RANDOM_LCG128:
+      lcg128_fill(&state->lcg128, out, n);
+      break;
+    default:
+      break;
+  }
+}
+
+void random_fill64 (random_t *rng, uint64_t *out, size_t n)
+{
+  uint32_t words[512];
+  size_t i, m;
+
+  if (random_generator_info(rng->id)->word_bits == 64)
+  {
+    random_fill(rng, out, n);
+    return;
+  }
+
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < 256 ? n : 256;
+    random_fill(rng, words, 2 * m);
+    for (i = 0; i < m; i++)
+      out[i] = ((uint64_t) words[2 * i] << 32) | words[2 * i + 1];
+  }
+}
+
+void random_fill64_distribution (random_t *rng, uint64_t *out, size_t n)
+{
+  random_fill64(rng, out, n);
+  RANDOM_STATS_TRANSFER(rng->id, RANDOM_STATS_FILL, RANDOM_STATS_DISTRIBUTION,
+                        n * (64 / random_generator_info(rng->id)->word_bits));
+}
+
+#undef GOLDEN
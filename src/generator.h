@@ -0,0 +1,152 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Identifiers and descriptions of the generators of librandom.
+ *
+ * Routines which work with any of the generators, such as the checkpoint
+ * routines of checkpoint.h, identify a generator by a random_generator_id_t.
+ * The numeric values of the identifiers are part of the checkpoint file
+ * format and **must not** change; new generators are added at the end.
+ *
+ * A random_t holds the state of any one of the generators, together with its
+ * identifier, and can be seeded and used through the generic routines below.
+ */
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Generator identifiers. */
+typedef enum {
+  RANDOM_KISS32 = 0,
+  RANDOM_KISS32A = 1,
+  RANDOM_KISS64 = 2,
+  RANDOM_TAUS88 = 3,
+  RANDOM_LFSR113 = 4,
+  RANDOM_LFSR258 = 5,
+  RANDOM_MT19937AR = 6,
+  RANDOM_MT19937_64 = 7,
+  RANDOM_TINYMT32 = 8,
+  RANDOM_TINYMT64 = 9,
+  RANDOM_DCMT = 10,
+  RANDOM_PCG64 = 11,
+  RANDOM_PCG64_DXSM = 12,
+  RANDOM_LCG128 = 13,
+  RANDOM_GENERATOR_COUNT
+} random_generator_id_t;
+
+/* Description of a generator and the layout of its state type.
+ *
+ * Every state type consists of state_words words of word_bits bits each,
+ * followed, if state_index is non-zero, by an int32_t index; state_size is
+ * the size of the state type, including any trailing padding.
+ */
+typedef struct {
+  const char *name;   /* Name of the generator routine, e.g. "kiss64". */
+  unsigned word_bits; /* Width of each output and state word: 32 or 64. */
+  size_t state_size;  /* sizeof the state type. */
+  size_t state_words; /* Number of words in the state type. */
+  int state_index;    /* Non-zero if the words are followed by an index. */
+} random_generator_info_t;
+
+/* Return the description of generator id, or NULL if id is not valid. */
+const random_generator_info_t *random_generator_info (
+  random_generator_id_t id);
+
+/* Return the identifier of the generator called name, e.g. "kiss64", or
+ * RANDOM_GENERATOR_COUNT if there is no such generator. */
+random_generator_id_t random_generator_find (const char *name);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+/* The generator headers are included only after the identifiers above are
+ * declared, since in header-only mode (see inline.h) the generator sources
+ * they pull in refer to the identifiers. */
+#include "dcmt.h"
+#include "kiss.h"
+#include "lfsr.h"
+#include "mt19937.h"
+#include "pcg.h"
+#include "tinymt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* State of any one of the generators. */
+typedef union {
+  kiss32_state_t kiss32;
+  kiss32a_state_t kiss32a;
+  kiss64_state_t kiss64;
+  taus88_state_t taus88;
+  lfsr113_state_t lfsr113;
+  lfsr258_state_t lfsr258;
+  mt19937ar_state_t mt19937ar;
+  mt19937_64_state_t mt19937_64;
+  tinymt32_state_t tinymt32;
+  tinymt64_state_t tinymt64;
+  dcmt_state_t dcmt;
+  pcg64_state_t pcg64;
+  pcg64_dxsm_state_t pcg64_dxsm;
+  lcg128_state_t lcg128;
+} random_state_t;
+
+/* A generator of any type. */
+typedef struct {
+  random_generator_id_t id;
+  random_state_t state;
+} random_t;
+
+/* Initialise rng as generator id, seeded from the pair (seed, stream).
+ *
+ * Every word of the state is derived from seed and stream by the SplitMix64
+ * hash, after which any word that would lie outside the range required by
+ * the generator (see the documentation of each generator) is corrected.
+ * Different streams with the same seed, and different seeds, thus give
+ * unrelated and valid states. Note that for the Mersenne Twisters this does
+ * not reproduce init_mt19937ar(seed) or init_mt19937_64(seed).
+ *
+ * For TinyMT the stream also selects the parameter set, as built-in set
+ * stream % TINYMT32_PARAMS_COUNT (or TINYMT64_PARAMS_COUNT), so that streams
+ * with different sets are independent generators. For dcmt the parameters
+ * are those of MT19937; states with other parameters, found as described in
+ * creator.h, are set up with init_dcmt().
+ *
+ * Returns zero on success or -1 if id is not valid. */
+int random_init (random_t *rng, random_generator_id_t id, uint64_t seed,
+                 uint64_t stream);
+
+/* As random_init(), but seeded from the n words of key. */
+int random_init_by_key (random_t *rng, random_generator_id_t id,
+                        const uint64_t key[], size_t n);
+
+/* Fill out[0..n-1] with the next n outputs of rng, where out points to an
+ * array of uint32_t or uint64_t according to the word size of the
+ * generator. */
+void random_fill (random_t *rng, void *out, size_t n);
+
+/* Fill out[0..n-1] with n 64-bit words drawn from rng. A generator with
+ * 32-bit output supplies each word from two successive outputs, the first in
+ * the high half. */
+void random_fill64 (random_t *rng, uint64_t *out, size_t n);
+
+/* As random_fill64(), for the samplers of distributions: the outputs drawn
+ * are counted by the instrumentation of stats.h under the distribution API
+ * only, rather than the fill API. */
+void random_fill64_distribution (random_t *rng, uint64_t *out, size_t n);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* GENERATOR_H_ */
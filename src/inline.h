@@ -0,0 +1,51 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Optional header-only (force inlined) build of the core generators.
+ *
+ * By default the core generators are ordinary external functions compiled
+ * into build/librandom.a and build/librandom.so. For small-state generators
+ * such as kiss64() and lfsr113() the cost of the function call is comparable
+ * to the cost of generating a number, and an out-of-line call prevents the
+ * compiler from keeping the generator state in registers across a loop.
+ *
+ * Defining LIBRANDOM_INLINE before including any librandom header, e.g.
+ *
+ *     #define LIBRANDOM_INLINE
+ *     #include "kiss.h"
+ *
+ * or compiling with -DLIBRANDOM_INLINE, makes each header pull in the
+ * corresponding source file and declares every core generator
+ * `static inline`, forcing inlining where the compiler supports it. No
+ * library needs to be linked in this mode, unless LIBRANDOM_STATS is also
+ * defined: the instrumented generators then call the counters of stats.h,
+ * and librandom must be linked to provide them.
+ *
+ * Note that in header-only mode each translation unit has its own private
+ * copy of any file scope state, such as the default state used by
+ * mt19937ar() and mt19937_64().
+ *
+ * Alternatively, the library itself can be built with link time
+ * optimisation (see the `lto` target in the makefile), which allows calls
+ * into librandom.a to be inlined when the calling program is also compiled
+ * and linked with -flto.
+ */
+
+#ifndef INLINE_H_
+#define INLINE_H_
+
+#ifdef LIBRANDOM_INLINE
+#  if defined(_MSC_VER)
+#    define LIBRANDOM_API static __forceinline
+#  elif defined(__GNUC__)
+#    define LIBRANDOM_API static inline __attribute__((always_inline))
+#  else
+#    define LIBRANDOM_API static inline
+#  endif
+#else
+#  define LIBRANDOM_API
+#endif /* ifdef LIBRANDOM_INLINE */
+
+#endif /* INLINE_H_ */
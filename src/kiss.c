@@ -6,11 +6,13 @@
 /* Multiply-with-carry combinational generators of Marsaglia. */
 
 #include "kiss.h"
+#include "generator.h"
+#include "stats.h"
 
 #ifdef UINT64_C
 
 /* 32-bit combinational multiply-with-carry generator of Marsaglia. */
-uint32_t kiss32 (kiss32_state_t *state)
+static inline uint32_t kiss32_next (kiss32_state_t *state)
 {
   uint64_t t;
 
@@ -29,10 +31,30 @@ uint32_t kiss32 (kiss32_state_t *state)
   return (state->mx + state->my + (state->mz=t));
 }
 
+LIBRANDOM_API uint32_t kiss32 (kiss32_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_KISS32, RANDOM_STATS_SCALAR, 1);
+  return kiss32_next(state);
+}
+
+LIBRANDOM_API void kiss32_fill (kiss32_state_t *state, uint32_t *out,
+                                size_t n)
+{
+  kiss32_state_t s = *state; /* Keep the state in registers. */
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_KISS32, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+    out[i] = kiss32_next(&s);
+
+  *state = s;
+}
+
 #endif /* ifdef UINT64_C */
 
 /* 32-bit combinational add-with-carry generator of Marsaglia. */
-uint32_t kiss32a (kiss32a_state_t *state)
+static inline uint32_t kiss32a_next (kiss32a_state_t *state)
 {
   uint32_t t;
 
@@ -53,10 +75,30 @@ uint32_t kiss32a (kiss32a_state_t *state)
   return (state->mx + state->my + state->mw);
 }
 
+LIBRANDOM_API uint32_t kiss32a (kiss32a_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_KISS32A, RANDOM_STATS_SCALAR, 1);
+  return kiss32a_next(state);
+}
+
+LIBRANDOM_API void kiss32a_fill (kiss32a_state_t *state, uint32_t *out,
+                                 size_t n)
+{
+  kiss32a_state_t s = *state; /* Keep the state in registers. */
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_KISS32A, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+    out[i] = kiss32a_next(&s);
+
+  *state = s;
+}
+
 #ifdef UINT64_C
 
 /* 64-bit combinational multiply-with-carry generator of Marsaglia. */
-uint64_t kiss64 (kiss64_state_t *state)
+static inline uint64_t kiss64_next (kiss64_state_t *state)
 {
     uint64_t t;
 
@@ -77,4 +119,24 @@ uint64_t kiss64 (kiss64_state_t *state)
     return (state->mx + state->my + state->mz);
 }
 
+LIBRANDOM_API uint64_t kiss64 (kiss64_state_t *state)
+{
+    RANDOM_STATS_COUNT(RANDOM_KISS64, RANDOM_STATS_SCALAR, 1);
+    return kiss64_next(state);
+}
+
+LIBRANDOM_API void kiss64_fill (kiss64_state_t *state, uint64_t *out,
+                                size_t n)
+{
+    kiss64_state_t s = *state; /* Keep the state in registers. */
+    size_t i;
+
+    RANDOM_STATS_COUNT(RANDOM_KISS64, RANDOM_STATS_FILL, n);
+
+    for (i = 0; i < n; i++)
+      out[i] = kiss64_next(&s);
+
+    *state = s;
+}
+
 #endif /* ifdef UINT64_C */
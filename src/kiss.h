@@ -43,8 +43,15 @@
 #ifndef KISS_H_
 #define KISS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #ifdef UINT64_MAX
 
 /* State type for the kiss32 generator. */
@@ -91,7 +98,11 @@ typedef struct {
  * See: Marsaglia, G, Random Number Generators, Journal of Modern Applied
  *      Statistical Methods 2, 2-13 (2003)
  */
-uint32_t kiss32 (kiss32_state_t *state);
+LIBRANDOM_API uint32_t kiss32 (kiss32_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of kiss32(state). */
+LIBRANDOM_API void kiss32_fill (kiss32_state_t *state, uint32_t *out,
+                                size_t n);
 
 #endif /* ifdef UINT64_MAX */
 
@@ -119,7 +130,11 @@ typedef struct {
  * See: George Marsaglia <g...@stat.fsu.edu> Fortran and C: United with a KISS,
  *      Article <> in Usenet newsgroup: comp.lang.fortran, 23 June 2007.
  */
-uint32_t kiss32a (kiss32a_state_t *state);
+LIBRANDOM_API uint32_t kiss32a (kiss32a_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of kiss32a(state). */
+LIBRANDOM_API void kiss32a_fill (kiss32a_state_t *state, uint32_t *out,
+                                 size_t n);
 
 #ifdef UINT64_MAX
 
@@ -143,8 +158,20 @@ typedef struct {
  * Usenet newsgroups: sci.math, comp.lang.c, comp.lang.fortran, 28
  * February 2009.
  */
-uint64_t kiss64 (kiss64_state_t *state);
+LIBRANDOM_API uint64_t kiss64 (kiss64_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of kiss64(state). */
+LIBRANDOM_API void kiss64_fill (kiss64_state_t *state, uint64_t *out,
+                                size_t n);
 
 #endif /* ifdef UINT64_MAX */
 
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#ifdef LIBRANDOM_INLINE
+#include "kiss.c"
+#endif /* ifdef LIBRANDOM_INLINE */
+
 #endif /* KISS_H_ */
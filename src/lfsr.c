@@ -6,9 +6,11 @@
 /* LFSR Tausworthe generators of L'Ecuyer. */
 
 #include "lfsr.h"
+#include "generator.h"
+#include "stats.h"
 
 /* 32-bit 3-component LFSR Tausworthe generator of L'Ecuyer. */
-uint32_t taus88 (taus88_state_t *state)
+static inline uint32_t taus88_next (taus88_state_t *state)
 {
   #define TAUSWORTHE(s,a,b,c,d) ((s&c)<<d) ^ (((s <<a) ^ s)>>b)
 
@@ -16,11 +18,33 @@ uint32_t taus88 (taus88_state_t *state)
   state->s2 = TAUSWORTHE(state->s2,  2, 25, UINT32_C(4294967288),  4);
   state->s3 = TAUSWORTHE(state->s3,  3, 11, UINT32_C(4294967280), 17);
 
+  #undef TAUSWORTHE
+
   return (state->s1 ^ state->s2 ^ state->s3);
 }
 
+LIBRANDOM_API uint32_t taus88 (taus88_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_TAUS88, RANDOM_STATS_SCALAR, 1);
+  return taus88_next(state);
+}
+
+LIBRANDOM_API void taus88_fill (taus88_state_t *state, uint32_t *out,
+                                size_t n)
+{
+  taus88_state_t s = *state; /* Keep the state in registers. */
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_TAUS88, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+    out[i] = taus88_next(&s);
+
+  *state = s;
+}
+
 /* 32-bit 4-component LFSR Tausworthe generator of L'Ecuyer. */
-uint32_t lfsr113 (lfsr113_state_t *state)
+static inline uint32_t lfsr113_next (lfsr113_state_t *state)
 {
    uint32_t b;
 
@@ -39,11 +63,31 @@ uint32_t lfsr113 (lfsr113_state_t *state)
    return (state->s1 ^ state->s2 ^ state->s3 ^ state->s4);
 }
 
+LIBRANDOM_API uint32_t lfsr113 (lfsr113_state_t *state)
+{
+   RANDOM_STATS_COUNT(RANDOM_LFSR113, RANDOM_STATS_SCALAR, 1);
+   return lfsr113_next(state);
+}
+
+LIBRANDOM_API void lfsr113_fill (lfsr113_state_t *state, uint32_t *out,
+                                 size_t n)
+{
+   lfsr113_state_t s = *state; /* Keep the state in registers. */
+   size_t i;
+
+   RANDOM_STATS_COUNT(RANDOM_LFSR113, RANDOM_STATS_FILL, n);
+
+   for (i = 0; i < n; i++)
+     out[i] = lfsr113_next(&s);
+
+   *state = s;
+}
+
 /* Is the UINT64_C cast required by C99? I don't think so. */
 #ifdef UINT64_C
 
 /* 64-bit LFSR Tausworthe generator of L'Ecuyer. */
-uint64_t lfsr258 (lfsr258_state_t *state)
+static inline uint64_t lfsr258_next (lfsr258_state_t *state)
 {
    uint64_t b;
 
@@ -65,4 +109,24 @@ uint64_t lfsr258 (lfsr258_state_t *state)
    return (state->s1 ^ state->s2 ^ state->s3 ^ state->s4 ^ state->s5);
 }
 
+LIBRANDOM_API uint64_t lfsr258 (lfsr258_state_t *state)
+{
+   RANDOM_STATS_COUNT(RANDOM_LFSR258, RANDOM_STATS_SCALAR, 1);
+   return lfsr258_next(state);
+}
+
+LIBRANDOM_API void lfsr258_fill (lfsr258_state_t *state, uint64_t *out,
+                                 size_t n)
+{
+   lfsr258_state_t s = *state; /* Keep the state in registers. */
+   size_t i;
+
+   RANDOM_STATS_COUNT(RANDOM_LFSR258, RANDOM_STATS_FILL, n);
+
+   for (i = 0; i < n; i++)
+     out[i] = lfsr258_next(&s);
+
+   *state = s;
+}
+
 #endif /* ifdef UINT64_C */
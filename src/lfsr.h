@@ -25,8 +25,15 @@
 #ifndef LFSR_H_
 #define LFSR_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* State type for the taus88 generator. */
 typedef struct {
     uint32_t s1, s2, s3;
@@ -44,7 +51,11 @@ typedef struct {
  * See: L'Ecuyer, P, Maximally Equidistributed Combined Tausworthe Generators,
  *      Mathematics of Computation 65, 203-13 (1996).
  */
-uint32_t taus88 (taus88_state_t *state);
+LIBRANDOM_API uint32_t taus88 (taus88_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of taus88(state). */
+LIBRANDOM_API void taus88_fill (taus88_state_t *state, uint32_t *out,
+                                size_t n);
 
 /* State type for the lfsr113 generator. */
 typedef struct {
@@ -63,7 +74,11 @@ typedef struct {
  * See: L'Ecuyer, P, Tables of Maximally-Equidistributed Combined LFSR
  *      Generators, Mathematics of Computation 68, 261-269 (1999).
  */
-uint32_t lfsr113 (lfsr113_state_t *state);
+LIBRANDOM_API uint32_t lfsr113 (lfsr113_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of lfsr113(state). */
+LIBRANDOM_API void lfsr113_fill (lfsr113_state_t *state, uint32_t *out,
+                                 size_t n);
 
 #ifdef UINT64_C
 
@@ -84,8 +99,20 @@ typedef struct {
  * See: L'Ecuyer, P, Tables of Maximally-Equidistributed Combined LFSR
  *      Generators, Mathematics of Computation 68, 261-269 (1999).
  */
-uint64_t lfsr258 (lfsr258_state_t *state);
+LIBRANDOM_API uint64_t lfsr258 (lfsr258_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of lfsr258(state). */
+LIBRANDOM_API void lfsr258_fill (lfsr258_state_t *state, uint64_t *out,
+                                 size_t n);
 
 #endif /* ifdef UINT64_C */
 
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#ifdef LIBRANDOM_INLINE
+#include "lfsr.c"
+#endif /* ifdef LIBRANDOM_INLINE */
+
 #endif /* LFSR_H_ */
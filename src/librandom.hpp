@@ -0,0 +1,417 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* C++17 engines for the librandom generators.
+ *
+ * Each engine meets the requirements of UniformRandomBitGenerator, and so can
+ * be used with the distributions of <random>:
+ *
+ *     librandom::kiss64_engine engine;
+ *     std::normal_distribution<double> normal(0.0, 1.0);
+ *     double x = normal(engine);
+ *
+ * Every engine owns its state, a copy of the corresponding C state type,
+ * and has constexpr min() and max(). The small-state engines (the kiss and
+ * LFSR generators) implement the generator step inline and constexpr, so
+ * they can be stepped at compile time and are never slower than a hand
+ * written loop; the LFSR steps are those of the templates of tausworthe.hpp.
+ * The Mersenne Twister engines call the reentrant C routines of mt19937.h;
+ * these are inlined when LIBRANDOM_INLINE is defined (see inline.h) or when
+ * the library is built with link time optimisation.
+ *
+ * In addition to operator() and discard(), each engine has a bulk member
+ * generate(first, last) which, given pointers, forwards to the C *_fill
+ * routine of the generator. The Mersenne Twister fills temper a whole block
+ * of the state vector at a time in a loop which the compiler can vectorise.
+ *
+ * Outputs are counted by the instrumentation of stats.h only when they are
+ * drawn through the C routines: by generate() given pointers, and by
+ * operator() of the Mersenne Twister engines. The small-state engines step
+ * inline in operator(), discard() and generate() given other iterators, and
+ * those outputs are not counted.
+ */
+
+#ifndef LIBRANDOM_HPP_
+#define LIBRANDOM_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "kiss.h"
+#include "lfsr.h"
+#include "mt19937.h"
+
+#include "engine.hpp"
+#include "tausworthe.hpp"
+
+namespace librandom {
+
+/* Engine for the kiss32 generator, see kiss.h. */
+class kiss32_engine
+  : public detail::engine_base<kiss32_engine, std::uint32_t>
+{
+public:
+  typedef kiss32_state_t state_type;
+
+  /* Seeded with the seeds used by Marsaglia. */
+  constexpr kiss32_engine ()
+    : state_{123456789u, 362436000u, 521288629u, 7654321u} {}
+
+  constexpr explicit kiss32_engine (const state_type &state)
+    : state_(state) {}
+
+  constexpr result_type operator() ()
+  {
+    std::uint64_t t = 0;
+
+    state_.mx = 69069u*state_.mx + 12345u;
+
+    state_.my ^= (state_.my << 13);
+    state_.my ^= (state_.my >> 17);
+    state_.my ^= (state_.my <<  5);
+
+    t = UINT64_C(698769069)*state_.mz + state_.mc;
+    state_.mc = static_cast<std::uint32_t>(t >> 32);
+    state_.mz = static_cast<std::uint32_t>(t);
+
+    return state_.mx + state_.my + state_.mz;
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    kiss32_fill(&state_, out, n);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const kiss32_engine &a,
+                                    const kiss32_engine &b)
+  {
+    return a.state_.mx == b.state_.mx && a.state_.my == b.state_.my
+        && a.state_.mz == b.state_.mz && a.state_.mc == b.state_.mc;
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the kiss32a generator, see kiss.h. */
+class kiss32a_engine
+  : public detail::engine_base<kiss32a_engine, std::uint32_t>
+{
+public:
+  typedef kiss32a_state_t state_type;
+
+  /* Seeded with the seeds used by Marsaglia. */
+  constexpr kiss32a_engine ()
+    : state_{123456789u, 362436069u, 21288629u, 14921776u, 0u} {}
+
+  constexpr explicit kiss32a_engine (const state_type &state)
+    : state_(state) {}
+
+  constexpr result_type operator() ()
+  {
+    std::uint32_t t = 0;
+
+    state_.mx += 545925293u;
+
+    state_.my ^= (state_.my << 13);
+    state_.my ^= (state_.my >> 17);
+    state_.my ^= (state_.my <<  5);
+
+    t = state_.mz + state_.mw + state_.mc;
+    state_.mz = state_.mw;
+    state_.mc = (t >> 31);
+    state_.mw = t & 2147483647u;
+
+    return state_.mx + state_.my + state_.mw;
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    kiss32a_fill(&state_, out, n);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const kiss32a_engine &a,
+                                    const kiss32a_engine &b)
+  {
+    return a.state_.mx == b.state_.mx && a.state_.my == b.state_.my
+        && a.state_.mz == b.state_.mz && a.state_.mw == b.state_.mw
+        && a.state_.mc == b.state_.mc;
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the kiss64 generator, see kiss.h. */
+class kiss64_engine
+  : public detail::engine_base<kiss64_engine, std::uint64_t>
+{
+public:
+  typedef kiss64_state_t state_type;
+
+  /* Seeded with the seeds used by Marsaglia. */
+  constexpr kiss64_engine ()
+    : state_{UINT64_C(1066149217761810), UINT64_C(362436362436362436),
+             UINT64_C(1234567890987654321), UINT64_C(123456123456123456)} {}
+
+  constexpr explicit kiss64_engine (const state_type &state)
+    : state_(state) {}
+
+  constexpr result_type operator() ()
+  {
+    std::uint64_t t = 0;
+
+    state_.mx = UINT64_C(6906969069)*state_.mx + 1234567u;
+
+    state_.my ^= (state_.my << 13);
+    state_.my ^= (state_.my >> 17);
+    state_.my ^= (state_.my << 43);
+
+    t = (state_.mz << 58) + state_.mc;
+    state_.mc = (state_.mz >>  6);
+    state_.mz += t;
+    state_.mc += (state_.mz < t);
+
+    return state_.mx + state_.my + state_.mz;
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    kiss64_fill(&state_, out, n);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const kiss64_engine &a,
+                                    const kiss64_engine &b)
+  {
+    return a.state_.mx == b.state_.mx && a.state_.my == b.state_.my
+        && a.state_.mz == b.state_.mz && a.state_.mc == b.state_.mc;
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the taus88 generator, see lfsr.h. */
+class taus88_engine
+  : public detail::engine_base<taus88_engine, std::uint32_t>
+{
+public:
+  typedef taus88_state_t state_type;
+
+  constexpr taus88_engine () : state_{12345u, 12345u, 12345u} {}
+
+  constexpr explicit taus88_engine (const state_type &state)
+    : state_(state) {}
+
+  constexpr result_type operator() ()
+  {
+    typedef taus88_tausworthe T;
+
+    state_.s1 = T::step_component<0>(state_.s1);
+    state_.s2 = T::step_component<1>(state_.s2);
+    state_.s3 = T::step_component<2>(state_.s3);
+
+    return state_.s1 ^ state_.s2 ^ state_.s3;
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    taus88_fill(&state_, out, n);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const taus88_engine &a,
+                                    const taus88_engine &b)
+  {
+    return a.state_.s1 == b.state_.s1 && a.state_.s2 == b.state_.s2
+        && a.state_.s3 == b.state_.s3;
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the lfsr113 generator, see lfsr.h. */
+class lfsr113_engine
+  : public detail::engine_base<lfsr113_engine, std::uint32_t>
+{
+public:
+  typedef lfsr113_state_t state_type;
+
+  constexpr lfsr113_engine () : state_{12345u, 12345u, 12345u, 12345u} {}
+
+  constexpr explicit lfsr113_engine (const state_type &state)
+    : state_(state) {}
+
+  constexpr result_type operator() ()
+  {
+    typedef lfsr113_tausworthe T;
+
+    state_.s1 = T::step_component<0>(state_.s1);
+    state_.s2 = T::step_component<1>(state_.s2);
+    state_.s3 = T::step_component<2>(state_.s3);
+    state_.s4 = T::step_component<3>(state_.s4);
+
+    return state_.s1 ^ state_.s2 ^ state_.s3 ^ state_.s4;
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    lfsr113_fill(&state_, out, n);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const lfsr113_engine &a,
+                                    const lfsr113_engine &b)
+  {
+    return a.state_.s1 == b.state_.s1 && a.state_.s2 == b.state_.s2
+        && a.state_.s3 == b.state_.s3 && a.state_.s4 == b.state_.s4;
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the lfsr258 generator, see lfsr.h. */
+class lfsr258_engine
+  : public detail::engine_base<lfsr258_engine, std::uint64_t>
+{
+public:
+  typedef lfsr258_state_t state_type;
+
+  constexpr lfsr258_engine ()
+    : state_{UINT64_C(12345987654321), UINT64_C(12345987654321),
+             UINT64_C(12345987654321), UINT64_C(12345987654321),
+             UINT64_C(12345987654321)} {}
+
+  constexpr explicit lfsr258_engine (const state_type &state)
+    : state_(state) {}
+
+  constexpr result_type operator() ()
+  {
+    typedef lfsr258_tausworthe T;
+
+    state_.s1 = T::step_component<0>(state_.s1);
+    state_.s2 = T::step_component<1>(state_.s2);
+    state_.s3 = T::step_component<2>(state_.s3);
+    state_.s4 = T::step_component<3>(state_.s4);
+    state_.s5 = T::step_component<4>(state_.s5);
+
+    return state_.s1 ^ state_.s2 ^ state_.s3 ^ state_.s4 ^ state_.s5;
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    lfsr258_fill(&state_, out, n);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const lfsr258_engine &a,
+                                    const lfsr258_engine &b)
+  {
+    return a.state_.s1 == b.state_.s1 && a.state_.s2 == b.state_.s2
+        && a.state_.s3 == b.state_.s3 && a.state_.s4 == b.state_.s4
+        && a.state_.s5 == b.state_.s5;
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the mt19937ar generator, see mt19937.h. */
+class mt19937ar_engine
+  : public detail::engine_base<mt19937ar_engine, std::uint32_t>
+{
+public:
+  typedef mt19937ar_state_t state_type;
+
+  static constexpr std::uint32_t default_seed = 5489u;
+
+  explicit mt19937ar_engine (std::uint32_t value = default_seed)
+  {
+    seed(value);
+  }
+
+  explicit mt19937ar_engine (const state_type &state) : state_(state) {}
+
+  void seed (std::uint32_t value = default_seed)
+  {
+    init_mt19937ar_r(&state_, value);
+  }
+
+  result_type operator() () { return mt19937ar_r(&state_); }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    mt19937ar_fill(&state_, out, n);
+  }
+
+  const state_type &state () const { return state_; }
+
+  friend bool operator== (const mt19937ar_engine &a,
+                          const mt19937ar_engine &b)
+  {
+    return a.state_.mti == b.state_.mti
+        && std::equal(a.state_.mt, a.state_.mt + MT19937AR_N, b.state_.mt);
+  }
+
+private:
+  state_type state_;
+};
+
+/* Engine for the mt19937_64 generator, see mt19937.h. */
+class mt19937_64_engine
+  : public detail::engine_base<mt19937_64_engine, std::uint64_t>
+{
+public:
+  typedef mt19937_64_state_t state_type;
+
+  static constexpr std::uint64_t default_seed = 5489u;
+
+  explicit mt19937_64_engine (std::uint64_t value = default_seed)
+  {
+    seed(value);
+  }
+
+  explicit mt19937_64_engine (const state_type &state) : state_(state) {}
+
+  void seed (std::uint64_t value = default_seed)
+  {
+    init_mt19937_64_r(&state_, value);
+  }
+
+  result_type operator() () { return mt19937_64_r(&state_); }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    mt19937_64_fill(&state_, out, n);
+  }
+
+  const state_type &state () const { return state_; }
+
+  friend bool operator== (const mt19937_64_engine &a,
+                          const mt19937_64_engine &b)
+  {
+    return a.state_.mti == b.state_.mti
+        && std::equal(a.state_.mt, a.state_.mt + MT19937_64_NN, b.state_.mt);
+  }
+
+private:
+  state_type state_;
+};
+
+} /* namespace librandom */
+
+#endif /* LIBRANDOM_HPP_ */
@@ -61,60 +61,54 @@
  *    to separate test file (see files under ./test/).
  *  - Unused 64-bit functions `genrand64_real1`, `genrand64_real2` and
  *    `genrand64_real2` removed.
- *  - Still to do: define a state type (see below).
+ *  - State vectors and indices moved into the state types
+ *    `mt19937ar_state_t` and `mt19937_64_state_t`, with reentrant `_r`
+ *    variants of each routine taking a pointer to the state. The original
+ *    routines operate on a default, static state.
+ *  - Bulk generation routines `mt19937ar_fill` and `mt19937_64_fill` added.
  */
 
 #include "mt19937.h"
+#include "generator.h"
+#include "stats.h"
 
 /* Parameters which determine period of the 32-bit generator - don't change. */
-#define N INT32_C(624)
+#define N MT19937AR_N
 #define M INT32_C(397)
 #define MATRIX_A UINT32_C(0x9908b0df)   /* Constant vector a */
 #define UPPER_MASK UINT32_C(0x80000000) /* Most significant w-r bits */
 #define LOWER_MASK UINT32_C(0x7fffffff) /* Least significant r bits */
 
-/* TODO Define a state type:
-typedef struct {
-  uint32_t state[N]; / * State vector. * /
-  int index; / * State index: mti==N+1 means state[N] is not initialized. * /
-} MT19937_state_t;
-*/
+/* State used by mt19937ar(): mti==N+1 means mt[N] is not initialized. */
+static mt19937ar_state_t mt19937ar_default = { {0}, N+1 };
 
-static uint32_t mt[N]; /* State vector. */
-static int mti=N+1; /* State index: mti==N+1 means mt[N] is not initialized */
-
-/* Core 32-bit Mersenne Twister generator. */
-uint32_t mt19937ar (void)
+/* Generate N words of the state vector mt[N] at once. */
+static inline void mt19937ar_generate (uint32_t mt[])
 {
     uint32_t y;
-    static uint32_t mag01[2]={UINT32_C(0x0), MATRIX_A};
+    static const uint32_t mag01[2]={UINT32_C(0x0), MATRIX_A};
     /* mag01[x] = x * MATRIX_A  for x=0,1 */
+    int kk;
 
-    if (mti >= N) /* Generate N words at once. */
+    for (kk=0; kk<N-M; kk++)
     {
-      int kk;
-
-      for (kk=0; kk<N-M; kk++)
-      {
-        y = (mt[kk] & UPPER_MASK) | (mt[kk+1] & LOWER_MASK);
-        mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & UINT32_C(0x1)];
-      }
-
-      for (; kk<N-1; kk++)
-      {
-        y = (mt[kk] & UPPER_MASK) | (mt[kk+1] & LOWER_MASK);
-        mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & UINT32_C(0x1)];
-      }
-
-      y = (mt[N-1] & UPPER_MASK) | (mt[0] & LOWER_MASK);
-      mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & UINT32_C(0x1)];
+      y = (mt[kk] & UPPER_MASK) | (mt[kk+1] & LOWER_MASK);
+      mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & UINT32_C(0x1)];
+    }
 
-      mti = 0;
+    for (; kk<N-1; kk++)
+    {
+      y = (mt[kk] & UPPER_MASK) | (mt[kk+1] & LOWER_MASK);
+      mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & UINT32_C(0x1)];
     }
 
-    y = mt[mti++];
+    y = (mt[N-1] & UPPER_MASK) | (mt[0] & LOWER_MASK);
+    mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & UINT32_C(0x1)];
+}
 
-    /* Tempering */
+/* Tempering of a single word of the 32-bit state vector. */
+static inline uint32_t mt19937ar_temper (uint32_t y)
+{
     y ^= (y >> 11);
     y ^= (y <<  7) & UINT32_C(0x9d2c5680);
     y ^= (y << 15) & UINT32_C(0xefc60000);
@@ -123,9 +117,73 @@ uint32_t mt19937ar (void)
     return y;
 }
 
+/* Core 32-bit Mersenne Twister generator. */
+LIBRANDOM_API uint32_t mt19937ar_r (mt19937ar_state_t *state)
+{
+    RANDOM_STATS_COUNT(RANDOM_MT19937AR, RANDOM_STATS_SCALAR, 1);
+
+    if (state->mti >= N) /* Generate N words at once. */
+    {
+      RANDOM_STATS_REGENERATE(RANDOM_MT19937AR,
+                              mt19937ar_generate(state->mt));
+      state->mti = 0;
+    }
+
+    return mt19937ar_temper(state->mt[state->mti++]);
+}
+
+LIBRANDOM_API uint32_t mt19937ar (void)
+{
+    return mt19937ar_r(&mt19937ar_default);
+}
+
+LIBRANDOM_API void mt19937ar_get_state (mt19937ar_state_t *state)
+{
+    *state = mt19937ar_default;
+}
+
+LIBRANDOM_API void mt19937ar_set_state (const mt19937ar_state_t *state)
+{
+    mt19937ar_default = *state;
+}
+
+/* Fill out[n] with the next n words, tempering a block at a time. */
+LIBRANDOM_API void mt19937ar_fill (mt19937ar_state_t *state, uint32_t *out,
+                                   size_t n)
+{
+    RANDOM_STATS_COUNT(RANDOM_MT19937AR, RANDOM_STATS_FILL, n);
+
+    while (n > 0)
+    {
+      const uint32_t *mt;
+      size_t i, k;
+
+      if (state->mti >= N)
+      {
+        RANDOM_STATS_REGENERATE(RANDOM_MT19937AR,
+                                mt19937ar_generate(state->mt));
+        state->mti = 0;
+      }
+
+      k = (size_t)(N - state->mti);
+      if (k > n) k = n;
+
+      mt = state->mt + state->mti;
+      for (i = 0; i < k; i++)
+        out[i] = mt19937ar_temper(mt[i]);
+
+      state->mti += (int32_t)k;
+      out += k;
+      n -= k;
+    }
+}
+
 /* Initialise seed state mt[N] with a scalar seed. */
-void init_mt19937ar (uint32_t seed)
+LIBRANDOM_API void init_mt19937ar_r (mt19937ar_state_t *state, uint32_t seed)
 {
+  uint32_t *mt = state->mt;
+  int mti;
+
   mt[0] = seed & UINT32_C(0xffffffff);
   for (mti=1; mti<N; mti++)
   {
@@ -135,16 +193,25 @@ void init_mt19937ar (uint32_t seed)
       /* only MSBs of the array mt[].                        */
       /* 2002/01/09 modified by Makoto Matsumoto             */
   }
+  state->mti = mti;
+}
+
+LIBRANDOM_API void init_mt19937ar (uint32_t seed)
+{
+  init_mt19937ar_r(&mt19937ar_default, seed);
 }
 
 /* Initialise seed state mt[N] with an array.
  * init_key is the array for initializing keys, key_length is it's length.
  */
-void init_mt19937ar_by_array (uint32_t init_key[], int key_length)
+LIBRANDOM_API void init_mt19937ar_by_array_r (mt19937ar_state_t *state,
+                                              uint32_t init_key[],
+                                              int key_length)
 {
+  uint32_t *mt = state->mt;
   int i, j, k;
 
-  init_mt19937ar(UINT32_C(19650218));
+  init_mt19937ar_r(state, UINT32_C(19650218));
   i=1; j=0;
   k = (N>key_length ? N : key_length);
 
@@ -169,50 +236,50 @@ void init_mt19937ar_by_array (uint32_t init_key[], int key_length)
   mt[0] = UINT32_C(0x80000000); /* MSB is 1; assuring non-zero initial array */
 }
 
+LIBRANDOM_API void init_mt19937ar_by_array (uint32_t init_key[],
+                                            int key_length)
+{
+  init_mt19937ar_by_array_r(&mt19937ar_default, init_key, key_length);
+}
+
 #ifdef UINT64_C
 
 /* Parameters which determine period of the 64-bit generator - don't change. */
-#define NN 312
+#define NN MT19937_64_NN
 #define MM 156
 #define MATRIX_AA UINT64_C(0xB5026F5AA96619E9)
 #define UM UINT64_C(0xFFFFFFFF80000000) /* Most significant 33-bits. */
 #define LM UINT64_C(0x7FFFFFFF)         /* Least significant 31-bits. */
 
-/* TODO Define a state type: */
-static uint64_t mt64[NN]; /* State vector. */
-static int mt64i=NN+1; /* State index: mt64i==NN+1 means mt64[NN] is not initialized */
+/* State used by mt19937_64(): mti==NN+1 means mt[NN] is not initialized. */
+static mt19937_64_state_t mt19937_64_default = { {0}, NN+1 };
 
-/* Core 64-bit Mersenne Twister generator. */
-uint64_t mt19937_64 (void)
+/* Generate NN words of the state vector mt64[NN] at once. */
+static inline void mt19937_64_generate (uint64_t mt64[])
 {
     uint64_t x;
-    static uint64_t mag01[2]={UINT64_C(0), MATRIX_AA};
+    static const uint64_t mag01[2]={UINT64_C(0), MATRIX_AA};
+    int i;
 
-    if (mt64i >= NN) /* Generate NN words at once. */
+    for (i=0; i<NN-MM; i++)
     {
-      int i;
-
-      for (i=0; i<NN-MM; i++)
-      {
-        x = (mt64[i] & UM) | (mt64[i+1] & LM);
-        mt64[i] = mt64[i+MM] ^ (x >> 1) ^ mag01[(int)(UINT64_C(x&1))];
-      }
-
-      for (; i<NN-1; i++)
-      {
-        x = (mt64[i] & UM) | (mt64[i+1] & LM);
-        mt64[i] = mt64[i+(MM-NN)] ^ (x >> 1) ^ mag01[(int)(UINT64_C(x&1))];
-      }
-
-      x = (mt64[NN-1] & UM) | (mt64[0] & LM);
-      mt64[NN-1] = mt64[MM-1] ^ (x >> 1) ^ mag01[(int)(UINT64_C(x&1))];
+      x = (mt64[i] & UM) | (mt64[i+1] & LM);
+      mt64[i] = mt64[i+MM] ^ (x >> 1) ^ mag01[(int)(UINT64_C(x&1))];
+    }
 
-      mt64i = 0;
+    for (; i<NN-1; i++)
+    {
+      x = (mt64[i] & UM) | (mt64[i+1] & LM);
+      mt64[i] = mt64[i+(MM-NN)] ^ (x >> 1) ^ mag01[(int)(UINT64_C(x&1))];
     }
 
-    x = mt64[mt64i++];
+    x = (mt64[NN-1] & UM) | (mt64[0] & LM);
+    mt64[NN-1] = mt64[MM-1] ^ (x >> 1) ^ mag01[(int)(UINT64_C(x&1))];
+}
 
-    /* Tempering */
+/* Tempering of a single word of the 64-bit state vector. */
+static inline uint64_t mt19937_64_temper (uint64_t x)
+{
     x ^= (x >> 29) & UINT64_C(0x5555555555555555);
     x ^= (x << 17) & UINT64_C(0x71D67FFFEDA60000);
     x ^= (x << 37) & UINT64_C(0xFFF7EEE000000000);
@@ -221,25 +288,99 @@ uint64_t mt19937_64 (void)
     return x;
 }
 
-/* Initialise seed state mt64[N] with a scalar seed. */
-void init_mt19937_64 (uint32_t seed)
+/* Core 64-bit Mersenne Twister generator. */
+LIBRANDOM_API uint64_t mt19937_64_r (mt19937_64_state_t *state)
+{
+    RANDOM_STATS_COUNT(RANDOM_MT19937_64, RANDOM_STATS_SCALAR, 1);
+
+    if (state->mti >= NN) /* Generate NN words at once. */
+    {
+      RANDOM_STATS_REGENERATE(RANDOM_MT19937_64,
+                              mt19937_64_generate(state->mt));
+      state->mti = 0;
+    }
+
+    return mt19937_64_temper(state->mt[state->mti++]);
+}
+
+LIBRANDOM_API uint64_t mt19937_64 (void)
+{
+    return mt19937_64_r(&mt19937_64_default);
+}
+
+LIBRANDOM_API void mt19937_64_get_state (mt19937_64_state_t *state)
+{
+    *state = mt19937_64_default;
+}
+
+LIBRANDOM_API void mt19937_64_set_state (const mt19937_64_state_t *state)
+{
+    mt19937_64_default = *state;
+}
+
+/* Fill out[n] with the next n words, tempering a block at a time. */
+LIBRANDOM_API void mt19937_64_fill (mt19937_64_state_t *state, uint64_t *out,
+                                    size_t n)
+{
+    RANDOM_STATS_COUNT(RANDOM_MT19937_64, RANDOM_STATS_FILL, n);
+
+    while (n > 0)
+    {
+      const uint64_t *mt64;
+      size_t i, k;
+
+      if (state->mti >= NN)
+      {
+        RANDOM_STATS_REGENERATE(RANDOM_MT19937_64,
+                                mt19937_64_generate(state->mt));
+        state->mti = 0;
+      }
+
+      k = (size_t)(NN - state->mti);
+      if (k > n) k = n;
+
+      mt64 = state->mt + state->mti;
+      for (i = 0; i < k; i++)
+        out[i] = mt19937_64_temper(mt64[i]);
+
+      state->mti += (int32_t)k;
+      out += k;
+      n -= k;
+    }
+}
+
+/* Initialise seed state mt64[NN] with a scalar seed. */
+LIBRANDOM_API void init_mt19937_64_r (mt19937_64_state_t *state,
+                                      uint64_t seed)
 {
+  uint64_t *mt64 = state->mt;
+  int mt64i;
+
   mt64[0] = seed;
   for (mt64i=1; mt64i<NN; mt64i++)
   {
     mt64[mt64i] = (UINT64_C(6364136223846793005)
       * (mt64[mt64i-1] ^ (mt64[mt64i-1] >> 62)) + mt64i);
   }
+  state->mti = mt64i;
+}
+
+LIBRANDOM_API void init_mt19937_64 (uint32_t seed)
+{
+  init_mt19937_64_r(&mt19937_64_default, seed);
 }
 
 /* Initialise seed state mt64[NN] with an array.
  * init_key is the array for initializing keys, key_length is it's length.
  */
-void init_mt19937_64_by_array (uint64_t init_key[], int key_length)
+LIBRANDOM_API void init_mt19937_64_by_array_r (mt19937_64_state_t *state,
+                                               uint64_t init_key[],
+                                               int key_length)
 {
+  uint64_t *mt64 = state->mt;
   int i, j, k;
 
-  init_mt19937_64(UINT64_C(19650218));
+  init_mt19937_64_r(state, UINT64_C(19650218));
   i=1; j=0;
   k = (NN>key_length ? NN : key_length);
 
@@ -265,5 +406,23 @@ void init_mt19937_64_by_array (uint64_t init_key[], int key_length)
   mt64[0] = UINT64_C(1) << 63; /* MSB is 1; assuring non-zero initial array */
 }
 
+LIBRANDOM_API void init_mt19937_64_by_array (uint64_t init_key[],
+                                             int key_length)
+{
+  init_mt19937_64_by_array_r(&mt19937_64_default, init_key, key_length);
+}
+
 #endif /* ifdef UINT64_C */
 
+/* Don't leak the generator parameters into files including this one in
+ * header-only mode (see inline.h). */
+#undef N
+#undef M
+#undef MATRIX_A
+#undef UPPER_MASK
+#undef LOWER_MASK
+#undef NN
+#undef MM
+#undef MATRIX_AA
+#undef UM
+#undef LM
@@ -39,32 +39,100 @@
 #ifndef MT19937_H_
 #define MT19937_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of 32-bit words in the mt19937ar state vector. */
+#define MT19937AR_N 624
+
+/* State type for the mt19937ar generator. */
+typedef struct {
+  uint32_t mt[MT19937AR_N]; /* State vector. */
+  int32_t mti; /* State index: mti==N+1 means mt[N] is not initialized. */
+} mt19937ar_state_t;
+
 /* Return a 32-bit pseudo-random integer on the interval [0,0xffffffff].
  *
  * The seed state **must** be initialised, using init_mt19937ar() or
  * init_mt19937ar_by_array(), before calling this routine.
  */
-uint32_t mt19937ar (void);
+LIBRANDOM_API uint32_t mt19937ar (void);
 
 /* mt19937ar initialisation routines. */
-void init_mt19937ar (uint32_t seed);
-void init_mt19937ar_by_array (uint32_t init_key[], int key_length);
+LIBRANDOM_API void init_mt19937ar (uint32_t seed);
+LIBRANDOM_API void init_mt19937ar_by_array (uint32_t init_key[],
+                                            int key_length);
+
+/* Copy the state used by mt19937ar() to *state, or replace it by a copy of
+ * *state, for instance to save it in or restore it from a checkpoint. */
+LIBRANDOM_API void mt19937ar_get_state (mt19937ar_state_t *state);
+LIBRANDOM_API void mt19937ar_set_state (const mt19937ar_state_t *state);
+
+/* Reentrant versions of the above, operating on an explicit state. */
+LIBRANDOM_API uint32_t mt19937ar_r (mt19937ar_state_t *state);
+LIBRANDOM_API void init_mt19937ar_r (mt19937ar_state_t *state, uint32_t seed);
+LIBRANDOM_API void init_mt19937ar_by_array_r (mt19937ar_state_t *state,
+                                              uint32_t init_key[],
+                                              int key_length);
+
+/* Fill out[0..n-1] with the next n outputs of mt19937ar_r(state). */
+LIBRANDOM_API void mt19937ar_fill (mt19937ar_state_t *state, uint32_t *out,
+                                   size_t n);
 
 #ifdef UINT64_C
 
+/* Number of 64-bit words in the mt19937_64 state vector. */
+#define MT19937_64_NN 312
+
+/* State type for the mt19937_64 generator. */
+typedef struct {
+  uint64_t mt[MT19937_64_NN]; /* State vector. */
+  int32_t mti; /* State index: mti==NN+1 means mt[NN] is not initialized. */
+} mt19937_64_state_t;
+
 /* Return a 64-bit pseudo-random integer on the interval [0, 2^64 - 1].
  *
  * The seed state **must** be initialised, using init_mt19937_64() or
  * init_mt19937_64_by_array(), before calling this routine.
  */
-uint64_t mt19937_64 (void);
+LIBRANDOM_API uint64_t mt19937_64 (void);
 
 /* mt19937_64 initialisation routines. */
-void init_mt19937_64 (uint32_t seed);
-void init_mt19937_64_by_array (uint64_t init_key[], int key_length);
+LIBRANDOM_API void init_mt19937_64 (uint32_t seed);
+LIBRANDOM_API void init_mt19937_64_by_array (uint64_t init_key[],
+                                             int key_length);
+
+/* Copy the state used by mt19937_64() to *state, or replace it by a copy of
+ * *state, for instance to save it in or restore it from a checkpoint. */
+LIBRANDOM_API void mt19937_64_get_state (mt19937_64_state_t *state);
+LIBRANDOM_API void mt19937_64_set_state (const mt19937_64_state_t *state);
+
+/* Reentrant versions of the above, operating on an explicit state. */
+LIBRANDOM_API uint64_t mt19937_64_r (mt19937_64_state_t *state);
+LIBRANDOM_API void init_mt19937_64_r (mt19937_64_state_t *state,
+                                      uint64_t seed);
+LIBRANDOM_API void init_mt19937_64_by_array_r (mt19937_64_state_t *state,
+                                               uint64_t init_key[],
+                                               int key_length);
+
+/* Fill out[0..n-1] with the next n outputs of mt19937_64_r(state). */
+LIBRANDOM_API void mt19937_64_fill (mt19937_64_state_t *state, uint64_t *out,
+                                    size_t n);
 
 #endif /* ifdef UINT64_C */
 
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#ifdef LIBRANDOM_INLINE
+#include "mt19937.c"
+#endif /* ifdef LIBRANDOM_INLINE */
+
 #endif /* MT19937_H_ */
@@ -0,0 +1,407 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Multivariate normal deviates. */
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mvnormal.h"
+#include "normal.h"
+#include "simd.h"
+
+/* Rows and columns of A in each tile of the multiplication: a tile of the
+ * deviates of a block stays in the level 1 cache while the rows of the tile
+ * are accumulated. */
+#define TILE 16
+
+/* Largest number of deviates in a block, which should fit in the level 2
+ * cache. */
+#define BLOCK_DEVIATES 32768
+
+/* Maximum number of Jacobi sweeps; convergence is quadratic, and takes
+ * fewer than ten for most matrices. */
+#define SWEEPS 64
+
+/* Factorisations of the covariance s (lower triangle) into a, with pivots
+ * no greater than tol taken to be zero. Each returns zero on success. */
+
+static int cholesky (const double *s, double *a, size_t d, double tol)
+{
+  size_t i, j, k;
+
+  memset(a, 0, d * d * sizeof(double));
+
+  for (j = 0; j < d; j++)
+  {
+    double pivot = s[j * d + j];
+
+    for (k = 0; k < j; k++)
+      pivot -= a[j * d + k] * a[j * d + k];
+    if (pivot <= tol)
+      return -1;
+    a[j * d + j] = sqrt(pivot);
+
+    for (i = j + 1; i < d; i++)
+    {
+      double v = s[i * d + j];
+
+      for (k = 0; k < j; k++)
+        v -= a[i * d + k] * a[j * d + k];
+      a[i * d + j] = v / a[j * d + j];
+    }
+  }
+
+  return 0;
+}
+
+static int ldlt (const double *s, double *a, size_t d, double tol,
+                 double scale)
+{
+  double *pivots = malloc(d * sizeof(double));
+  size_t i, j, k;
+  int status = 0;
+
+  if (pivots == NULL)
+    return -1;
+
+  memset(a, 0, d * d * sizeof(double));
+
+  for (j = 0; j < d && status == 0; j++)
+  {
+    double pivot = s[j * d + j];
+
+    for (k = 0; k < j; k++)
+      pivot -= a[j * d + k] * a[j * d + k] * pivots[k];
+    if (pivot < -tol)
+    {
+      status = -1;
+      break;
+    }
+
+    /* Below a zero pivot the column of a semi-definite matrix is zero, to
+     * within rounding: |s_ij|^2 <= s_ii s_jj. */
+    pivots[j] = pivot > tol ? pivot : 0;
+    a[j * d + j] = 1;
+    for (i = j + 1; i < d; i++)
+    {
+      double v = s[i * d + j];
+
+      for (k = 0; k < j; k++)
+        v -= a[i * d + k] * a[j * d + k] * pivots[k];
+
+      if (pivots[j] > 0)
+      {
+        a[i * d + j] = v / pivots[j];
+      }
+      else if (fabs(v) > sqrt(tol * scale))
+      {
+        status = -1;
+        break;
+      }
+    }
+  }
+
+  /* A = L D^(1/2). */
+  for (j = 0; j < d && status == 0; j++)
+  {
+    const double root = sqrt(pivots[j]);
+
+    for (i = j; i < d; i++)
+      a[i * d + j] *= root;
+  }
+
+  free(pivots);
+
+  return status;
+}
+
+/* Cyclic Jacobi: each rotation J, in the plane (p, q), zeros w_pq of
+ * W <- J^T W J, and V <- V J accumulates the eigenvectors (Golub and Van
+ * Loan, section 8.5). */
+static int eigen (const double *s, double *a, size_t d, double tol)
+{
+  double *w = malloc(d * d * sizeof(double));
+  size_t i, j, k, p, q;
+  int sweep, status = 0;
+
+  if (w == NULL)
+    return -1;
+
+  for (i = 0; i < d; i++)
+  {
+    for (j = 0; j <= i; j++)
+      w[i * d + j] = w[j * d + i] = s[i * d + j];
+  }
+
+  memset(a, 0, d * d * sizeof(double));
+  for (i = 0; i < d; i++)
+    a[i * d + i] = 1;
+
+  for (sweep = 0; sweep < SWEEPS; sweep++)
+  {
+    double off = 0, norm = 0;
+
+    for (i = 0; i < d; i++)
+    {
+      for (j = 0; j < d; j++)
+      {
+        norm += w[i * d + j] * w[i * d + j];
+        if (i != j)
+          off += w[i * d + j] * w[i * d + j];
+      }
+    }
+    if (off <= DBL_EPSILON * DBL_EPSILON * norm)
+      break;
+
+    for (p = 0; p + 1 < d; p++)
+    {
+      for (q = p + 1; q < d; q++)
+      {
+        const double wpq = w[p * d + q];
+        double theta, t, c, sn;
+
+        if (wpq == 0)
+          continue;
+
+        theta = (w[q * d + q] - w[p * d + p]) / (2 * wpq);
+        t = fabs(theta) > 1e150
+          ? 1 / (2 * theta)
+          : (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta * theta + 1));
+        c = 1 / sqrt(t * t + 1);
+        sn = t * c;
+
+        for (k = 0; k < d; k++)
+        {
+          const double wkp = w[k * d + p], wkq = w[k * d + q];
+          const double vkp = a[k * d + p], vkq = a[k * d + q];
+
+          if (k != p && k != q)
+          {
+            w[k * d + p] = w[p * d + k] = c * wkp - sn * wkq;
+            w[k * d + q] = w[q * d + k] = sn * wkp + c * wkq;
+          }
+          a[k * d + p] = c * vkp - sn * vkq;
+          a[k * d + q] = sn * vkp + c * vkq;
+        }
+
+        w[p * d + p] -= t * wpq;
+        w[q * d + q] += t * wpq;
+        w[p * d + q] = w[q * d + p] = 0;
+      }
+    }
+  }
+
+  /* A = V L^(1/2). */
+  for (j = 0; j < d; j++)
+  {
+    const double lambda = w[j * d + j];
+
+    if (lambda < -tol)
+    {
+      status = -1;
+      break;
+    }
+    for (i = 0; i < d; i++)
+      a[i * d + j] *= lambda > 0 ? sqrt(lambda) : 0;
+  }
+
+  free(w);
+
+  return status;
+}
+
+int random_mvnormal_init (random_mvnormal_t *mvn, size_t d,
+                          const double *mean, const double *cov,
+                          random_mvnormal_method_t method)
+{
+  double scale = 0, tol;
+  size_t i;
+  int status = -1;
+
+  if (d == 0 || d > ((size_t) -1 / sizeof(double) - 1) / (d + 1))
+    return -1;
+
+  mvn->d = d;
+  mvn->mean = malloc((d + d * d) * sizeof(double));
+  if (mvn->mean == NULL)
+    return -1;
+  mvn->factor = mvn->mean + d;
+
+  for (i = 0; i < d; i++)
+  {
+    mvn->mean[i] = mean ? mean[i] : 0;
+    if (fabs(cov[i * d + i]) > scale)
+      scale = fabs(cov[i * d + i]);
+  }
+  tol = 16 * (double) d * DBL_EPSILON * scale;
+
+  if (method == RANDOM_MVNORMAL_AUTO || method == RANDOM_MVNORMAL_CHOLESKY)
+  {
+    mvn->method = RANDOM_MVNORMAL_CHOLESKY;
+    status = cholesky(cov, mvn->factor, d, tol);
+  }
+  if (status != 0
+      && (method == RANDOM_MVNORMAL_AUTO || method == RANDOM_MVNORMAL_LDLT))
+  {
+    mvn->method = RANDOM_MVNORMAL_LDLT;
+    status = ldlt(cov, mvn->factor, d, tol, scale);
+  }
+  if (status != 0
+      && (method == RANDOM_MVNORMAL_AUTO || method == RANDOM_MVNORMAL_EIGEN))
+  {
+    mvn->method = RANDOM_MVNORMAL_EIGEN;
+    status = eigen(cov, mvn->factor, d, tol);
+  }
+
+  if (status != 0)
+  {
+    free(mvn->mean);
+    mvn->mean = mvn->factor = NULL;
+  }
+
+  return status;
+}
+
+void random_mvnormal_free (random_mvnormal_t *mvn)
+{
+  free(mvn->mean);
+  mvn->mean = mvn->factor = NULL;
+}
+
+/* x[j][0..m-1] = sum over k of a[j][k] z[k][0..m-1], for rows of x and z of
+ * stride elements, summing over k in order. Only k <= j is summed if a is
+ * lower triangular. */
+RANDOM_SIMD_INLINE void transform_kernel (const double *restrict a, size_t d,
+                                          int lower,
+                                          const double *restrict z,
+                                          double *restrict x, size_t m,
+                                          size_t stride)
+{
+  size_t j0, k0, j, k, i;
+
+  for (j = 0; j < d; j++)
+  {
+    for (i = 0; i < m; i++)
+      x[j * stride + i] = 0;
+  }
+
+  for (j0 = 0; j0 < d; j0 += TILE)
+  {
+    const size_t j1 = j0 + TILE < d ? j0 + TILE : d;
+    const size_t kmax = lower ? j1 : d;
+
+    for (k0 = 0; k0 < kmax; k0 += TILE)
+    {
+      for (j = j0; j < j1; j++)
+      {
+        size_t k1 = k0 + TILE < d ? k0 + TILE : d;
+        double *restrict xj = x + j * stride;
+
+        if (lower && k1 > j + 1)
+          k1 = j + 1;
+
+        /* Four rows of z at a time, keeping x in registers between them,
+         * in the same order of summation. */
+        for (k = k0; k + 4 <= k1; k += 4)
+        {
+          const double a0 = a[j * d + k], a1 = a[j * d + k + 1];
+          const double a2 = a[j * d + k + 2], a3 = a[j * d + k + 3];
+          const double *restrict z0 = z + k * stride;
+          const double *restrict z1 = z0 + stride;
+          const double *restrict z2 = z1 + stride;
+          const double *restrict z3 = z2 + stride;
+
+          for (i = 0; i < m; i++)
+            xj[i] = xj[i] + a0 * z0[i] + a1 * z1[i] + a2 * z2[i]
+                    + a3 * z3[i];
+        }
+
+        for (; k < k1; k++)
+        {
+          const double ajk = a[j * d + k];
+          const double *restrict zk = z + k * stride;
+
+          for (i = 0; i < m; i++)
+            xj[i] += ajk * zk[i];
+        }
+      }
+    }
+  }
+}
+
+RANDOM_SIMD_CLONES(transform, (const double *restrict a, size_t d, int lower,
+                               const double *restrict z, double *restrict x,
+                               size_t m, size_t stride),
+                   transform_kernel(a, d, lower, z, x, m, stride))
+
+int random_mvnormal_fill (const random_mvnormal_t *mvn, random_t *rng,
+                          double *out, size_t n, random_layout_t layout)
+{
+  const size_t d = mvn->d;
+  const int lower = mvn->method != RANDOM_MVNORMAL_EIGEN;
+  size_t block, begin, m, i, j;
+  double *z, *x;
+
+  /* An even number of samples, so that only the last block can end with
+   * half a pair of normal deviates, at least a vector of each. */
+  block = BLOCK_DEVIATES / d / 8 * 8;
+  if (block < 8)
+    block = 8;
+  if (block > 256)
+    block = 256;
+
+  z = malloc(2 * d * block * sizeof(double));
+  if (z == NULL)
+    return -1;
+  x = z + d * block;
+
+  for (begin = 0; begin < n; begin += m)
+  {
+    m = n - begin < block ? n - begin : block;
+
+    /* Deviates sample by sample, into x, transposed into z. */
+    random_normal_fill(rng, 0, 1, x, m * d);
+    for (i = 0; i < m; i++)
+    {
+      for (j = 0; j < d; j++)
+        z[j * block + i] = x[i * d + j];
+    }
+
+    RANDOM_SIMD_DISPATCH(transform, (mvn->factor, d, lower, z, x, m, block));
+
+    if (layout == RANDOM_COLUMN_MAJOR)
+    {
+      for (j = 0; j < d; j++)
+      {
+        double *restrict o = out + j * n + begin;
+        const double *restrict xj = x + j * block;
+
+        for (i = 0; i < m; i++)
+          o[i] = xj[i] + mvn->mean[j];
+      }
+    }
+    else
+    {
+      for (i = 0; i < m; i++)
+      {
+        double *restrict o = out + (begin + i) * d;
+
+        for (j = 0; j < d; j++)
+          o[j] = x[j * block + i] + mvn->mean[j];
+      }
+    }
+  }
+
+  free(z);
+
+  return 0;
+}
+
+#undef TILE
+#undef BLOCK_DEVIATES
+#undef SWEEPS
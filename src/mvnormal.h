@@ -0,0 +1,90 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Multivariate normal deviates.
+ *
+ * A deviate with mean mu and covariance S is x = mu + A z, where z is a
+ * vector of d independent standard normal deviates (see normal.h) and A is
+ * any factor with S = A A^T. The covariance is factorised once, by the first
+ * of these methods to succeed:
+ *
+ *  - Cholesky: A = L, lower triangular, for positive definite S;
+ *  - LDL^T: A = L D^(1/2), with L unit lower triangular and D diagonal and
+ *    non-negative, which extends to semi-definite S by taking the columns of
+ *    L with zero pivots to be zero;
+ *  - eigendecomposition: A = V L^(1/2), for S = V L V^T with V orthogonal,
+ *    found by cyclic Jacobi rotations; slightly negative eigenvalues, due to
+ *    rounding, are taken to be zero. A is then full.
+ *
+ * Pivots and eigenvalues within 16 d epsilon max(S_ii) of zero are taken to
+ * be zero; a matrix with more negative eigenvalues is not a covariance.
+ *
+ * Deviates are generated a block of samples at a time: the standard normal
+ * deviates of the block are transformed while still in cache, by a
+ * multiplication tiled to reuse them from the level 1 cache and vectorised
+ * across samples as in simd.h, and written directly to the output in either
+ * layout. No intermediate array of n d deviates is written. Sample i is
+ * formed from standard normal deviates i d, ..., i d + d - 1 of the sequence
+ * of random_normal_fill(), and every row of A is summed in order, so the
+ * output depends on neither the layout nor the instruction set.
+ */
+
+#ifndef MVNORMAL_H_
+#define MVNORMAL_H_
+
+#include <stddef.h>
+
+#include "generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Methods of factorisation. */
+typedef enum {
+  RANDOM_MVNORMAL_AUTO = 0,     /* The first to succeed, as above. */
+  RANDOM_MVNORMAL_CHOLESKY = 1,
+  RANDOM_MVNORMAL_LDLT = 2,
+  RANDOM_MVNORMAL_EIGEN = 3
+} random_mvnormal_method_t;
+
+/* Layout of n samples of dimension d: sample i, component j at
+ * out[i d + j] (row-major) or out[j n + i] (column-major). */
+typedef enum {
+  RANDOM_ROW_MAJOR = 0,
+  RANDOM_COLUMN_MAJOR = 1
+} random_layout_t;
+
+/* A factorised multivariate normal distribution. */
+typedef struct {
+  size_t d;
+  double *mean;                    /* d components. */
+  double *factor;                  /* A, d x d, row-major. */
+  random_mvnormal_method_t method; /* Method by which A was found. */
+} random_mvnormal_t;
+
+/* Factorise the distribution of dimension d with mean mean, or zero if mean
+ * is NULL, and covariance cov, a d x d row-major matrix of which only the
+ * lower triangle is read, by the given method.
+ *
+ * Returns zero on success, or -1 if the method fails, cov is not positive
+ * semi-definite, or the memory could not be allocated. */
+int random_mvnormal_init (random_mvnormal_t *mvn, size_t d,
+                          const double *mean, const double *cov,
+                          random_mvnormal_method_t method);
+
+/* Release the memory of mvn. */
+void random_mvnormal_free (random_mvnormal_t *mvn);
+
+/* Store n deviates of mvn in out, in the given layout, drawing from rng.
+ * Returns zero on success or -1 if the memory could not be allocated. */
+int random_mvnormal_fill (const random_mvnormal_t *mvn, random_t *rng,
+                          double *out, size_t n, random_layout_t layout);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MVNORMAL_H_ */
@@ -0,0 +1,125 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Uniform and normal floating point deviates. */
+
+#include <math.h>
+
+#include "normal.h"
+#include "simd.h"
+
+/* Number of words drawn at a time. */
+#define BLOCK 512
+
+/* The loops are vectorised for each instruction set by RANDOM_SIMD_CLONES,
+ * with restrict qualified arrays and branch-free bodies. */
+
+RANDOM_SIMD_INLINE void uniform_kernel (const uint64_t *restrict words,
+                                        double *restrict out, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    out[i] = random_simd_open(words[i]);
+}
+
+RANDOM_SIMD_INLINE void box_muller_kernel (const uint64_t *restrict words,
+                                           double *restrict out, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    const double u1 = random_simd_open(words[2 * i]);
+    const double u2 = random_simd_unit(words[2 * i + 1]);
+    const double r = sqrt(-2 * random_simd_log(u1));
+    double s, c;
+
+    random_simd_sincos2pi(u2, &s, &c);
+    out[2 * i] = r * c;
+    out[2 * i + 1] = r * s;
+  }
+}
+
+RANDOM_SIMD_INLINE void scale_kernel (double *restrict out, size_t n,
+                                      double mu, double sigma)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    out[i] = mu + sigma * out[i];
+}
+
+RANDOM_SIMD_CLONES(uniform, (const uint64_t *restrict words,
+                             double *restrict out, size_t n),
+                   uniform_kernel(words, out, n))
+RANDOM_SIMD_CLONES(box_muller, (const uint64_t *restrict words,
+                                double *restrict out, size_t n),
+                   box_muller_kernel(words, out, n))
+RANDOM_SIMD_CLONES(scale, (double *restrict out, size_t n, double mu,
+                           double sigma),
+                   scale_kernel(out, n, mu, sigma))
+
+void random_uniform_fill (random_t *rng, double *out, size_t n)
+{
+  uint64_t words[BLOCK];
+  size_t m;
+
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < BLOCK ? n : BLOCK;
+    random_fill64_distribution(rng, words, m);
+    RANDOM_SIMD_DISPATCH(uniform, (words, out, m));
+  }
+}
+
+void random_box_muller (const uint64_t *words, double *out, size_t n)
+{
+  RANDOM_SIMD_DISPATCH(box_muller, (words, out, n));
+}
+
+void random_normal_fill (random_t *rng, double mu, double sigma, double *out,
+                         size_t n)
+{
+  const int scaled = mu != 0 || sigma != 1;
+  uint64_t words[BLOCK];
+  double last[2];
+  size_t m;
+
+  for (; n >= 2; n -= m, out += m)
+  {
+    m = n < BLOCK ? n & ~(size_t) 1 : BLOCK;
+    random_fill64_distribution(rng, words, m);
+    RANDOM_SIMD_DISPATCH(box_muller, (words, out, m / 2));
+    if (scaled)
+      RANDOM_SIMD_DISPATCH(scale, (out, m, mu, sigma));
+  }
+
+  if (n == 1)
+  {
+    random_fill64_distribution(rng, words, 2);
+    RANDOM_SIMD_DISPATCH(box_muller, (words, last, 1));
+    *out = mu + sigma * last[0];
+  }
+}
+
+void random_normal_fill_float (random_t *rng, float mu, float sigma,
+                               float *out, size_t n)
+{
+  double buffer[BLOCK];
+  size_t i, m;
+
+  /* BLOCK is even, so the words are paired as by a single call of
+   * random_normal_fill(). */
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < BLOCK ? n : BLOCK;
+    random_normal_fill(rng, mu, sigma, buffer, m);
+    for (i = 0; i < m; i++)
+      out[i] = (float) buffer[i];
+  }
+}
+
+#undef BLOCK
@@ -0,0 +1,68 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Uniform and normal floating point deviates from any of the generators of
+ * generator.h.
+ *
+ * Uniform deviates on (0, 1) take the top 52 bits m of a 64-bit word (see
+ * random_fill64()) to (m + 1/2) 2^-52, which is never 0 or 1, so that its
+ * logarithm, or that of one minus it, is always finite.
+ *
+ * Normal deviates are found by the Box-Muller transform: from a pair of
+ * uniform deviates u1 on (0, 1) and u2 on [0, 1),
+ *
+ *   z1 = sqrt(-2 log u1) cos(2 pi u2),  z2 = sqrt(-2 log u1) sin(2 pi u2)
+ *
+ * are independent standard normal deviates. Unlike the polar method or the
+ * ziggurat, the transform takes a fixed number of words per deviate and has
+ * no rejection step, so it vectorises without branches or divergence between
+ * lanes, and its throughput does not depend on the values drawn. The
+ * logarithm, sine and cosine are the approximations of simd.h, and the
+ * transform is vectorised for the widest instruction set available; the
+ * results are the same on every machine. As u1 >= 2^-53, |z| < 8.6.
+ *
+ * Words consumed are counted as outputs of the distribution API of stats.h.
+ *
+ * See:
+ *  - Box, G E P and Muller, M E, *A Note on the Generation of Random Normal
+ *    Deviates*, Annals of Mathematical Statistics **29**, 610-1 (1958).
+ */
+
+#ifndef NORMAL_H_
+#define NORMAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fill out[0..n-1] with deviates drawn from the uniform distribution on
+ * (0, 1), one word each. */
+void random_uniform_fill (random_t *rng, double *out, size_t n);
+
+/* Fill out[0..n-1] with deviates drawn from the normal distribution with
+ * mean mu and standard deviation sigma, two from each pair of words. For odd
+ * n the last pair gives one deviate. */
+void random_normal_fill (random_t *rng, double mu, double sigma, double *out,
+                         size_t n);
+
+/* As random_normal_fill(), rounded to single precision. */
+void random_normal_fill_float (random_t *rng, float mu, float sigma,
+                               float *out, size_t n);
+
+/* Store in out[0..2 n - 1] the standard normal deviates given by the
+ * Box-Muller transform of the n pairs of words words[2 i], words[2 i + 1],
+ * the first giving u1 and the second u2. */
+void random_box_muller (const uint64_t *words, double *out, size_t n);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* NORMAL_H_ */
@@ -0,0 +1,195 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Deterministic multi-threaded generation of large arrays. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+/* Range of chunks [next, end) owned by one thread. The owner takes chunks
+ * from the front and thieves from the back. Ranges are padded to 128 bytes,
+ * a pair of cache lines, to avoid false sharing between threads. */
+typedef struct {
+  pthread_mutex_t lock;
+  size_t next, end;
+} range_t;
+
+typedef union {
+  range_t range;
+  char pad[128];
+} padded_range_t;
+
+typedef struct {
+  padded_range_t *ranges;
+  unsigned nranges;
+  random_parallel_task_t task;
+  void *arg;
+} pool_t;
+
+typedef struct {
+  pool_t *pool;
+  unsigned self;
+} worker_t;
+
+/* Take the next chunk from the front (own range) or back (stolen) of r. */
+static int take (range_t *r, int steal, size_t *chunk)
+{
+  int found = 0;
+
+  pthread_mutex_lock(&r->lock);
+  if (r->next < r->end)
+  {
+    *chunk = steal ? --r->end : r->next++;
+    found = 1;
+  }
+  pthread_mutex_unlock(&r->lock);
+
+  return found;
+}
+
+static void *work (void *p)
+{
+  worker_t *w = p;
+  pool_t *pool = w->pool;
+  unsigned k;
+  size_t chunk;
+
+  /* Own range first, then steal from the others in turn. */
+  for (k = 0; k < pool->nranges; k++)
+  {
+    range_t *r = &pool->ranges[(w->self + k) % pool->nranges].range;
+
+    while (take(r, k != 0, &chunk))
+      pool->task(pool->arg, chunk);
+  }
+
+  return NULL;
+}
+
+unsigned random_parallel_threads (void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return n > 0 ? (unsigned) n : 1;
+}
+
+void random_parallel_for (size_t nchunks, unsigned nthreads,
+                          random_parallel_task_t task, void *arg)
+{
+  padded_range_t *ranges;
+  pthread_t *threads;
+  worker_t *workers;
+  int *started;
+  pool_t pool;
+  unsigned t;
+
+  if (nthreads == 0)
+    nthreads = random_parallel_threads();
+  if (nthreads > nchunks)
+    nthreads = nchunks > 0 ? (unsigned) nchunks : 1;
+
+  ranges = malloc(nthreads * sizeof(*ranges));
+  threads = malloc(nthreads * sizeof(*threads));
+  workers = malloc(nthreads * sizeof(*workers));
+  started = calloc(nthreads, sizeof(*started));
+
+  if (nthreads == 1 || !ranges || !threads || !workers || !started)
+  {
+    size_t c;
+
+    /* Serial fallback. */
+    for (c = 0; c < nchunks; c++)
+      task(arg, c);
+  }
+  else
+  {
+    pool.ranges = ranges;
+    pool.nranges = nthreads;
+    pool.task = task;
+    pool.arg = arg;
+
+    /* Contiguous, near-equal ranges, one per thread. */
+    for (t = 0; t < nthreads; t++)
+    {
+      pthread_mutex_init(&ranges[t].range.lock, NULL);
+      ranges[t].range.next = nchunks * t / nthreads;
+      ranges[t].range.end = nchunks * (t + 1) / nthreads;
+      workers[t].pool = &pool;
+      workers[t].self = t;
+    }
+
+    /* The calling thread is worker 0. Chunks of any thread that fails to
+     * start are stolen by the others. */
+    for (t = 1; t < nthreads; t++)
+      started[t] = pthread_create(&threads[t], NULL, work, &workers[t]) == 0;
+
+    work(&workers[0]);
+
+    for (t = 1; t < nthreads; t++)
+    {
+      if (started[t])
+        pthread_join(threads[t], NULL);
+    }
+
+    for (t = 0; t < nthreads; t++)
+      pthread_mutex_destroy(&ranges[t].range.lock);
+  }
+
+  free(ranges);
+  free(threads);
+  free(workers);
+  free(started);
+}
+
+typedef struct {
+  const random_config_t *config;
+  unsigned char *out;
+  size_t n;
+  size_t word_size;
+} fill_t;
+
+static void fill_chunk (void *arg, size_t chunk)
+{
+  fill_t *fill = arg;
+  size_t begin = chunk * RANDOM_PARALLEL_CHUNK;
+  size_t count = fill->n - begin;
+  uint64_t key[3];
+  random_t rng;
+
+  if (count > RANDOM_PARALLEL_CHUNK)
+    count = RANDOM_PARALLEL_CHUNK;
+
+  key[0] = fill->config->seed;
+  key[1] = fill->config->stream;
+  key[2] = chunk;
+
+  random_init_by_key(&rng, fill->config->id, key, 3);
+  random_fill(&rng, fill->out + begin * fill->word_size, count);
+}
+
+int random_parallel_fill (const random_config_t *config, void *out, size_t n,
+                          unsigned nthreads)
+{
+  const random_generator_info_t *info = random_generator_info(config->id);
+  fill_t fill;
+
+  if (info == NULL)
+    return -1;
+
+  fill.config = config;
+  fill.out = out;
+  fill.n = n;
+  fill.word_size = info->word_bits / 8;
+
+  random_parallel_for((n + RANDOM_PARALLEL_CHUNK - 1) / RANDOM_PARALLEL_CHUNK,
+                      nthreads, fill_chunk, &fill);
+
+  return 0;
+}
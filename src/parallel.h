@@ -0,0 +1,74 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Deterministic multi-threaded generation of large arrays.
+ *
+ * random_parallel_fill() splits its output into chunks of
+ * RANDOM_PARALLEL_CHUNK words. Chunk c is generated by its own generator,
+ * initialised by random_init_by_key() with the key (seed, stream, c), so the
+ * contents of each chunk, and hence of the whole array, do not depend on the
+ * number of threads or on which thread generated which chunk: the output is
+ * bit-identical for 1 or 128 threads.
+ *
+ * The chunks are distributed by a small pool of POSIX threads. Each thread
+ * owns a contiguous range of chunks, which it generates in order from the
+ * front; a thread that runs out of work steals chunks from the back of the
+ * range of another. Since each thread is the first to write to its own range
+ * of the output, on NUMA systems with the usual first-touch policy the pages
+ * of each range are placed on the node of the thread that wrote them. For
+ * this to be effective the output should not be written, e.g. by memset(),
+ * before it is filled.
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of words generated by each chunk. Part of the definition of the
+ * output of random_parallel_fill() and so **must not** change. */
+#define RANDOM_PARALLEL_CHUNK 65536
+
+/* Generator, seed and stream from which an array is generated. */
+typedef struct {
+  random_generator_id_t id;
+  uint64_t seed;
+  uint64_t stream;
+} random_config_t;
+
+/* Fill out[0..n-1] with n words of config->id, using nthreads threads, or
+ * one per online processor if nthreads is zero. out points to an array of
+ * uint32_t or uint64_t according to the word size of the generator.
+ *
+ * Returns zero on success or -1 if config->id is not valid. Should threads
+ * not be available the calling thread generates the remaining chunks. */
+int random_parallel_fill (const random_config_t *config, void *out, size_t n,
+                          unsigned nthreads);
+
+/* Task run by random_parallel_for() for each chunk. */
+typedef void (*random_parallel_task_t) (void *arg, size_t chunk);
+
+/* Run task(arg, c) for every chunk c in [0, nchunks) using nthreads threads,
+ * or one per online processor if nthreads is zero, distributing the chunks
+ * as described above. The calling thread takes part and the call returns
+ * once every chunk has completed. */
+void random_parallel_for (size_t nchunks, unsigned nthreads,
+                          random_parallel_task_t task, void *arg);
+
+/* Return the number of online processors, or 1 if this is not known. */
+unsigned random_parallel_threads (void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PARALLEL_H_ */
@@ -0,0 +1,387 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Permuted congruential generators of O'Neill.
+ *
+ * The generators follow the reference implementations in pcg-c, available
+ * from <http://www.pcg-random.org/>, and NumPy (PCG64DXSM).
+ */
+
+#include "pcg.h"
+#include "generator.h"
+#include "stats.h"
+
+/* Multiplier of the 64-bit LCG. */
+#define PCG_MULT_64 UINT64_C(6364136223846793005)
+
+/* Multiplier of the 128-bit LCG, and the 64-bit multiplier of DXSM. */
+#define PCG_MULT_128 PCG128(UINT64_C(2549297995355413924), \
+                            UINT64_C(4865540595714422341))
+#define PCG_CHEAP_MULT_128 UINT64_C(0xda942042e4dd58b5)
+
+/* 128-bit arithmetic. */
+
+#ifdef PCG_HAS_UINT128
+
+static inline pcg128_t pcg128_add (pcg128_t a, pcg128_t b)
+{
+  return a + b;
+}
+
+static inline pcg128_t pcg128_mul (pcg128_t a, pcg128_t b)
+{
+  return a * b;
+}
+
+static inline pcg128_t pcg128_shl1 (pcg128_t a)
+{
+  return a << 1;
+}
+
+static inline pcg128_t pcg128_shr1 (pcg128_t a)
+{
+  return a >> 1;
+}
+
+static inline uint64_t pcg128_high (pcg128_t a)
+{
+  return (uint64_t) (a >> 64);
+}
+
+static inline uint64_t pcg128_low (pcg128_t a)
+{
+  return (uint64_t) a;
+}
+
+#else
+
+/* Return the high 64 bits of the 128-bit product a b. */
+static inline uint64_t pcg_mulhi64 (uint64_t a, uint64_t b)
+{
+  const uint64_t a0 = a & UINT64_C(0xffffffff), a1 = a >> 32;
+  const uint64_t b0 = b & UINT64_C(0xffffffff), b1 = b >> 32;
+  const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0;
+  const uint64_t mid = (p00 >> 32) + (p01 & UINT64_C(0xffffffff))
+                     + (p10 & UINT64_C(0xffffffff));
+
+  return a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+static inline pcg128_t pcg128_add (pcg128_t a, pcg128_t b)
+{
+  pcg128_t r;
+
+  r.low = a.low + b.low;
+  r.high = a.high + b.high + (r.low < a.low);
+
+  return r;
+}
+
+static inline pcg128_t pcg128_mul (pcg128_t a, pcg128_t b)
+{
+  pcg128_t r;
+
+  r.low = a.low * b.low;
+  r.high = pcg_mulhi64(a.low, b.low) + a.low * b.high + a.high * b.low;
+
+  return r;
+}
+
+static inline pcg128_t pcg128_shl1 (pcg128_t a)
+{
+  a.high = (a.high << 1) | (a.low >> 63);
+  a.low <<= 1;
+
+  return a;
+}
+
+static inline pcg128_t pcg128_shr1 (pcg128_t a)
+{
+  a.low = (a.low >> 1) | (a.high << 63);
+  a.high >>= 1;
+
+  return a;
+}
+
+static inline uint64_t pcg128_high (pcg128_t a)
+{
+  return a.high;
+}
+
+static inline uint64_t pcg128_low (pcg128_t a)
+{
+  return a.low;
+}
+
+#endif /* ifdef PCG_HAS_UINT128 */
+
+static inline pcg128_t pcg128_odd (pcg128_t a)
+{
+  return pcg128_add(pcg128_shl1(a), PCG128(0, 1));
+}
+
+/* Return state advanced by delta steps of x -> mult x + plus mod 2^128, by
+ * square-and-multiply of the affine map. */
+static pcg128_t pcg128_advance (pcg128_t state, pcg128_t delta,
+                                pcg128_t mult, pcg128_t plus)
+{
+  pcg128_t acc_mult = PCG128(0, 1), acc_plus = PCG128(0, 0);
+
+  while (pcg128_low(delta) | pcg128_high(delta))
+  {
+    if (pcg128_low(delta) & 1)
+    {
+      acc_mult = pcg128_mul(acc_mult, mult);
+      acc_plus = pcg128_add(pcg128_mul(acc_plus, mult), plus);
+    }
+    plus = pcg128_mul(pcg128_add(mult, PCG128(0, 1)), plus);
+    mult = pcg128_mul(mult, mult);
+    delta = pcg128_shr1(delta);
+  }
+
+  return pcg128_add(pcg128_mul(acc_mult, state), acc_plus);
+}
+
+static inline uint64_t pcg_rotr64 (uint64_t x, unsigned r)
+{
+  return (x >> r) | (x << ((-r) & 63));
+}
+
+static inline uint32_t pcg_rotr32 (uint32_t x, unsigned r)
+{
+  return (x >> r) | (x << ((-r) & 31));
+}
+
+/* pcg32 */
+
+/* XSH-RR output of a 64-bit state. */
+static inline uint32_t pcg32_output (uint64_t s)
+{
+  return pcg_rotr32((uint32_t) (((s >> 18) ^ s) >> 27), (unsigned) (s >> 59));
+}
+
+LIBRANDOM_API void init_pcg32 (pcg32_state_t *state, uint64_t seed,
+                               uint64_t stream)
+{
+  state->state = 0;
+  state->inc = (stream << 1) | 1;
+  state->state = state->state * PCG_MULT_64 + state->inc;
+  state->state += seed;
+  state->state = state->state * PCG_MULT_64 + state->inc;
+}
+
+LIBRANDOM_API uint32_t pcg32 (pcg32_state_t *state)
+{
+  const uint64_t s = state->state;
+
+  state->state = s * PCG_MULT_64 + state->inc;
+
+  return pcg32_output(s);
+}
+
+LIBRANDOM_API void pcg32_fill (pcg32_state_t *state, uint32_t *out,
+                               size_t n)
+{
+  uint64_t s = state->state;
+  const uint64_t inc = state->inc;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    out[i] = pcg32_output(s);
+    s = s * PCG_MULT_64 + inc;
+  }
+
+  state->state = s;
+}
+
+LIBRANDOM_API void pcg32_advance (pcg32_state_t *state, uint64_t delta)
+{
+  uint64_t mult = PCG_MULT_64, plus = state->inc;
+  uint64_t acc_mult = 1, acc_plus = 0;
+
+  for (; delta > 0; delta >>= 1)
+  {
+    if (delta & 1)
+    {
+      acc_mult *= mult;
+      acc_plus = acc_plus * mult + plus;
+    }
+    plus = (mult + 1) * plus;
+    mult *= mult;
+  }
+
+  state->state = acc_mult * state->state + acc_plus;
+}
+
+/* pcg64 */
+
+/* XSL-RR output of a 128-bit state. */
+static inline uint64_t pcg64_output (pcg128_t s)
+{
+  const uint64_t high = pcg128_high(s);
+
+  return pcg_rotr64(high ^ pcg128_low(s), (unsigned) (high >> 58));
+}
+
+LIBRANDOM_API void init_pcg64 (pcg64_state_t *state, pcg128_t seed,
+                               pcg128_t stream)
+{
+  state->inc = pcg128_odd(stream);
+  state->state = state->inc;
+  state->state = pcg128_add(state->state, seed);
+  state->state = pcg128_add(pcg128_mul(state->state, PCG_MULT_128),
+                            state->inc);
+}
+
+LIBRANDOM_API uint64_t pcg64 (pcg64_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_PCG64, RANDOM_STATS_SCALAR, 1);
+
+  state->state = pcg128_add(pcg128_mul(state->state, PCG_MULT_128),
+                            state->inc);
+
+  return pcg64_output(state->state);
+}
+
+LIBRANDOM_API void pcg64_fill (pcg64_state_t *state, uint64_t *out,
+                               size_t n)
+{
+  pcg128_t s = state->state;
+  const pcg128_t inc = state->inc;
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_PCG64, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+  {
+    s = pcg128_add(pcg128_mul(s, PCG_MULT_128), inc);
+    out[i] = pcg64_output(s);
+  }
+
+  state->state = s;
+}
+
+LIBRANDOM_API void pcg64_advance (pcg64_state_t *state, pcg128_t delta)
+{
+  state->state = pcg128_advance(state->state, delta, PCG_MULT_128,
+                                state->inc);
+}
+
+/* pcg64_dxsm */
+
+/* DXSM output of a 128-bit state. */
+static inline uint64_t pcg64_dxsm_output (pcg128_t s)
+{
+  uint64_t high = pcg128_high(s);
+  const uint64_t low = pcg128_low(s) | 1;
+
+  high ^= high >> 32;
+  high *= PCG_CHEAP_MULT_128;
+  high ^= high >> 48;
+
+  return high * low;
+}
+
+LIBRANDOM_API void init_pcg64_dxsm (pcg64_dxsm_state_t *state, pcg128_t seed,
+                                    pcg128_t stream)
+{
+  const pcg128_t mult = PCG128(0, PCG_CHEAP_MULT_128);
+
+  state->inc = pcg128_odd(stream);
+  state->state = state->inc;
+  state->state = pcg128_add(state->state, seed);
+  state->state = pcg128_add(pcg128_mul(state->state, mult), state->inc);
+}
+
+/* Unlike pcg64(), the output is taken from the state before the step, so
+ * that the multiplication of the step and the output can overlap. */
+LIBRANDOM_API uint64_t pcg64_dxsm (pcg64_dxsm_state_t *state)
+{
+  const pcg128_t s = state->state;
+
+  RANDOM_STATS_COUNT(RANDOM_PCG64_DXSM, RANDOM_STATS_SCALAR, 1);
+
+  state->state = pcg128_add(pcg128_mul(s, PCG128(0, PCG_CHEAP_MULT_128)),
+                            state->inc);
+
+  return pcg64_dxsm_output(s);
+}
+
+LIBRANDOM_API void pcg64_dxsm_fill (pcg64_dxsm_state_t *state, uint64_t *out,
+                                    size_t n)
+{
+  const pcg128_t mult = PCG128(0, PCG_CHEAP_MULT_128);
+  pcg128_t s = state->state;
+  const pcg128_t inc = state->inc;
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_PCG64_DXSM, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+  {
+    out[i] = pcg64_dxsm_output(s);
+    s = pcg128_add(pcg128_mul(s, mult), inc);
+  }
+
+  state->state = s;
+}
+
+LIBRANDOM_API void pcg64_dxsm_advance (pcg64_dxsm_state_t *state,
+                                       pcg128_t delta)
+{
+  state->state = pcg128_advance(state->state, delta,
+                                PCG128(0, PCG_CHEAP_MULT_128), state->inc);
+}
+
+/* lcg128 */
+
+LIBRANDOM_API void init_lcg128 (lcg128_state_t *state, pcg128_t seed,
+                                pcg128_t stream)
+{
+  state->inc = pcg128_odd(stream);
+  state->state = state->inc;
+  state->state = pcg128_add(state->state, seed);
+  state->state = pcg128_add(pcg128_mul(state->state, PCG_MULT_128),
+                            state->inc);
+}
+
+LIBRANDOM_API uint64_t lcg128 (lcg128_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_LCG128, RANDOM_STATS_SCALAR, 1);
+
+  state->state = pcg128_add(pcg128_mul(state->state, PCG_MULT_128),
+                            state->inc);
+
+  return pcg128_high(state->state);
+}
+
+LIBRANDOM_API void lcg128_fill (lcg128_state_t *state, uint64_t *out,
+                                size_t n)
+{
+  pcg128_t s = state->state;
+  const pcg128_t inc = state->inc;
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_LCG128, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+  {
+    s = pcg128_add(pcg128_mul(s, PCG_MULT_128), inc);
+    out[i] = pcg128_high(s);
+  }
+
+  state->state = s;
+}
+
+LIBRANDOM_API void lcg128_advance (lcg128_state_t *state, pcg128_t delta)
+{
+  state->state = pcg128_advance(state->state, delta, PCG_MULT_128,
+                                state->inc);
+}
+
+#undef PCG_MULT_64
+#undef PCG_MULT_128
+#undef PCG_CHEAP_MULT_128
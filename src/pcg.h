@@ -0,0 +1,162 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Permuted congruential generators (PCG) of O'Neill, and the underlying
+ * linear congruential generators.
+ *
+ * A linear congruential generator (LCG) x_{n+1} = a x_n + c mod 2^k has full
+ * period 2^k for suitable a and any odd c, but its low bits have short
+ * periods and its outputs fall on few hyperplanes. PCG generators output a
+ * permutation of the state, a function of its high bits chosen to hide these
+ * defects, which makes even a small state pass demanding statistical tests.
+ *
+ * The generators here are:
+ *
+ *  - pcg32: 64-bit state, 32-bit output by the XSH-RR permutation, as
+ *    pcg32_random_r() of the reference pcg-c library;
+ *  - pcg64: 128-bit state, 64-bit output by the XSL-RR permutation, as
+ *    pcg64_random_r() of pcg-c and PCG64 of NumPy;
+ *  - pcg64_dxsm: 128-bit state with the 64-bit "cheap" multiplier and
+ *    64-bit output by the DXSM permutation, as PCG64DXSM of NumPy and
+ *    pcg_engines::cm_setseq_dxsm_128_64 of pcg-cpp;
+ *  - lcg128: the plain 128-bit LCG of pcg64, output its high 64 bits.
+ *
+ * The increment c selects one of 2^63 (pcg32) or 2^127 (the others)
+ * distinct streams, each of period 2^64 or 2^128. Every generator can be
+ * advanced by any number of steps in time logarithmic in the number of
+ * steps, by composing the affine map of the LCG with itself (Brown, 1994).
+ *
+ * The 128-bit generators use the unsigned __int128 type of GCC and Clang
+ * where available, and otherwise a portable pair of 64-bit words; the
+ * results are the same. pcg128_t values are formed with PCG128(high, low).
+ *
+ * See:
+ *  - O'Neill, M E, *PCG: A Family of Simple Fast Space-Efficient
+ *    Statistically Good Algorithms for Random Number Generation*, Harvey
+ *    Mudd College Technical Report HMC-CS-2014-0905 (2014),
+ *    <http://www.pcg-random.org/>.
+ *  - Brown, F, *Random Number Generation with Arbitrary Stride*,
+ *    Transactions of the American Nuclear Society **71**, 202-3 (1994).
+ */
+
+#ifndef PCG_H_
+#define PCG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* State type for the pcg32 generator. inc must be odd. */
+typedef struct {
+  uint64_t state, inc;
+} pcg32_state_t;
+
+/* Initialise state from seed on stream, as pcg32_srandom_r(). */
+LIBRANDOM_API void init_pcg32 (pcg32_state_t *state, uint64_t seed,
+                               uint64_t stream);
+
+/* Return a 32-bit integer drawn from the uniform distribution on
+ * [0, 2^32 - 1]. */
+LIBRANDOM_API uint32_t pcg32 (pcg32_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of pcg32(state). */
+LIBRANDOM_API void pcg32_fill (pcg32_state_t *state, uint32_t *out,
+                               size_t n);
+
+/* Advance state by delta steps, as if by delta calls of pcg32(state).
+ * Since the period is 2^64, delta = 2^64 - k steps back by k. */
+LIBRANDOM_API void pcg32_advance (pcg32_state_t *state, uint64_t delta);
+
+/* Unsigned 128-bit integers. */
+#if defined(__SIZEOF_INT128__) && !defined(LIBRANDOM_NO_INT128)
+#  define PCG_HAS_UINT128
+typedef unsigned __int128 pcg128_t;
+#  define PCG128(high, low) \
+     ((((pcg128_t) (uint64_t) (high)) << 64) | (uint64_t) (low))
+#else
+/* The words are in the order of unsigned __int128 on little-endian
+ * machines. */
+typedef struct {
+  uint64_t low, high;
+} pcg128_t;
+#  define PCG128(high, low) ((pcg128_t) { (uint64_t) (low), (uint64_t) (high) })
+#endif
+
+/* State type for the pcg64 generator. inc must be odd. */
+typedef struct {
+  pcg128_t state, inc;
+} pcg64_state_t;
+
+/* Initialise state from seed on stream, as pcg64_srandom_r(). */
+LIBRANDOM_API void init_pcg64 (pcg64_state_t *state, pcg128_t seed,
+                               pcg128_t stream);
+
+/* Return a 64-bit integer drawn from the uniform distribution on
+ * [0, 2^64 - 1]. */
+LIBRANDOM_API uint64_t pcg64 (pcg64_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of pcg64(state). */
+LIBRANDOM_API void pcg64_fill (pcg64_state_t *state, uint64_t *out,
+                               size_t n);
+
+/* Advance state by delta steps, modulo the period 2^128. */
+LIBRANDOM_API void pcg64_advance (pcg64_state_t *state, pcg128_t delta);
+
+/* State type for the pcg64_dxsm generator. inc must be odd. */
+typedef struct {
+  pcg128_t state, inc;
+} pcg64_dxsm_state_t;
+
+/* Initialise state from seed on stream, as the seeding of PCG64DXSM. */
+LIBRANDOM_API void init_pcg64_dxsm (pcg64_dxsm_state_t *state, pcg128_t seed,
+                                    pcg128_t stream);
+
+/* Return a 64-bit integer drawn from the uniform distribution on
+ * [0, 2^64 - 1]. */
+LIBRANDOM_API uint64_t pcg64_dxsm (pcg64_dxsm_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of pcg64_dxsm(state). */
+LIBRANDOM_API void pcg64_dxsm_fill (pcg64_dxsm_state_t *state, uint64_t *out,
+                                    size_t n);
+
+/* Advance state by delta steps, modulo the period 2^128. */
+LIBRANDOM_API void pcg64_dxsm_advance (pcg64_dxsm_state_t *state,
+                                       pcg128_t delta);
+
+/* State type for the lcg128 generator. inc must be odd. */
+typedef struct {
+  pcg128_t state, inc;
+} lcg128_state_t;
+
+/* Initialise state from seed on stream, as init_pcg64(). */
+LIBRANDOM_API void init_lcg128 (lcg128_state_t *state, pcg128_t seed,
+                                pcg128_t stream);
+
+/* Return the high 64 bits of the next state. Only the high bits of an LCG
+ * are of good quality, and not good enough for demanding uses: prefer
+ * pcg64_dxsm(). */
+LIBRANDOM_API uint64_t lcg128 (lcg128_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of lcg128(state). */
+LIBRANDOM_API void lcg128_fill (lcg128_state_t *state, uint64_t *out,
+                                size_t n);
+
+/* Advance state by delta steps, modulo the period 2^128. */
+LIBRANDOM_API void lcg128_advance (lcg128_state_t *state, pcg128_t delta);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#ifdef LIBRANDOM_INLINE
+#include "pcg.c"
+#endif /* ifdef LIBRANDOM_INLINE */
+
+#endif /* PCG_H_ */
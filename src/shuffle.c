@@ -0,0 +1,595 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Random permutations and sampling without replacement. */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shuffle.h"
+#include "stats.h"
+
+/* Number of 64-bit words drawn at a time by the shuffles. */
+#define BUFFER_WORDS 256
+
+/* Number of buckets of each step of the blocked shuffle. */
+#define BUCKETS 256
+
+/* Source of 64-bit words drawn from a generator, capacity words at a time. */
+typedef struct {
+  random_t *rng;
+  size_t next, capacity;
+  uint64_t buffer[BUFFER_WORDS];
+} source_t;
+
+static void source_init (source_t *source, random_t *rng, size_t capacity)
+{
+  source->rng = rng;
+  source->next = source->capacity = capacity;
+}
+
+static inline uint64_t source_next (source_t *source)
+{
+  if (source->next == source->capacity)
+  {
+    random_fill64_distribution(source->rng, source->buffer,
+                               source->capacity);
+    source->next = 0;
+  }
+
+  return source->buffer[source->next++];
+}
+
+/* Return a double drawn from the uniform distribution on (0, 1). */
+static inline double source_open (source_t *source)
+{
+  return ((double) (source_next(source) >> 11) + 0.5) * 0x1p-53;
+}
+
+/* Return the high 64 bits of the 128-bit product a b, and store the low 64
+ * bits in *low. */
+static inline uint64_t mul128 (uint64_t a, uint64_t b, uint64_t *low)
+{
+#if defined(__SIZEOF_INT128__) && !defined(LIBRANDOM_NO_INT128)
+  const unsigned __int128 p = (unsigned __int128) a * b;
+
+  *low = (uint64_t) p;
+
+  return (uint64_t) (p >> 64);
+#else
+  const uint64_t a0 = a & UINT64_C(0xffffffff), a1 = a >> 32;
+  const uint64_t b0 = b & UINT64_C(0xffffffff), b1 = b >> 32;
+  const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0;
+  const uint64_t mid = (p00 >> 32) + (p01 & UINT64_C(0xffffffff))
+                     + (p10 & UINT64_C(0xffffffff));
+
+  *low = a * b;
+
+  return a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+/* Return an integer drawn from the uniform distribution on [0, bound), for
+ * bound > 0. The high word of x bound is uniform on [0, bound) unless the low
+ * word falls below 2^64 mod bound, which only needs computing if the low
+ * word is below bound. */
+static uint64_t source_bounded (source_t *source, uint64_t bound)
+{
+  uint64_t low, high = mul128(source_next(source), bound, &low);
+
+  if (low < bound)
+  {
+    const uint64_t threshold = -bound % bound;
+
+    while (low < threshold)
+    {
+      RANDOM_STATS_REJECT(source->rng->id, 1);
+      high = mul128(source_next(source), bound, &low);
+    }
+  }
+
+  return high;
+}
+
+/* Store in out[0..k-1] integers drawn from the uniform distributions on
+ * [0, bound), [0, bound - 1), ..., [0, bound - k + 1), all from one word
+ * where possible. The product of the bounds must be less than 2^64.
+ *
+ * Each multiplication takes the next digit, in mixed radix, of the fraction
+ * x / 2^64 from its high word and leaves the remaining fraction in its low
+ * word. The remainder after all k is x p mod 2^64 for the product p of the
+ * bounds, and as for a single draw the digits are uniform unless it falls
+ * below 2^64 mod p. */
+static void source_bounded_batch (source_t *source, uint64_t bound,
+                                  unsigned k, uint64_t *out)
+{
+  for (;;)
+  {
+    uint64_t x = source_next(source), product = 1;
+    unsigned t;
+
+    for (t = 0; t < k; t++)
+    {
+      out[t] = mul128(x, bound - t, &x);
+      product *= bound - t;
+    }
+
+    if (x >= product || x >= -product % product)
+      return;
+
+    RANDOM_STATS_REJECT(source->rng->id, 1);
+  }
+}
+
+/* Largest number of successive bounds, from bound down, whose product is
+ * less than 2^64. */
+static unsigned batch_size (uint64_t bound)
+{
+  if (bound <= UINT64_C(1) << 10)
+    return 6;
+  if (bound <= UINT64_C(1) << 12)
+    return 5;
+  if (bound <= UINT64_C(1) << 16)
+    return 4;
+  if (bound <= UINT64_C(1) << 21)
+    return 3;
+  if (bound <= UINT64_C(1) << 32)
+    return 2;
+  return 1;
+}
+
+/* Element access for any size, with the common sizes of index arrays made
+ * cheap. */
+
+static inline void copy_element (unsigned char *dst, const unsigned char *src,
+                                 size_t size)
+{
+  if (size == 8)
+    memcpy(dst, src, 8);
+  else if (size == 4)
+    memcpy(dst, src, 4);
+  else
+    memcpy(dst, src, size);
+}
+
+static inline void swap_elements (unsigned char *a, unsigned char *b,
+                                  size_t size)
+{
+  if (size == 8)
+  {
+    uint64_t t;
+
+    memcpy(&t, a, 8);
+    memcpy(a, b, 8);
+    memcpy(b, &t, 8);
+  }
+  else if (size == 4)
+  {
+    uint32_t t;
+
+    memcpy(&t, a, 4);
+    memcpy(a, b, 4);
+    memcpy(b, &t, 4);
+  }
+  else
+  {
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+      unsigned char t = a[i];
+
+      a[i] = b[i];
+      b[i] = t;
+    }
+  }
+}
+
+/* Fisher-Yates: for i = n - 1 down to 1, swap element i with one drawn from
+ * [0, i]. */
+static void fisher_yates (source_t *source, unsigned char *base, size_t n,
+                          size_t size)
+{
+  uint64_t j[6];
+  size_t i = n;
+
+  while (i > 1)
+  {
+    unsigned k = batch_size(i), t;
+
+    if (k > i - 1)
+      k = (unsigned) (i - 1);
+
+    source_bounded_batch(source, i, k, j);
+    for (t = 0; t < k; t++)
+      swap_elements(base + (i - 1 - t) * size, base + j[t] * size, size);
+
+    i -= k;
+  }
+}
+
+/* Shuffle data[0..n-1], using scratch[0..n-1]. The labels are drawn twice,
+ * once to size the buckets and once to scatter the elements, from the same
+ * state of the source, to avoid storing them. A single element ends the
+ * recursion even if it is larger than RANDOM_SHUFFLE_BLOCK. */
+static void blocked (source_t *source, unsigned char *data,
+                     unsigned char *scratch, size_t n, size_t size)
+{
+  size_t count[BUCKETS] = { 0 }, offset[BUCKETS], start, i;
+  random_t saved_rng;
+  source_t saved;
+  uint64_t word = 0;
+  unsigned b;
+
+  if (n <= 1 || n * size <= RANDOM_SHUFFLE_BLOCK)
+  {
+    fisher_yates(source, data, n, size);
+    return;
+  }
+
+  saved_rng = *source->rng;
+  saved = *source;
+
+  for (i = 0; i < n; i++)
+  {
+    if (i % 8 == 0)
+      word = source_next(source);
+    count[word & (BUCKETS - 1)]++;
+    word >>= 8;
+  }
+
+  for (b = 0, start = 0; b < BUCKETS; b++)
+  {
+    offset[b] = start;
+    start += count[b];
+  }
+
+  *source->rng = saved_rng;
+  *source = saved;
+
+  for (i = 0; i < n; i++)
+  {
+    if (i % 8 == 0)
+      word = source_next(source);
+    b = word & (BUCKETS - 1);
+    copy_element(scratch + offset[b]++ * size, data + i * size, size);
+    word >>= 8;
+  }
+
+  memcpy(data, scratch, n * size);
+
+  for (b = 0, start = 0; b < BUCKETS; b++)
+  {
+    blocked(source, data + start * size, scratch + start * size, count[b],
+            size);
+    start += count[b];
+  }
+}
+
+void random_shuffle (random_t *rng, void *base, size_t n, size_t size)
+{
+  source_t source;
+
+  source_init(&source, rng, BUFFER_WORDS);
+  fisher_yates(&source, base, n, size);
+}
+
+int random_shuffle_blocked (random_t *rng, void *base, size_t n, size_t size)
+{
+  unsigned char *scratch = NULL;
+  source_t source;
+
+  if (size != 0 && n > SIZE_MAX / size)
+    return -1;
+
+  if (n * size > RANDOM_SHUFFLE_BLOCK)
+  {
+    scratch = malloc(n * size);
+    if (scratch == NULL)
+      return -1;
+  }
+
+  source_init(&source, rng, BUFFER_WORDS);
+  blocked(&source, base, scratch, n, size);
+
+  free(scratch);
+
+  return 0;
+}
+
+/* random_shuffle_parallel() */
+
+typedef struct {
+  const random_config_t *config;
+  unsigned char *base, *scratch;
+  size_t n, size;
+  size_t nbuckets;
+  size_t *offsets;     /* nchunks rows of nbuckets: element counts, then
+                        * offsets into scratch. */
+  size_t *starts;      /* nbuckets + 1 offsets of the buckets. */
+} shuffle_t;
+
+static void label_init (random_t *rng, const shuffle_t *shuffle,
+                        uint64_t phase, size_t index)
+{
+  uint64_t key[4];
+
+  key[0] = shuffle->config->seed;
+  key[1] = shuffle->config->stream;
+  key[2] = phase;
+  key[3] = index;
+
+  random_init_by_key(rng, shuffle->config->id, key, 4);
+}
+
+static void count_chunk (void *arg, size_t chunk)
+{
+  shuffle_t *shuffle = arg;
+  size_t *count = shuffle->offsets + chunk * shuffle->nbuckets;
+  size_t begin = chunk * RANDOM_SHUFFLE_CHUNK, end = shuffle->n, i;
+  source_t source;
+  random_t rng;
+
+  if (end - begin > RANDOM_SHUFFLE_CHUNK)
+    end = begin + RANDOM_SHUFFLE_CHUNK;
+
+  label_init(&rng, shuffle, 0, chunk);
+  source_init(&source, &rng, BUFFER_WORDS);
+
+  for (i = begin; i < end; i++)
+    count[source_bounded(&source, shuffle->nbuckets)]++;
+}
+
+static void scatter_chunk (void *arg, size_t chunk)
+{
+  shuffle_t *shuffle = arg;
+  size_t *offset = shuffle->offsets + chunk * shuffle->nbuckets;
+  size_t begin = chunk * RANDOM_SHUFFLE_CHUNK, end = shuffle->n, i;
+  const size_t size = shuffle->size;
+  source_t source;
+  random_t rng;
+
+  if (end - begin > RANDOM_SHUFFLE_CHUNK)
+    end = begin + RANDOM_SHUFFLE_CHUNK;
+
+  label_init(&rng, shuffle, 0, chunk);
+  source_init(&source, &rng, BUFFER_WORDS);
+
+  for (i = begin; i < end; i++)
+  {
+    const uint64_t b = source_bounded(&source, shuffle->nbuckets);
+
+    copy_element(shuffle->scratch + offset[b]++ * size,
+                 shuffle->base + i * size, size);
+  }
+}
+
+static void shuffle_bucket (void *arg, size_t bucket)
+{
+  shuffle_t *shuffle = arg;
+  const size_t begin = shuffle->starts[bucket] * shuffle->size;
+  const size_t count = shuffle->starts[bucket + 1] - shuffle->starts[bucket];
+  source_t source;
+  random_t rng;
+
+  label_init(&rng, shuffle, 1, bucket);
+  source_init(&source, &rng, BUFFER_WORDS);
+
+  memcpy(shuffle->base + begin, shuffle->scratch + begin,
+         count * shuffle->size);
+  blocked(&source, shuffle->base + begin, shuffle->scratch + begin, count,
+          shuffle->size);
+}
+
+int random_shuffle_parallel (const random_config_t *config, void *base,
+                             size_t n, size_t size, unsigned nthreads)
+{
+  const size_t nchunks = (n + RANDOM_SHUFFLE_CHUNK - 1) / RANDOM_SHUFFLE_CHUNK;
+  shuffle_t shuffle;
+  size_t b, c, start;
+
+  if (random_generator_info(config->id) == NULL)
+    return -1;
+  if (size != 0 && n > SIZE_MAX / size)
+    return -1;
+
+  shuffle.config = config;
+  shuffle.base = base;
+  shuffle.n = n;
+  shuffle.size = size;
+  shuffle.nbuckets = nchunks > 0 ? nchunks : 1;
+  shuffle.scratch = malloc(n * size > 0 ? n * size : 1);
+  shuffle.offsets = calloc(nchunks * shuffle.nbuckets + 1, sizeof(size_t));
+  shuffle.starts = malloc((shuffle.nbuckets + 1) * sizeof(size_t));
+
+  if (!shuffle.scratch || !shuffle.offsets || !shuffle.starts)
+  {
+    free(shuffle.scratch);
+    free(shuffle.offsets);
+    free(shuffle.starts);
+    return -1;
+  }
+
+  if (shuffle.nbuckets == 1)
+  {
+    /* Every label is zero: all elements are in the one bucket, in order. */
+    shuffle.starts[0] = 0;
+    shuffle.starts[1] = n;
+    memcpy(shuffle.scratch, base, n * size);
+  }
+  else
+  {
+    random_parallel_for(nchunks, nthreads, count_chunk, &shuffle);
+
+    /* The elements of bucket b from chunk c follow those from earlier
+     * chunks, after every element of earlier buckets. */
+    for (b = 0, start = 0; b < shuffle.nbuckets; b++)
+    {
+      shuffle.starts[b] = start;
+      for (c = 0; c < nchunks; c++)
+      {
+        const size_t count = shuffle.offsets[c * shuffle.nbuckets + b];
+
+        shuffle.offsets[c * shuffle.nbuckets + b] = start;
+        start += count;
+      }
+    }
+    shuffle.starts[shuffle.nbuckets] = start;
+
+    random_parallel_for(nchunks, nthreads, scatter_chunk, &shuffle);
+  }
+
+  random_parallel_for(shuffle.nbuckets, nthreads, shuffle_bucket, &shuffle);
+
+  free(shuffle.scratch);
+  free(shuffle.offsets);
+  free(shuffle.starts);
+
+  return 0;
+}
+
+/* random_sample() */
+
+/* Open-addressed hash set of integers less than UINT64_MAX. */
+#define EMPTY UINT64_MAX
+
+/* Insert x into set[0..mask], returning zero if it was already present. */
+static int insert (uint64_t *set, size_t mask, uint64_t x)
+{
+  size_t i = (size_t) ((x * UINT64_C(0x9e3779b97f4a7c15)) >> 32) & mask;
+
+  while (set[i] != EMPTY)
+  {
+    if (set[i] == x)
+      return 0;
+    i = (i + 1) & mask;
+  }
+
+  set[i] = x;
+
+  return 1;
+}
+
+int random_sample (random_t *rng, uint64_t n, size_t k, uint64_t *out)
+{
+  uint64_t *set, j;
+  size_t capacity = 1, m = 0;
+  source_t source;
+
+  if (k > n)
+    return -1;
+  if (k == 0)
+    return 0;
+
+  /* At most half full. */
+  while (capacity < 2 * k)
+    capacity *= 2;
+
+  set = malloc(capacity * sizeof(uint64_t));
+  if (set == NULL)
+    return -1;
+  memset(set, 0xff, capacity * sizeof(uint64_t));
+
+  /* For j = n - k, ..., n - 1, add a draw t from [0, j], or j itself if t
+   * is already in the sample. */
+  source_init(&source, rng, 1);
+  for (j = n - k; j < n; j++)
+  {
+    const uint64_t t = source_bounded(&source, j + 1);
+
+    /* j is greater than every earlier member, so is never present. */
+    if (insert(set, capacity - 1, t))
+    {
+      out[m++] = t;
+    }
+    else
+    {
+      insert(set, capacity - 1, j);
+      out[m++] = j;
+    }
+  }
+
+  free(set);
+
+  return 0;
+}
+
+#undef EMPTY
+
+/* Reservoir sampling by Algorithm L. With w the largest of k uniform
+ * deviates (raised to the power 1 / k), the number of elements skipped
+ * before the next to enter is geometric with parameter w. */
+
+/* Return the number of elements to skip. */
+static uint64_t reservoir_skip (source_t *source, double w)
+{
+  const double skip = floor(log(source_open(source)) / log1p(-w));
+
+  /* Saturate, for a stream too long to reach the next element. */
+  return skip < 0x1p63 ? (uint64_t) skip : UINT64_C(1) << 63;
+}
+
+void random_reservoir_init (random_reservoir_t *reservoir, random_t *rng,
+                            void *items, size_t k, size_t size)
+{
+  source_t source;
+
+  reservoir->rng = rng;
+  reservoir->items = items;
+  reservoir->k = k;
+  reservoir->size = size;
+  reservoir->seen = 0;
+  reservoir->next = UINT64_MAX;
+  reservoir->w = 0;
+
+  if (k > 0)
+  {
+    source_init(&source, rng, 1);
+    reservoir->w = exp(log(source_open(&source)) / (double) k);
+    reservoir->next = k + reservoir_skip(&source, reservoir->w);
+  }
+}
+
+void random_reservoir_add (random_reservoir_t *reservoir, const void *items,
+                           size_t n)
+{
+  const unsigned char *src = items;
+  const uint64_t first = reservoir->seen, end = first + n;
+  const size_t k = reservoir->k, size = reservoir->size;
+  source_t source;
+  uint64_t skip;
+
+  /* The first k elements fill the reservoir. */
+  for (; reservoir->seen < k && reservoir->seen < end; reservoir->seen++)
+  {
+    copy_element(reservoir->items + reservoir->seen * size,
+                 src + (reservoir->seen - first) * size, size);
+  }
+
+  source_init(&source, reservoir->rng, 1);
+  while (reservoir->next < end)
+  {
+    const uint64_t i = source_bounded(&source, k);
+
+    copy_element(reservoir->items + i * size,
+                 src + (reservoir->next - first) * size, size);
+    reservoir->w *= exp(log(source_open(&source)) / (double) k);
+    skip = reservoir_skip(&source, reservoir->w);
+    reservoir->next = skip < UINT64_MAX - reservoir->next
+                    ? reservoir->next + 1 + skip : UINT64_MAX;
+  }
+
+  reservoir->seen = end;
+}
+
+size_t random_reservoir_count (const random_reservoir_t *reservoir)
+{
+  return reservoir->seen < reservoir->k ? (size_t) reservoir->seen
+                                        : reservoir->k;
+}
+
+#undef BUFFER_WORDS
+#undef BUCKETS
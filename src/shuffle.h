@@ -0,0 +1,140 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Random permutations and sampling without replacement, drawing from any of
+ * the generators of generator.h.
+ *
+ * Bounded integers are drawn by Lemire's multiply-and-shift method, which
+ * needs a division only to decide the rare rejections, and the Fisher-Yates
+ * shuffle draws several of them at once from a single 64-bit word, as long
+ * as the product of their bounds fits in 64 bits (Brackett-Rozinsky and
+ * Lemire). Generators with 32-bit output supply each 64-bit word from two
+ * successive outputs, the first in the high half.
+ *
+ * The shuffles draw their words a block at a time with random_fill() and
+ * discard any left over at the end, so a shuffle advances its generator by
+ * a whole number of blocks. The samplers draw single words.
+ *
+ * Fisher-Yates swaps each element with one at a random position, which for
+ * arrays much larger than the last level cache costs a cache (and often
+ * TLB) miss per element. random_shuffle_blocked() instead follows Rao and
+ * Sandelius: it scatters the elements into 256 buckets by random labels, in
+ * 256 sequential streams, and shuffles each bucket in turn, recursively
+ * until the buckets fit in RANDOM_SHUFFLE_BLOCK bytes or hold at most one
+ * element. The permutation is again uniform, but not the same as that of
+ * random_shuffle().
+ * random_shuffle_parallel() distributes the same algorithm over threads,
+ * with a generator per chunk as in parallel.h, so that the permutation does
+ * not depend on the number of threads.
+ *
+ * Rejected draws are counted by the instrumentation of stats.h, and every
+ * word drawn as an output of the distribution API.
+ *
+ * See:
+ *  - Lemire, D, *Fast Random Integer Generation in an Interval*, ACM
+ *    Transactions on Modeling and Computer Simulation **29**, 3:1-12 (2019).
+ *  - Brackett-Rozinsky, N and Lemire, D, *Batched Ranged Random Integer
+ *    Generation*, Software: Practice and Experience **55**, 155-69 (2025).
+ *  - Sandelius, M, *A Simple Randomization Procedure*, Journal of the Royal
+ *    Statistical Society B **24**, 472-81 (1962).
+ *  - Li, K-H, *Reservoir-Sampling Algorithms of Time Complexity
+ *    O(n(1 + log(N/n)))*, ACM Transactions on Mathematical Software **20**,
+ *    481-93 (1994).
+ *  - Bentley, J and Floyd, R, *Programming Pearls: A Sample of Brilliance*,
+ *    Communications of the ACM **30**, 754-7 (1987).
+ */
+
+#ifndef SHUFFLE_H_
+#define SHUFFLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "generator.h"
+#include "parallel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Size in bytes of the largest array random_shuffle_blocked() shuffles by
+ * Fisher-Yates, chosen to fit in the level 2 cache. Part of the definition
+ * of the permutations of random_shuffle_blocked() and
+ * random_shuffle_parallel() and so **must not** change. */
+#define RANDOM_SHUFFLE_BLOCK 262144
+
+/* Number of elements labelled by each generator of
+ * random_shuffle_parallel(). Part of the definition of its permutations and
+ * so **must not** change. */
+#define RANDOM_SHUFFLE_CHUNK 1048576
+
+/* Shuffle the n elements of size bytes at base in place, by Fisher-Yates,
+ * so that each of the n! permutations is equally likely. */
+void random_shuffle (random_t *rng, void *base, size_t n, size_t size);
+
+/* Shuffle as random_shuffle(), but by the cache-friendly blocked algorithm
+ * described above, using a temporary array the size of the input. Returns
+ * zero on success, or -1, leaving the array unchanged, if the memory could
+ * not be allocated. */
+int random_shuffle_blocked (random_t *rng, void *base, size_t n, size_t size);
+
+/* Shuffle using nthreads threads, or one per online processor if nthreads is
+ * zero, with generators initialised from config. Element i is labelled
+ * with the generator keyed (seed, stream, 0, i / RANDOM_SHUFFLE_CHUNK), and
+ * bucket b shuffled by random_shuffle_blocked() with that keyed
+ * (seed, stream, 1, b), where there are as many buckets as chunks.
+ *
+ * Returns zero on success, or -1, leaving the array unchanged, if config->id
+ * is not valid or the memory could not be allocated. */
+int random_shuffle_parallel (const random_config_t *config, void *base,
+                             size_t n, size_t size, unsigned nthreads);
+
+/* Store in out[0..k-1] k distinct integers drawn uniformly from [0, n), by
+ * Floyd's algorithm, in time and space proportional to k. The sample is in
+ * no particular order: shuffle it if a random order is needed. Suited to k
+ * much smaller than n; otherwise, shuffle the integers [0, n) and take the
+ * first k.
+ *
+ * Returns zero on success, or -1 if k > n or the memory could not be
+ * allocated. */
+int random_sample (random_t *rng, uint64_t n, size_t k, uint64_t *out);
+
+/* Reservoir sample of k elements from a stream of unknown length. */
+typedef struct {
+  random_t *rng;
+  unsigned char *items; /* Reservoir of k elements of size bytes. */
+  size_t k, size;
+  uint64_t seen;        /* Number of elements offered so far. */
+  uint64_t next;        /* Index of the next element to enter. */
+  double w;
+} random_reservoir_t;
+
+/* Start a reservoir sample of k elements of size bytes into items, drawing
+ * from rng, which must outlive the reservoir. */
+void random_reservoir_init (random_reservoir_t *reservoir, random_t *rng,
+                            void *items, size_t k, size_t size);
+
+/* Offer the next n elements of the stream, at items, to the reservoir. Once
+ * at least k elements have been offered the reservoir holds a uniform
+ * sample of k of them; before then it holds every element offered, in
+ * order.
+ *
+ * Rather than drawing for every element, Algorithm L draws the number of
+ * elements to skip before the next to enter, so the time taken is
+ * proportional to k (1 + log(N / k)) for a stream of N elements, and
+ * elements that are skipped are not read. The sample does not depend on how
+ * the stream is divided between calls. */
+void random_reservoir_add (random_reservoir_t *reservoir, const void *items,
+                           size_t n);
+
+/* Return the number of elements in the reservoir: the smaller of k and the
+ * number offered. */
+size_t random_reservoir_count (const random_reservoir_t *reservoir);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* SHUFFLE_H_ */
@@ -0,0 +1,60 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Run time selection of the instruction set of the sampling loops. */
+
+#include "simd.h"
+
+#if defined(__GNUC__)
+#  define LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#  define STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+#else
+#  define LOAD(x) (x)
+#  define STORE(x, v) ((x) = (v))
+#endif
+
+/* Selected instruction set plus one, or zero until it is next needed. Racing
+ * threads store the same value. */
+static int level;
+
+/* Widest instruction set allowed by random_simd_limit(). */
+static int limit = RANDOM_SIMD_AVX512;
+
+static int detect (void)
+{
+#ifdef RANDOM_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+    return RANDOM_SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return RANDOM_SIMD_AVX2;
+#endif
+
+  return RANDOM_SIMD_GENERIC;
+}
+
+random_simd_t random_simd_level (void)
+{
+  int l = LOAD(level);
+
+  if (l == 0)
+  {
+    const int d = detect(), max = LOAD(limit);
+
+    l = 1 + (d < max ? d : max);
+    STORE(level, l);
+  }
+
+  return (random_simd_t) (l - 1);
+}
+
+void random_simd_limit (random_simd_t max)
+{
+  STORE(limit, (int) max);
+  STORE(level, 0);
+}
+
+#undef LOAD
+#undef STORE
@@ -0,0 +1,302 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Vectorisable elementary functions for the samplers of continuous
+ * distributions, and run time selection of their instruction set.
+ *
+ * The samplers transform blocks of uniform words in loops free of branches
+ * and library calls, using the approximations below, which are written in
+ * plain C so that the compiler vectorises them. Each loop is compiled for
+ * AVX-512, for AVX2 and for the baseline instruction set, and the widest the
+ * processor supports is chosen at run time with __builtin_cpu_supports().
+ * Every operation is a correctly rounded IEEE operation, and the library is
+ * compiled without contraction into fused multiply-adds, so every version
+ * gives bit-identical results: the instruction set affects only speed, and
+ * samples are reproducible across machines. With other compilers or
+ * architectures, or with LIBRANDOM_NO_SIMD defined, only the baseline loop
+ * is built.
+ *
+ * The approximations are those of fdlibm, restricted to the arguments the
+ * samplers need and with the special cases removed. Against correctly
+ * rounded results:
+ *
+ *  - random_simd_log(x) is within 1 ulp for positive normal x;
+ *  - random_simd_sincos2pi(u) returns sin(2 pi u) and cos(2 pi u) within
+ *    2 ulp for u in [0, 1). The reduction of the argument is exact, so that
+ *    the error is relative even near the zeros, unlike sin(2 * M_PI * u);
+ *  - random_simd_exp(x) is within 1 ulp, overflowing to infinity and
+ *    underflowing through the subnormals to zero;
+ *  - random_simd_pow(x, y), for positive normal x, is exp(y log(x)), whose
+ *    relative error grows with |y log(x)|: the error of log(x) is scaled by
+ *    y, to within (2 |y log(x)| + 2) ulp;
+ *  - random_simd_acos(x) is within 1 ulp for x in [-1, 1].
+ *
+ * The routines other than random_simd_level() and random_simd_limit() are
+ * internal to librandom.
+ */
+
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Instruction sets of the sampling loops. */
+typedef enum {
+  RANDOM_SIMD_GENERIC = 0,
+  RANDOM_SIMD_AVX2 = 1,
+  RANDOM_SIMD_AVX512 = 2
+} random_simd_t;
+
+/* Return the instruction set used by the sampling loops: the widest
+ * supported by the processor, unless restricted by random_simd_limit(). */
+random_simd_t random_simd_level (void);
+
+/* Use no instruction set wider than level, e.g. to compare or time the
+ * versions of the sampling loops. */
+void random_simd_limit (random_simd_t level);
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && !defined(LIBRANDOM_NO_SIMD)
+#  define RANDOM_SIMD_X86
+#endif
+
+#if defined(__GNUC__)
+#  define RANDOM_SIMD_INLINE static inline __attribute__((always_inline))
+#else
+#  define RANDOM_SIMD_INLINE static inline
+#endif
+
+/* Define static functions name_generic(params) and, on x86, name_avx2 and
+ * name_avx512, each evaluating call compiled for its instruction set; call
+ * is typically a RANDOM_SIMD_INLINE kernel, which is then inlined into and
+ * vectorised for each. */
+#ifdef RANDOM_SIMD_X86
+#  define RANDOM_SIMD_CLONES(name, params, call) \
+     static void name##_generic params { call; } \
+     __attribute__((target("avx2"))) \
+     static void name##_avx2 params { call; } \
+     __attribute__((target("avx512f,avx512dq"))) \
+     static void name##_avx512 params { call; }
+#  define RANDOM_SIMD_DISPATCH(name, args) \
+     do { \
+       switch (random_simd_level()) \
+       { \
+         case RANDOM_SIMD_AVX512: name##_avx512 args; break; \
+         case RANDOM_SIMD_AVX2: name##_avx2 args; break; \
+         default: name##_generic args; break; \
+       } \
+     } while (0)
+#else
+#  define RANDOM_SIMD_CLONES(name, params, call) \
+     static void name##_generic params { call; }
+#  define RANDOM_SIMD_DISPATCH(name, args) name##_generic args
+#endif
+
+RANDOM_SIMD_INLINE uint64_t random_simd_bits (double x)
+{
+  uint64_t bits;
+
+  memcpy(&bits, &x, sizeof(bits));
+
+  return bits;
+}
+
+RANDOM_SIMD_INLINE double random_simd_double (uint64_t bits)
+{
+  double x;
+
+  memcpy(&x, &bits, sizeof(x));
+
+  return x;
+}
+
+/* Return the double in [1, 2) with the top 52 bits of w as its mantissa. */
+RANDOM_SIMD_INLINE double random_simd_one_two (uint64_t w)
+{
+  return random_simd_double((w >> 12) | UINT64_C(0x3ff0000000000000));
+}
+
+/* Map w to (m + 1/2) 2^-52, where m is its top 52 bits: uniform on the open
+ * interval (0, 1), and symmetric about 1/2. The subtraction is exact. */
+RANDOM_SIMD_INLINE double random_simd_open (uint64_t w)
+{
+  return random_simd_one_two(w) - (1 - 0x1p-53);
+}
+
+/* Map w to m 2^-52: uniform on [0, 1). */
+RANDOM_SIMD_INLINE double random_simd_unit (uint64_t w)
+{
+  return random_simd_one_two(w) - 1;
+}
+
+/* Return the integer k, |k| < 2^51, represented by the bits of x + 0x1.8p52
+ * as a double. */
+RANDOM_SIMD_INLINE double random_simd_shifted (uint64_t bits)
+{
+  return random_simd_double(bits) - 0x1.8p52;
+}
+
+/* Natural logarithm of positive normal x. With x = 2^k z for z in
+ * [sqrt(2) / 2, sqrt(2)), log(z) = 2 atanh(s) for s = (z - 1) / (z + 1),
+ * approximated by a minimax polynomial in s^2. */
+RANDOM_SIMD_INLINE double random_simd_log (double x)
+{
+  const double ln2_hi = 6.93147180369123816490e-01;
+  const double ln2_lo = 1.90821492927058770002e-10;
+  const double lg1 = 6.666666666666735130e-01;
+  const double lg2 = 3.999999999940941908e-01;
+  const double lg3 = 2.857142874366239149e-01;
+  const double lg4 = 2.222219843214978396e-01;
+  const double lg5 = 1.818357216161805012e-01;
+  const double lg6 = 1.531383769920937332e-01;
+  const double lg7 = 1.479819860511658591e-01;
+  /* Offsetting by sqrt(2) / 2 puts the boundary of each exponent there. */
+  const uint64_t ix = random_simd_bits(x);
+  const uint64_t tmp = ix - UINT64_C(0x3fe6a09e667f3bcd);
+  const uint64_t iz = ix - (tmp & UINT64_C(0xfff0000000000000));
+  const double z = random_simd_double(iz);
+  /* k, biased by 0x400 to keep the shift logical, via the exponent trick. */
+  const uint64_t kb = (tmp + (UINT64_C(0x400) << 52)) >> 52;
+  const double k = random_simd_double(kb | UINT64_C(0x4330000000000000))
+                   - (0x1p52 + 0x400);
+  const double f = z - 1, hfsq = 0.5 * f * f, s = f / (2 + f);
+  const double z2 = s * s, w = z2 * z2;
+  const double t1 = w * (lg2 + w * (lg4 + w * lg6));
+  const double t2 = z2 * (lg1 + w * (lg3 + w * (lg5 + w * lg7)));
+
+  return s * (hfsq + t1 + t2) + k * ln2_lo - hfsq + f + k * ln2_hi;
+}
+
+/* Store sin(2 pi u) and cos(2 pi u) in *s and *c, for u in [0, 1). u is
+ * reduced exactly to r = u - q / 4 in [-1/8, 1/8], the sine and cosine of
+ * x = 2 pi r in [-pi/4, pi/4] found by minimax polynomials, and the results
+ * exchanged and negated according to the quadrant q. */
+RANDOM_SIMD_INLINE void random_simd_sincos2pi (double u, double *s,
+                                               double *c)
+{
+  const double s1 = -1.66666666666666324348e-01;
+  const double s2 = 8.33333333332248946124e-03;
+  const double s3 = -1.98412698298579493134e-04;
+  const double s4 = 2.75573137070700676789e-06;
+  const double s5 = -2.50507602534068634195e-08;
+  const double s6 = 1.58969099521155010221e-10;
+  const double c1 = 4.16666666666666019037e-02;
+  const double c2 = -1.38888888888741095749e-03;
+  const double c3 = 2.48015872894767294178e-05;
+  const double c4 = -2.75573143513906633035e-07;
+  const double c5 = 2.08757232129817482790e-09;
+  const double c6 = -1.13596475577881948265e-11;
+  const double two_pi = 6.28318530717958647692;
+  /* Round 4 u to the nearest integer q, whose low bits are those of t. */
+  const uint64_t t = random_simd_bits(4 * u + 0x1.8p52);
+  const double x = (u - 0.25 * random_simd_shifted(t)) * two_pi;
+  const double z = x * x, v = z * x, w = z * z, hz = 0.5 * z, one = 1 - hz;
+  const double sx = x + v * (s1 + z * (s2 + z * (s3 + z * (s4 + z * (s5
+                                                           + z * s6)))));
+  const double r = z * (c1 + z * (c2 + z * c3))
+                   + w * w * (c4 + z * (c5 + z * c6));
+  const double cx = one + (((1 - one) - hz) + z * r);
+  /* Odd quadrants exchange sine and cosine; the sine is negative in
+   * quadrants 2 and 3, and the cosine in 1 and 2. */
+  const uint64_t swap = -(t & 1);
+  const uint64_t bs = random_simd_bits(sx), bc = random_simd_bits(cx);
+  const uint64_t diff = (bs ^ bc) & swap;
+
+  *s = random_simd_double((bs ^ diff) ^ ((t & 2) << 62));
+  *c = random_simd_double((bc ^ diff) ^ (((t + 1) & 2) << 62));
+}
+
+/* Exponential of x. With x = k ln 2 + r for integer k and |r| <= ln 2 / 2,
+ * exp(r) is found by a minimax rational approximation, and scaled by 2^k in
+ * two steps, so that neither factor leaves the normal range and the result
+ * is rounded once. */
+RANDOM_SIMD_INLINE double random_simd_exp (double x)
+{
+  const double ln2_hi = 6.93147180369123816490e-01;
+  const double ln2_lo = 1.90821492927058770002e-10;
+  const double inv_ln2 = 1.44269504088896338700e+00;
+  const double p1 = 1.66666666666666019037e-01;
+  const double p2 = -2.77777777770155933842e-03;
+  const double p3 = 6.61375632143793436117e-05;
+  const double p4 = -1.65339022054652515390e-06;
+  const double p5 = 4.13813679705723846039e-08;
+  /* Beyond these the result is infinite or zero, and |k| <= 1077. */
+  const double y = x > 710 ? 710 : (x < -746 ? -746 : x);
+  /* Round y / ln 2 to the nearest integer k, whose low bits are those of
+   * t: k ln2_hi is exact. */
+  const uint64_t t = random_simd_bits(y * inv_ln2 + 0x1.8p52);
+  const double k = random_simd_shifted(t);
+  const double hi = y - k * ln2_hi, lo = k * ln2_lo, r = hi - lo;
+  const double z = r * r;
+  const double c = r - z * (p1 + z * (p2 + z * (p3 + z * (p4 + z * p5))));
+  const double e = 1 - ((lo - (r * c) / (2 - c)) - hi);
+  /* 2^k = 2^k1 2^k2 for k1 the nearest integer to k / 2: |k1|, |k2| < 540,
+   * and the multiplication by 2^k1 is exact. The low 12 bits of each word,
+   * the biased exponent, are those of k1 + 1023 and k2 + 1023. */
+  const double k1 = random_simd_shifted(random_simd_bits(0.5 * k + 0x1.8p52));
+  const double s1 = random_simd_double(
+    (random_simd_bits(k1 + 0x1.8p52) + 1023) << 52);
+  const double s2 = random_simd_double(
+    (random_simd_bits(k - k1 + 0x1.8p52) + 1023) << 52);
+
+  return e * s1 * s2;
+}
+
+/* x^y for positive normal x, as exp(y log(x)). */
+RANDOM_SIMD_INLINE double random_simd_pow (double x, double y)
+{
+  return random_simd_exp(y * random_simd_log(x));
+}
+
+/* Arc cosine of x in [-1, 1], in [0, pi]. For |x| < 1/2, acos(x) =
+ * pi / 2 - asin(x); otherwise acos(|x|) = 2 asin(sqrt(z)) for
+ * z = (1 - |x|) / 2. asin(s) = s + s R(s^2) for a minimax rational R, which
+ * is evaluated once, at x^2 or z as required, and the result selected. */
+RANDOM_SIMD_INLINE double random_simd_acos (double x)
+{
+  const double pi = 3.14159265358979311600e+00;
+  const double pio2_hi = 1.57079632679489655800e+00;
+  const double pio2_lo = 6.12323399573676603587e-17;
+  const double ps0 = 1.66666666666666657415e-01;
+  const double ps1 = -3.25565818622400915405e-01;
+  const double ps2 = 2.01212532134862925881e-01;
+  const double ps3 = -4.00555345006794114027e-02;
+  const double ps4 = 7.91534994289814532176e-04;
+  const double ps5 = 3.47933107596021167570e-05;
+  const double qs1 = -2.40339491173441421878e+00;
+  const double qs2 = 2.02094576023350569471e+00;
+  const double qs3 = -6.88283971605453293030e-01;
+  const double qs4 = 7.70381505559019352791e-02;
+  const double ax = x < 0 ? -x : x;
+  const int small = ax < 0.5;
+  const double z = small ? x * x : (1 - ax) * 0.5;
+  const double p = z * (ps0 + z * (ps1 + z * (ps2 + z * (ps3 + z * (ps4
+                                                          + z * ps5)))));
+  const double q = 1 + z * (qs1 + z * (qs2 + z * (qs3 + z * qs4)));
+  const double r = p / q;
+  const double s = sqrt(z);
+  /* For x > 1/2, s = df + c to about twice working precision, with df the
+   * top 21 bits of s; the denominator is 1 at x = 1, where s = 0. */
+  const double df = random_simd_double(random_simd_bits(s)
+                                       & UINT64_C(0xffffffff00000000));
+  const double c = (z - df * df) / (s + df + (s == 0));
+  const double near_zero = pio2_hi - (x - (pio2_lo - x * r));
+  const double negative = pi - 2 * (s + (r * s - pio2_lo));
+  const double positive = 2 * (df + (r * s + c));
+
+  return small ? near_zero : (x < 0 ? negative : positive);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* SIMD_H_ */
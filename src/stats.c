@@ -0,0 +1,238 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Optional instrumentation of the generators. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#  define HAVE_RDTSC
+#endif
+
+#include "generator.h"
+#include "stats.h"
+
+/* Every generator must have a row of counters. */
+typedef char stats_generators_check_t[
+  RANDOM_GENERATOR_COUNT <= RANDOM_STATS_GENERATORS ? 1 : -1];
+
+/* Counters of one thread, in a list of all live threads. */
+typedef struct block {
+  random_stats_t stats;
+  struct block *prev, *next;
+} block_t;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static block_t *blocks = NULL;
+static random_stats_t retired; /* Sum of the counters of exited threads. */
+
+static uint64_t load (const uint64_t *counter)
+{
+#if defined(__GNUC__)
+  return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#else
+  return *counter;
+#endif
+}
+
+static void store (uint64_t *counter, uint64_t value)
+{
+#if defined(__GNUC__)
+  __atomic_store_n(counter, value, __ATOMIC_RELAXED);
+#else
+  *counter = value;
+#endif
+}
+
+/* Apply f to each pair of corresponding counters of a and b. */
+static void each_counter (random_stats_t *a, const random_stats_t *b,
+                          void (*f) (uint64_t *, const uint64_t *))
+{
+  int id, api;
+
+  for (id = 0; id < RANDOM_STATS_GENERATORS; id++)
+  {
+    for (api = 0; api < RANDOM_STATS_API_COUNT; api++)
+      f(&a->outputs[id][api], &b->outputs[id][api]);
+    f(&a->regenerations[id], &b->regenerations[id]);
+    f(&a->regeneration_cycles[id], &b->regeneration_cycles[id]);
+    f(&a->rejections[id], &b->rejections[id]);
+  }
+}
+
+static void add_counter (uint64_t *a, const uint64_t *b)
+{
+  *a += load(b);
+}
+
+static void zero_counter (uint64_t *a, const uint64_t *b)
+{
+  (void) b;
+  store(a, 0);
+}
+
+RANDOM_STATS_THREAD_LOCAL random_stats_t *random_stats_thread = NULL;
+
+static pthread_key_t key;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+/* Counters of threads whose own could not be allocated: counts are lost. */
+static random_stats_t discarded;
+
+/* Fold the counters of an exiting thread into the retired totals. */
+static void retire (void *p)
+{
+  block_t *block = p;
+
+  pthread_mutex_lock(&lock);
+  each_counter(&retired, &block->stats, add_counter);
+  if (block->prev)
+    block->prev->next = block->next;
+  else
+    blocks = block->next;
+  if (block->next)
+    block->next->prev = block->prev;
+  pthread_mutex_unlock(&lock);
+
+  free(block);
+}
+
+static void make_key (void)
+{
+  pthread_key_create(&key, retire);
+}
+
+random_stats_t *random_stats_register (void)
+{
+  block_t *block;
+
+  pthread_once(&once, make_key);
+
+  block = calloc(1, sizeof(block_t));
+  if (block == NULL)
+    return random_stats_thread = &discarded;
+
+  pthread_mutex_lock(&lock);
+  block->next = blocks;
+  if (blocks)
+    blocks->prev = block;
+  blocks = block;
+  pthread_mutex_unlock(&lock);
+
+  pthread_setspecific(key, block);
+
+  return random_stats_thread = &block->stats;
+}
+
+uint64_t random_stats_cycles (void)
+{
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t) t.tv_sec * 1000000000 + (uint64_t) t.tv_nsec;
+#endif
+}
+
+int random_stats_enabled (void)
+{
+#ifdef LIBRANDOM_STATS
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+void random_stats_snapshot (random_stats_t *stats)
+{
+  block_t *block;
+
+  memset(stats, 0, sizeof(*stats));
+
+  pthread_mutex_lock(&lock);
+  each_counter(stats, &retired, add_counter);
+  for (block = blocks; block != NULL; block = block->next)
+    each_counter(stats, &block->stats, add_counter);
+  pthread_mutex_unlock(&lock);
+}
+
+void random_stats_reset (void)
+{
+  block_t *block;
+
+  pthread_mutex_lock(&lock);
+  each_counter(&retired, &retired, zero_counter);
+  for (block = blocks; block != NULL; block = block->next)
+    each_counter(&block->stats, &block->stats, zero_counter);
+  pthread_mutex_unlock(&lock);
+}
+
+int random_stats_export (FILE *stream, const random_stats_t *stats)
+{
+  static const char *apis[RANDOM_STATS_API_COUNT] = {
+    "scalar", "fill", "distribution"
+  };
+  int id, api, error = 0;
+
+  error |= fprintf(stream, "# TYPE librandom_outputs_total counter\n") < 0;
+  for (id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    for (api = 0; api < RANDOM_STATS_API_COUNT; api++)
+    {
+      if (stats->outputs[id][api])
+        error |= fprintf(stream, "librandom_outputs_total"
+                         "{generator=\"%s\",api=\"%s\"} %llu\n",
+                         random_generator_info(id)->name, apis[api],
+                         (unsigned long long) stats->outputs[id][api]) < 0;
+    }
+  }
+
+  error |= fprintf(stream,
+                   "# TYPE librandom_regenerations_total counter\n") < 0;
+  for (id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    if (stats->regenerations[id])
+      error |= fprintf(stream, "librandom_regenerations_total"
+                       "{generator=\"%s\"} %llu\n",
+                       random_generator_info(id)->name,
+                       (unsigned long long) stats->regenerations[id]) < 0;
+  }
+
+  error |= fprintf(stream,
+                   "# TYPE librandom_regeneration_cycles_total counter\n") < 0;
+  for (id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    if (stats->regeneration_cycles[id])
+      error |= fprintf(stream, "librandom_regeneration_cycles_total"
+                       "{generator=\"%s\"} %llu\n",
+                       random_generator_info(id)->name,
+                       (unsigned long long)
+                       stats->regeneration_cycles[id]) < 0;
+  }
+
+  error |= fprintf(stream, "# TYPE librandom_rejections_total counter\n") < 0;
+  for (id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    if (stats->rejections[id])
+      error |= fprintf(stream, "librandom_rejections_total"
+                       "{generator=\"%s\"} %llu\n",
+                       random_generator_info(id)->name,
+                       (unsigned long long) stats->rejections[id]) < 0;
+  }
+
+  return error ? -1 : 0;
+}
@@ -0,0 +1,159 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Optional instrumentation of the generators.
+ *
+ * When librandom is compiled with LIBRANDOM_STATS defined (see the `stats`
+ * target of the makefile) each thread keeps counters of:
+ *
+ *  - the number of outputs of each generator drawn through each API: single
+ *    outputs (e.g. kiss64()), bulk fills (e.g. kiss64_fill()) and outputs
+ *    consumed by samplers of non-uniform distributions;
+ *  - the number of block regenerations of generators which produce their
+ *    output a block at a time, such as the `mti >= N` step of the Mersenne
+ *    Twisters, and the total time spent in them in cycles of the time stamp
+ *    counter (or nanoseconds where there is none);
+ *  - the number of iterations of rejection loops in samplers which were
+ *    rejected, by the generator providing the input.
+ *
+ * Counters are updated without locks or atomic read-modify-write operations,
+ * since each thread only updates its own. random_stats_snapshot() sums the
+ * counters of every thread, including threads which have exited, for export
+ * with random_stats_export() into a metrics system.
+ *
+ * Without LIBRANDOM_STATS the RANDOM_STATS_ macros expand to nothing, or to
+ * just the statement they time, so the instrumentation costs nothing; the
+ * routines below remain available and report zeros.
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of generator identifiers; see generator.h. */
+#define RANDOM_STATS_GENERATORS 32
+
+/* APIs through which outputs are drawn. */
+typedef enum {
+  RANDOM_STATS_SCALAR = 0,
+  RANDOM_STATS_FILL = 1,
+  RANDOM_STATS_DISTRIBUTION = 2,
+  RANDOM_STATS_API_COUNT
+} random_stats_api_t;
+
+/* Counters, indexed by generator identifier. */
+typedef struct {
+  uint64_t outputs[RANDOM_STATS_GENERATORS][RANDOM_STATS_API_COUNT];
+  uint64_t regenerations[RANDOM_STATS_GENERATORS];
+  uint64_t regeneration_cycles[RANDOM_STATS_GENERATORS];
+  uint64_t rejections[RANDOM_STATS_GENERATORS];
+} random_stats_t;
+
+/* Store the sum of the counters of all threads in *stats. */
+void random_stats_snapshot (random_stats_t *stats);
+
+/* Reset the counters of all threads to zero. Counts made concurrently with a
+ * reset may be lost. */
+void random_stats_reset (void);
+
+/* Write the non-zero counters of stats to stream in the Prometheus text
+ * exposition format, e.g.
+ *
+ *   librandom_outputs_total{generator="kiss64",api="fill"} 1048576
+ *
+ * Returns zero on success or -1 on a write error. */
+int random_stats_export (FILE *stream, const random_stats_t *stats);
+
+/* Non-zero if the library was compiled with LIBRANDOM_STATS. */
+int random_stats_enabled (void);
+
+/* The following support the RANDOM_STATS_ macros, and are available whether
+ * or not the library was compiled with LIBRANDOM_STATS, so that code compiled
+ * with it, such as the generators in header-only mode, can be instrumented
+ * independently of the library. */
+
+#if defined(_MSC_VER)
+#  define RANDOM_STATS_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#  define RANDOM_STATS_THREAD_LOCAL __thread
+#else
+#  define RANDOM_STATS_THREAD_LOCAL _Thread_local
+#endif
+
+/* Counters of the calling thread, or NULL before its first count. */
+extern RANDOM_STATS_THREAD_LOCAL random_stats_t *random_stats_thread;
+
+/* Allocate and register the counters of the calling thread. */
+random_stats_t *random_stats_register (void);
+
+/* Return the current value of the cycle counter. */
+uint64_t random_stats_cycles (void);
+
+static inline random_stats_t *random_stats_local (void)
+{
+  random_stats_t *stats = random_stats_thread;
+
+  return stats ? stats : random_stats_register();
+}
+
+/* Add n to a counter of the calling thread. The relaxed atomic store, a
+ * plain store on common hardware, only makes concurrent snapshots
+ * well-defined. */
+static inline void random_stats_add (uint64_t *counter, uint64_t n)
+{
+#if defined(__GNUC__)
+  __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+#else
+  *counter += n;
+#endif
+}
+
+#ifdef LIBRANDOM_STATS
+
+#define RANDOM_STATS_COUNT(id, api, n) \
+  random_stats_add(&random_stats_local()->outputs[id][api], (n))
+
+#define RANDOM_STATS_REJECT(id, n) \
+  random_stats_add(&random_stats_local()->rejections[id], (n))
+
+/* Move n outputs of generator id from one API to another, e.g. outputs drawn
+ * through the fill API on behalf of a distribution. */
+#define RANDOM_STATS_TRANSFER(id, from, to, n) \
+  do { \
+    random_stats_t *random_stats_ = random_stats_local(); \
+    random_stats_add(&random_stats_->outputs[id][from], -(uint64_t) (n)); \
+    random_stats_add(&random_stats_->outputs[id][to], (n)); \
+  } while (0)
+
+#define RANDOM_STATS_REGENERATE(id, statement) \
+  do { \
+    uint64_t random_stats_start_ = random_stats_cycles(); \
+    random_stats_t *random_stats_ = random_stats_local(); \
+    statement; \
+    random_stats_add(&random_stats_->regenerations[id], 1); \
+    random_stats_add(&random_stats_->regeneration_cycles[id], \
+                     random_stats_cycles() - random_stats_start_); \
+  } while (0)
+
+#else
+
+#define RANDOM_STATS_COUNT(id, api, n) ((void) 0)
+#define RANDOM_STATS_REJECT(id, n) ((void) 0)
+#define RANDOM_STATS_TRANSFER(id, from, to, n) ((void) 0)
+#define RANDOM_STATS_REGENERATE(id, statement) do { statement; } while (0)
+
+#endif /* ifdef LIBRANDOM_STATS */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* STATS_H_ */
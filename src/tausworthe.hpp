@@ -0,0 +1,436 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Compile-time parameterised combined Tausworthe generators of L'Ecuyer.
+ *
+ * A combined Tausworthe (LFSR) generator is the bitwise X-OR of J
+ * components, each held in an L-bit word and defined by the primitive
+ * trinomial x^k + x^q + 1 and a step size s. A component is advanced by
+ *
+ *     b = ((z << q) ^ z) >> (k - s);
+ *     z = ((z & (~0 << (L - k))) << s) ^ b;
+ *
+ * which is exactly the form of taus88, lfsr113 and lfsr258 in lfsr.c. The
+ * class template tausworthe_engine<UIntType, Components...> generates such a
+ * generator for any choice of word size and parameters, for instance the
+ * other maximally equidistributed combinations tabulated by L'Ecuyer, with
+ * every shift and mask a compile time constant:
+ *
+ *     typedef librandom::tausworthe_engine<std::uint32_t,
+ *       librandom::tausworthe_component<31, 13, 12>,
+ *       librandom::tausworthe_component<29,  2,  4>,
+ *       librandom::tausworthe_component<28,  3, 17> > taus88;
+ *
+ * The conditions of L'Ecuyer (1996) for the combined generator to have the
+ * full period (2^{k_1} - 1)...(2^{k_J} - 1) are checked when the template is
+ * instantiated: 0 < 2q < k <= L and 0 < s <= k - q for each component;
+ * x^k + x^q + 1 primitive over GF(2), checked by factorising 2^k - 1 at
+ * compile time; gcd(s, 2^k - 1) = 1; and the periods 2^{k_j} - 1 pairwise
+ * coprime, i.e. the k_j pairwise coprime. Equidistribution is not checked.
+ *
+ * See:
+ * - L'Ecuyer, P, *Maximally equidistributed combined Tausworthe generators*,
+ *   Mathematics of Computation **65**, 203-213 (1996).
+ * - L'Ecuyer, P, *Tables of Maximally-Equidistributed Combined LFSR
+ *   generators*, Mathematics of Computation **68**, 261-269 (1999).
+ */
+
+#ifndef TAUSWORTHE_HPP_
+#define TAUSWORTHE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "engine.hpp"
+
+namespace librandom {
+
+namespace detail {
+
+/* (a * b) mod m, for m < 2^64. */
+constexpr std::uint64_t mulmod (std::uint64_t a, std::uint64_t b,
+                                std::uint64_t m)
+{
+#ifdef __SIZEOF_INT128__
+  return static_cast<std::uint64_t>(static_cast<unsigned __int128>(a) * b % m);
+#else
+  std::uint64_t r = 0;
+
+  for (a %= m; b; b >>= 1)
+  {
+    if (b & 1)
+      r = (r >= m - a) ? r - (m - a) : r + a;
+    a = (a >= m - a) ? a - (m - a) : a + a;
+  }
+
+  return r;
+#endif
+}
+
+/* (a ^ e) mod m, for m < 2^64. */
+constexpr std::uint64_t powmod (std::uint64_t a, std::uint64_t e,
+                                std::uint64_t m)
+{
+  std::uint64_t r = 1 % m;
+
+  for (a %= m; e; e >>= 1)
+  {
+    if (e & 1)
+      r = mulmod(r, a, m);
+    a = mulmod(a, a, m);
+  }
+
+  return r;
+}
+
+constexpr std::uint64_t gcd (std::uint64_t a, std::uint64_t b)
+{
+  while (b)
+  {
+    std::uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+
+  return a;
+}
+
+/* Deterministic Miller-Rabin primality test, exact for all n < 2^64. */
+constexpr bool is_prime (std::uint64_t n)
+{
+  const std::uint64_t bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+  std::uint64_t d = 0;
+  unsigned r = 0;
+
+  if (n < 2)
+    return false;
+
+  for (std::uint64_t p : bases)
+    if (n % p == 0)
+      return n == p;
+
+  for (d = n - 1; !(d & 1); d >>= 1)
+    r++;
+
+  for (std::uint64_t a : bases)
+  {
+    std::uint64_t x = powmod(a, d, n);
+    unsigned i = 1;
+
+    if (x == 1 || x == n - 1)
+      continue;
+
+    for (; i < r; i++)
+    {
+      x = mulmod(x, x, n);
+      if (x == n - 1)
+        break;
+    }
+
+    if (i == r)
+      return false;
+  }
+
+  return true;
+}
+
+/* A non-trivial factor of the odd composite n < 2^63, by Pollard's rho. */
+constexpr std::uint64_t find_factor (std::uint64_t n)
+{
+  for (std::uint64_t c = 1; ; c++)
+  {
+    std::uint64_t x = 2, y = 2, d = 1;
+
+    while (d == 1)
+    {
+      x = (mulmod(x, x, n) + c) % n;
+      y = (mulmod(y, y, n) + c) % n;
+      y = (mulmod(y, y, n) + c) % n;
+      d = gcd(x > y ? x - y : y - x, n);
+    }
+
+    if (d != n)
+      return d;
+  }
+}
+
+/* The distinct prime factors of an integer. */
+struct prime_factors
+{
+  std::uint64_t p[64];
+  unsigned n;
+};
+
+constexpr void factorise (std::uint64_t n, prime_factors &factors)
+{
+  if (n == 1)
+    return;
+
+  if (!(n & 1))
+  {
+    factorise(2, factors);
+    factorise(n >> 1, factors);
+  }
+  else if (is_prime(n))
+  {
+    for (unsigned i = 0; i < factors.n; i++)
+      if (factors.p[i] == n)
+        return;
+    factors.p[factors.n++] = n;
+  }
+  else
+  {
+    std::uint64_t d = find_factor(n);
+    factorise(d, factors);
+    factorise(n / d, factors);
+  }
+}
+
+/* (a * b) mod (x^k + x^q + 1) over GF(2), for polynomials of degree < k held
+ * as bit masks. */
+constexpr std::uint64_t trinomial_mulmod (std::uint64_t a, std::uint64_t b,
+                                          unsigned k, unsigned q)
+{
+  const std::uint64_t top = std::uint64_t(1) << (k - 1);
+  const std::uint64_t mask = (std::uint64_t(1) << k) - 1;
+  const std::uint64_t low = (std::uint64_t(1) << q) | 1;
+  std::uint64_t r = 0;
+
+  for (unsigned i = k; i-- > 0; )
+  {
+    const bool carry = (r & top) != 0;
+
+    r = (r << 1) & mask;
+    if (carry)
+      r ^= low;
+    if ((b >> i) & 1)
+      r ^= a;
+  }
+
+  return r;
+}
+
+/* x^e mod (x^k + x^q + 1) over GF(2). */
+constexpr std::uint64_t trinomial_powmod (std::uint64_t e, unsigned k,
+                                          unsigned q)
+{
+  std::uint64_t r = 1, x = 2;
+
+  for (; e; e >>= 1)
+  {
+    if (e & 1)
+      r = trinomial_mulmod(r, x, k, q);
+    x = trinomial_mulmod(x, x, k, q);
+  }
+
+  return r;
+}
+
+/* Is x^k + x^q + 1 primitive over GF(2), i.e. is the order of x modulo the
+ * trinomial exactly 2^k - 1? Requires 0 < q < k < 64. */
+constexpr bool primitive_trinomial (unsigned k, unsigned q)
+{
+  const std::uint64_t order = (std::uint64_t(1) << k) - 1;
+  prime_factors factors{};
+
+  if (k < 2 || k > 63 || q == 0 || q >= k)
+    return false;
+
+  if (trinomial_powmod(order, k, q) != 1)
+    return false;
+
+  factorise(order, factors);
+  for (unsigned i = 0; i < factors.n; i++)
+    if (trinomial_powmod(order / factors.p[i], k, q) == 1)
+      return false;
+
+  return true;
+}
+
+template <std::size_t N>
+constexpr bool pairwise_coprime (const std::array<unsigned, N> &k)
+{
+  for (std::size_t i = 0; i < N; i++)
+    for (std::size_t j = i + 1; j < N; j++)
+      if (gcd(k[i], k[j]) != 1)
+        return false;
+
+  return true;
+}
+
+} /* namespace detail */
+
+/* A component of a combined Tausworthe generator, with primitive trinomial
+ * x^K + x^Q + 1 and step size S. */
+template <unsigned K, unsigned Q, unsigned S>
+struct tausworthe_component
+{
+  static constexpr unsigned k = K;
+  static constexpr unsigned q = Q;
+  static constexpr unsigned s = S;
+
+  /* Are the parameters admissible for a component in a word of L bits? */
+  static constexpr bool admissible (unsigned L)
+  {
+    return 0 < q && 2*q < k && 0 < s && s <= k - q && k <= L && k < 64;
+  }
+
+  /* Does the component have the full period 2^k - 1? */
+  static constexpr bool full_period ()
+  {
+    return detail::primitive_trinomial(k, q)
+        && detail::gcd(s, (std::uint64_t(1) << k) - 1) == 1;
+  }
+
+  /* Advance the component state z held in a word of type UIntType. */
+  template <class UIntType>
+  static constexpr UIntType step (UIntType z)
+  {
+    constexpr unsigned L = std::numeric_limits<UIntType>::digits;
+    constexpr UIntType mask = static_cast<UIntType>(~UIntType(0) << (L - k));
+    const UIntType b = static_cast<UIntType>(((z << q) ^ z) >> (k - s));
+
+    return static_cast<UIntType>(((z & mask) << s) ^ b);
+  }
+};
+
+/* Combined Tausworthe generator with components Components... held in words
+ * of type UIntType. */
+template <class UIntType, class... Components>
+class tausworthe_engine
+  : public detail::engine_base<tausworthe_engine<UIntType, Components...>,
+                               UIntType>
+{
+public:
+  typedef UIntType result_type;
+
+  static constexpr unsigned word_size =
+    std::numeric_limits<UIntType>::digits;
+  static constexpr std::size_t component_count = sizeof...(Components);
+
+  static_assert(std::is_unsigned<UIntType>::value
+                && word_size >= std::numeric_limits<unsigned>::digits,
+                "UIntType must be an unsigned type at least as wide as int");
+  static_assert(component_count > 0, "at least one component is required");
+  static_assert((Components::admissible(word_size) && ...),
+                "each component requires 0 < 2q < k <= L and 0 < s <= k - q");
+  static_assert((Components::full_period() && ...),
+                "each component requires x^k + x^q + 1 primitive and "
+                "gcd(s, 2^k - 1) = 1");
+  static_assert(detail::pairwise_coprime(
+                  std::array<unsigned, component_count>{ Components::k... }),
+                "the k of the components must be pairwise coprime");
+
+  typedef std::array<UIntType, component_count> state_type;
+
+  static constexpr UIntType default_seed = 12345u;
+
+  constexpr tausworthe_engine () : state_{} { seed(default_seed); }
+
+  constexpr explicit tausworthe_engine (UIntType value) : state_{}
+  {
+    seed(value);
+  }
+
+  /* The state of component j **must** be at least 2^{L - k_j}. */
+  constexpr explicit tausworthe_engine (const state_type &state)
+    : state_(state) {}
+
+  /* Seed every component with value, adding 2^{L - k_j} to it for component
+   * j where it is smaller than that. */
+  constexpr void seed (UIntType value = default_seed)
+  {
+    std::size_t j = 0;
+
+    ((state_[j++] = value < minimum_state<Components>()
+                  ? static_cast<UIntType>(value + minimum_state<Components>())
+                  : value), ...);
+  }
+
+  constexpr result_type operator() ()
+  {
+    return step_all(std::index_sequence_for<Components...>());
+  }
+
+  void fill (result_type *out, std::size_t n)
+  {
+    tausworthe_engine engine(*this); /* Keep the state in registers. */
+
+    for (std::size_t i = 0; i < n; i++)
+      out[i] = engine();
+
+    *this = engine;
+  }
+
+  /* Advance the state z of component J alone. */
+  template <std::size_t J>
+  static constexpr UIntType step_component (UIntType z)
+  {
+    typedef typename std::tuple_element<J, std::tuple<Components...> >::type
+      component;
+
+    return component::template step<UIntType>(z);
+  }
+
+  constexpr const state_type &state () const { return state_; }
+
+  friend constexpr bool operator== (const tausworthe_engine &a,
+                                    const tausworthe_engine &b)
+  {
+    for (std::size_t j = 0; j < component_count; j++)
+      if (a.state_[j] != b.state_[j])
+        return false;
+
+    return true;
+  }
+
+private:
+  template <class Component>
+  static constexpr UIntType minimum_state ()
+  {
+    return static_cast<UIntType>(UIntType(1) << (word_size - Component::k));
+  }
+
+  template <std::size_t... J>
+  constexpr result_type step_all (std::index_sequence<J...>)
+  {
+    ((state_[J] = step_component<J>(state_[J])), ...);
+
+    return (state_[J] ^ ...);
+  }
+
+  state_type state_;
+};
+
+/* The generators of lfsr.h as instances of tausworthe_engine. */
+typedef tausworthe_engine<std::uint32_t,
+                          tausworthe_component<31, 13, 12>,
+                          tausworthe_component<29,  2,  4>,
+                          tausworthe_component<28,  3, 17> >
+  taus88_tausworthe;
+
+typedef tausworthe_engine<std::uint32_t,
+                          tausworthe_component<31,  6, 18>,
+                          tausworthe_component<29,  2,  2>,
+                          tausworthe_component<28, 13,  7>,
+                          tausworthe_component<25,  3, 13> >
+  lfsr113_tausworthe;
+
+typedef tausworthe_engine<std::uint64_t,
+                          tausworthe_component<63,  1, 10>,
+                          tausworthe_component<55, 24,  5>,
+                          tausworthe_component<52,  3, 29>,
+                          tausworthe_component<47,  5, 23>,
+                          tausworthe_component<41,  3,  8> >
+  lfsr258_tausworthe;
+
+} /* namespace librandom */
+
+#endif /* TAUSWORTHE_HPP_ */
@@ -0,0 +1,594 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ *
+ * The generators are implemented from the reference implementation of
+ * TinyMT, Copyright (C) 2011 Mutsuo Saito, Makoto Matsumoto, Hiroshima
+ * University and The University of Tokyo, released under the 3-clause BSD
+ * License.
+ */
+
+/* Tiny Mersenne Twister generators TinyMT32 and TinyMT64. */
+
+#include <string.h>
+
+#include "tinymt.h"
+#include "generator.h"
+#include "stats.h"
+
+/* Number of steps of the loops of the reference initialisation. */
+#define TINYMT_MIN_LOOP 8
+#define TINYMT_PRE_LOOP 8
+
+/* Degree of the characteristic polynomial: the state has 127 bits. */
+#define TINYMT_MEXP 127
+
+/* Below this number of steps, jumps simply step the generator. */
+#define TINYMT_JUMP_MIN (4 * TINYMT_MEXP)
+
+/* Polynomial over GF(2) of degree at most 127; bit i is the coefficient of
+ * x^i. */
+typedef struct {
+  uint64_t w[2];
+} tinymt_poly_t;
+
+/* a = a * x mod phi, where deg a < 127 and deg phi = 127. */
+static inline void tinymt_poly_mulx (tinymt_poly_t *a,
+                                     const tinymt_poly_t *phi)
+{
+  a->w[1] = (a->w[1] << 1) | (a->w[0] >> 63);
+  a->w[0] <<= 1;
+
+  if (a->w[1] >> 63)
+  {
+    a->w[0] ^= phi->w[0];
+    a->w[1] ^= phi->w[1];
+  }
+}
+
+/* Return a * b mod phi. */
+static tinymt_poly_t tinymt_poly_mulmod (tinymt_poly_t a, tinymt_poly_t b,
+                                         const tinymt_poly_t *phi)
+{
+  tinymt_poly_t r = { { 0, 0 } };
+  int i;
+
+  for (i = TINYMT_MEXP - 1; i >= 0; i--)
+  {
+    tinymt_poly_mulx(&r, phi);
+    if ((b.w[i / 64] >> (i % 64)) & 1)
+    {
+      r.w[0] ^= a.w[0];
+      r.w[1] ^= a.w[1];
+    }
+  }
+
+  return r;
+}
+
+/* Return x^n mod phi. */
+static tinymt_poly_t tinymt_poly_xpow (uint64_t n, const tinymt_poly_t *phi)
+{
+  tinymt_poly_t r = { { 1, 0 } };
+  int i;
+
+  for (i = 63; i >= 0; i--)
+  {
+    r = tinymt_poly_mulmod(r, r, phi);
+    if ((n >> i) & 1)
+      tinymt_poly_mulx(&r, phi);
+  }
+
+  return r;
+}
+
+/* Return non-zero if phi, of degree 127, is irreducible. Since 127 is prime,
+ * this is the case if and only if x^(2^127) = x mod phi. */
+static int tinymt_poly_irreducible (const tinymt_poly_t *phi)
+{
+  tinymt_poly_t r = { { 2, 0 } };
+  int i;
+
+  for (i = 0; i < TINYMT_MEXP; i++)
+    r = tinymt_poly_mulmod(r, r, phi);
+
+  return r.w[0] == 2 && r.w[1] == 0;
+}
+
+#define TINYMT_BIT(a, i) (((a)[(i) / 64] >> ((i) % 64)) & 1)
+
+/* Compute the minimal polynomial phi of the bit sequence seq[0..n-1], where
+ * n <= 256, by the Berlekamp-Massey algorithm, returning its degree. */
+static int tinymt_minpoly (const uint64_t seq[4], int n, tinymt_poly_t *phi)
+{
+  uint64_t c[4] = { 1, 0, 0, 0 }, b[4] = { 1, 0, 0, 0 }, t[4];
+  int l = 0, m = 1, i, k;
+
+  for (k = 0; k < n; k++)
+  {
+    uint64_t d = TINYMT_BIT(seq, k);
+
+    for (i = 1; i <= l; i++)
+      d ^= TINYMT_BIT(c, i) & TINYMT_BIT(seq, k - i);
+
+    if (d == 0)
+    {
+      m++;
+      continue;
+    }
+
+    memcpy(t, c, sizeof(t));
+
+    /* c ^= b * x^m */
+    for (i = 3; i >= m / 64; i--)
+    {
+      int j = i - m / 64, s = m % 64;
+      uint64_t w = b[j] << s;
+
+      if (s != 0 && j > 0)
+        w |= b[j - 1] >> (64 - s);
+      c[i] ^= w;
+    }
+
+    if (2 * l <= k)
+    {
+      l = k + 1 - l;
+      memcpy(b, t, sizeof(b));
+      m = 1;
+    }
+    else
+    {
+      m++;
+    }
+  }
+
+  /* The minimal polynomial is the reciprocal of the connection polynomial
+   * c, which has degree at most l. */
+  phi->w[0] = phi->w[1] = 0;
+  for (i = 0; i <= l && i < 128; i++)
+  {
+    if (TINYMT_BIT(c, l - i))
+      phi->w[i / 64] |= UINT64_C(1) << (i % 64);
+  }
+
+  return l;
+}
+
+#undef TINYMT_BIT
+
+/* TinyMT32 */
+
+#define TINYMT32_SH0 1
+#define TINYMT32_SH1 10
+#define TINYMT32_SH8 8
+#define TINYMT32_MASK UINT32_C(0x7fffffff)
+
+/* Set 0 is the default set of the reference implementation. The others were
+ * found by drawing mat1, mat2 and tmat from kiss64 and keeping those for
+ * which tinymt32_check_params() holds; the same was done for tinymt64. Their
+ * characteristic polynomials are pairwise distinct, which test_tinymt
+ * checks, but tmat was not chosen for equidistribution as by TinyMTDC. */
+static const tinymt32_params_t tinymt32_table[TINYMT32_PARAMS_COUNT] = {
+  { UINT32_C(0x8f7011ee), UINT32_C(0xfc78ff1f), UINT32_C(0x3793fdff) },
+  { UINT32_C(0xdf23d5e3), UINT32_C(0x7a41bbe3), UINT32_C(0x7292776a) },
+  { UINT32_C(0x07431caa), UINT32_C(0x82c9b6ff), UINT32_C(0x8f5cfe9f) },
+  { UINT32_C(0x7a09a637), UINT32_C(0xd13fb425), UINT32_C(0x323d3026) },
+  { UINT32_C(0x3c698173), UINT32_C(0x2436aadf), UINT32_C(0x51f7cbd1) },
+  { UINT32_C(0x24c124b4), UINT32_C(0xeec130b5), UINT32_C(0x4bada5b1) },
+  { UINT32_C(0x3aa47f5b), UINT32_C(0xa0fb72e7), UINT32_C(0x035cc088) },
+  { UINT32_C(0xfabdd4e8), UINT32_C(0xd5425a4b), UINT32_C(0xedf23a6d) },
+  { UINT32_C(0x4234a828), UINT32_C(0xfaeeba59), UINT32_C(0x708fb0b5) },
+  { UINT32_C(0xa03cd614), UINT32_C(0xd77693d1), UINT32_C(0xf6d5079d) },
+  { UINT32_C(0x24424bbf), UINT32_C(0xe3796413), UINT32_C(0x20060871) },
+  { UINT32_C(0x0d3fd9c8), UINT32_C(0xe2041d75), UINT32_C(0x602ed6e7) },
+  { UINT32_C(0x52cd2daa), UINT32_C(0x4adefd51), UINT32_C(0x534e9ff4) },
+  { UINT32_C(0xcd58df0d), UINT32_C(0x4da556f9), UINT32_C(0x3ddccd93) },
+  { UINT32_C(0x7a6ac4d8), UINT32_C(0xadc9e7e3), UINT32_C(0xccf7d745) },
+  { UINT32_C(0x9b1c8d02), UINT32_C(0x1bb897fd), UINT32_C(0xad05b4fa) }
+};
+
+/* Linear state transition of tinymt32. */
+static inline void tinymt32_next_state (tinymt32_state_t *state)
+{
+  uint32_t x, y;
+
+  y = state->status[3];
+  x = (state->status[0] & TINYMT32_MASK) ^ state->status[1]
+    ^ state->status[2];
+  x ^= (x << TINYMT32_SH0);
+  y ^= (y >> TINYMT32_SH0) ^ x;
+  state->status[0] = state->status[1];
+  state->status[1] = state->status[2];
+  state->status[2] = x ^ (y << TINYMT32_SH1);
+  state->status[3] = y;
+  state->status[1] ^= -(y & 1) & state->mat1;
+  state->status[2] ^= -(y & 1) & state->mat2;
+}
+
+/* Tempering of the state of tinymt32. */
+static inline uint32_t tinymt32_temper (const tinymt32_state_t *state)
+{
+  uint32_t t0, t1;
+
+  t0 = state->status[3];
+  t1 = state->status[0] + (state->status[2] >> TINYMT32_SH8);
+  t0 ^= t1;
+  t0 ^= -(t1 & 1) & state->tmat;
+
+  return t0;
+}
+
+/* Compute the characteristic polynomial of tinymt32 with the parameters of
+ * state, returning its degree. */
+static int tinymt32_charpoly (const tinymt32_state_t *state,
+                              tinymt_poly_t *phi)
+{
+  tinymt32_params_t params;
+  tinymt32_state_t s;
+  uint64_t seq[4] = { 0, 0, 0, 0 };
+  int k;
+
+  params.mat1 = state->mat1;
+  params.mat2 = state->mat2;
+  params.tmat = state->tmat;
+  init_tinymt32(&s, &params, 0);
+
+  for (k = 0; k < 2 * TINYMT_MEXP; k++)
+  {
+    tinymt32_next_state(&s);
+    seq[k / 64] |= (uint64_t) (s.status[3] & 1) << (k % 64);
+  }
+
+  return tinymt_minpoly(seq, 2 * TINYMT_MEXP, phi);
+}
+
+LIBRANDOM_API const tinymt32_params_t *tinymt32_params (unsigned index)
+{
+  return index < TINYMT32_PARAMS_COUNT ? &tinymt32_table[index] : NULL;
+}
+
+LIBRANDOM_API void init_tinymt32 (tinymt32_state_t *state,
+                                  const tinymt32_params_t *params,
+                                  uint32_t seed)
+{
+  int i;
+
+  state->mat1 = params->mat1;
+  state->mat2 = params->mat2;
+  state->tmat = params->tmat;
+
+  state->status[0] = seed;
+  state->status[1] = params->mat1;
+  state->status[2] = params->mat2;
+  state->status[3] = params->tmat;
+
+  for (i = 1; i < TINYMT_MIN_LOOP; i++)
+  {
+    uint32_t s = state->status[(i - 1) & 3];
+
+    state->status[i & 3] ^= (uint32_t) i
+                          + UINT32_C(1812433253) * (s ^ (s >> 30));
+  }
+
+  /* Period certification: the state must not be zero. */
+  if ((state->status[0] & TINYMT32_MASK) == 0 && state->status[1] == 0
+      && state->status[2] == 0 && state->status[3] == 0)
+  {
+    state->status[0] = 'T';
+    state->status[1] = 'I';
+    state->status[2] = 'N';
+    state->status[3] = 'Y';
+  }
+
+  for (i = 0; i < TINYMT_PRE_LOOP; i++)
+    tinymt32_next_state(state);
+}
+
+LIBRANDOM_API uint32_t tinymt32 (tinymt32_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_TINYMT32, RANDOM_STATS_SCALAR, 1);
+  tinymt32_next_state(state);
+  return tinymt32_temper(state);
+}
+
+LIBRANDOM_API void tinymt32_fill (tinymt32_state_t *state, uint32_t *out,
+                                  size_t n)
+{
+  tinymt32_state_t s = *state; /* Keep the state in registers. */
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_TINYMT32, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+  {
+    tinymt32_next_state(&s);
+    out[i] = tinymt32_temper(&s);
+  }
+
+  *state = s;
+}
+
+LIBRANDOM_API void tinymt32_jump (tinymt32_state_t *state, uint64_t n)
+{
+  tinymt32_state_t acc = *state;
+  tinymt_poly_t phi, g;
+  int i, j;
+
+  if (n < TINYMT_JUMP_MIN)
+  {
+    for (; n > 0; n--)
+      tinymt32_next_state(state);
+    return;
+  }
+
+  /* One step takes the state into the image of the transition, on which
+   * phi annihilates it, even if the top bit of status[0] is set. */
+  tinymt32_next_state(state);
+  tinymt32_charpoly(state, &phi);
+  g = tinymt_poly_xpow(n - 1, &phi);
+
+  /* state = g(T) state, by Horner's rule. */
+  memset(acc.status, 0, sizeof(acc.status));
+  for (i = TINYMT_MEXP - 1; i >= 0; i--)
+  {
+    tinymt32_next_state(&acc);
+    if ((g.w[i / 64] >> (i % 64)) & 1)
+    {
+      for (j = 0; j < 4; j++)
+        acc.status[j] ^= state->status[j];
+    }
+  }
+
+  memcpy(state->status, acc.status, sizeof(acc.status));
+}
+
+LIBRANDOM_API int tinymt32_charpoly_params (const tinymt32_params_t *params,
+                                          uint64_t phi[2])
+{
+  tinymt32_state_t state;
+  tinymt_poly_t p;
+  int degree;
+
+  state.mat1 = params->mat1;
+  state.mat2 = params->mat2;
+  state.tmat = params->tmat;
+
+  degree = tinymt32_charpoly(&state, &p);
+  phi[0] = p.w[0];
+  phi[1] = p.w[1];
+
+  return degree;
+}
+
+LIBRANDOM_API int tinymt32_check_params (const tinymt32_params_t *params)
+{
+  tinymt32_state_t state;
+  tinymt_poly_t phi;
+
+  state.mat1 = params->mat1;
+  state.mat2 = params->mat2;
+  state.tmat = params->tmat;
+
+  return tinymt32_charpoly(&state, &phi) == TINYMT_MEXP
+         && tinymt_poly_irreducible(&phi);
+}
+
+#undef TINYMT32_SH0
+#undef TINYMT32_SH1
+#undef TINYMT32_SH8
+#undef TINYMT32_MASK
+
+#ifdef UINT64_C
+
+/* TinyMT64 */
+
+#define TINYMT64_SH0 12
+#define TINYMT64_SH1 11
+#define TINYMT64_SH8 8
+#define TINYMT64_MASK UINT64_C(0x7fffffffffffffff)
+
+static const tinymt64_params_t tinymt64_table[TINYMT64_PARAMS_COUNT] = {
+  { UINT64_C(0xfa051f40), UINT64_C(0xffd0fff4), UINT64_C(0x58d02ffeffbfffbc) },
+  { UINT64_C(0x0e550345), UINT64_C(0xc7c9a7e2), UINT64_C(0x6857611500a9668d) },
+  { UINT64_C(0x72c07e40), UINT64_C(0x7d160e75), UINT64_C(0x1ea4acc7a700e49d) },
+  { UINT64_C(0xb8ca8736), UINT64_C(0x806325b9), UINT64_C(0xf0bfbd8e561cb42b) },
+  { UINT64_C(0x13603960), UINT64_C(0xbf97aae0), UINT64_C(0xe5e0ed1e21783604) },
+  { UINT64_C(0x2ffe0ce3), UINT64_C(0xa78e1392), UINT64_C(0x2d24eeaeb74de6db) },
+  { UINT64_C(0x71e082e8), UINT64_C(0x0352185a), UINT64_C(0x7c4dfe80a04ca8d3) },
+  { UINT64_C(0xb29337ef), UINT64_C(0xbc291a7f), UINT64_C(0x4be2fd230f135805) },
+  { UINT64_C(0xfa9ea5b9), UINT64_C(0xe7fb1688), UINT64_C(0xc998ae0b7355d0c0) },
+  { UINT64_C(0xce0cb698), UINT64_C(0x093f31ff), UINT64_C(0x991009ab438cb716) },
+  { UINT64_C(0x0639d533), UINT64_C(0x8f43a935), UINT64_C(0xc1eacfe9ffbfeaf7) },
+  { UINT64_C(0x10bc202f), UINT64_C(0x9e1bb533), UINT64_C(0x629f86dccdfb3b05) },
+  { UINT64_C(0x406d974c), UINT64_C(0x275e5378), UINT64_C(0x5fc2d4ef965cdd54) },
+  { UINT64_C(0xeff9b6b5), UINT64_C(0x3df96473), UINT64_C(0x126c0d8d391c47aa) },
+  { UINT64_C(0xa8851bb2), UINT64_C(0x27639ae0), UINT64_C(0x1478cf1efb25a7b0) },
+  { UINT64_C(0x027ee8d7), UINT64_C(0xb7dfb8b0), UINT64_C(0x3d1fed4aa2374109) }
+};
+
+/* Linear state transition of tinymt64. */
+static inline void tinymt64_next_state (tinymt64_state_t *state)
+{
+  uint64_t x;
+
+  state->status[0] &= TINYMT64_MASK;
+  x = state->status[0] ^ state->status[1];
+  x ^= x << TINYMT64_SH0;
+  x ^= x >> 32;
+  x ^= x << 32;
+  x ^= x << TINYMT64_SH1;
+  state->status[0] = state->status[1];
+  state->status[1] = x;
+  state->status[0] ^= -(x & 1) & state->mat1;
+  state->status[1] ^= -(x & 1) & (state->mat2 << 32);
+}
+
+/* Tempering of the state of tinymt64. */
+static inline uint64_t tinymt64_temper (const tinymt64_state_t *state)
+{
+  uint64_t x;
+
+  x = state->status[0] + state->status[1];
+  x ^= state->status[0] >> TINYMT64_SH8;
+  x ^= -(x & 1) & state->tmat;
+
+  return x;
+}
+
+/* Compute the characteristic polynomial of tinymt64 with the parameters of
+ * state, returning its degree. */
+static int tinymt64_charpoly (const tinymt64_state_t *state,
+                              tinymt_poly_t *phi)
+{
+  tinymt64_params_t params;
+  tinymt64_state_t s;
+  uint64_t seq[4] = { 0, 0, 0, 0 };
+  int k;
+
+  params.mat1 = state->mat1;
+  params.mat2 = state->mat2;
+  params.tmat = state->tmat;
+  init_tinymt64(&s, &params, 0);
+
+  for (k = 0; k < 2 * TINYMT_MEXP; k++)
+  {
+    tinymt64_next_state(&s);
+    seq[k / 64] |= (s.status[1] & 1) << (k % 64);
+  }
+
+  return tinymt_minpoly(seq, 2 * TINYMT_MEXP, phi);
+}
+
+LIBRANDOM_API const tinymt64_params_t *tinymt64_params (unsigned index)
+{
+  return index < TINYMT64_PARAMS_COUNT ? &tinymt64_table[index] : NULL;
+}
+
+LIBRANDOM_API void init_tinymt64 (tinymt64_state_t *state,
+                                  const tinymt64_params_t *params,
+                                  uint64_t seed)
+{
+  int i;
+
+  state->mat1 = params->mat1;
+  state->mat2 = params->mat2;
+  state->tmat = params->tmat;
+
+  state->status[0] = seed ^ (params->mat1 << 32);
+  state->status[1] = params->mat2 ^ params->tmat;
+
+  for (i = 1; i < TINYMT_MIN_LOOP; i++)
+  {
+    uint64_t s = state->status[(i - 1) & 1];
+
+    state->status[i & 1] ^= (uint64_t) i
+                          + UINT64_C(6364136223846793005) * (s ^ (s >> 62));
+  }
+
+  /* Period certification: the state must not be zero. */
+  if ((state->status[0] & TINYMT64_MASK) == 0 && state->status[1] == 0)
+  {
+    state->status[0] = 'T';
+    state->status[1] = 'M';
+  }
+}
+
+LIBRANDOM_API uint64_t tinymt64 (tinymt64_state_t *state)
+{
+  RANDOM_STATS_COUNT(RANDOM_TINYMT64, RANDOM_STATS_SCALAR, 1);
+  tinymt64_next_state(state);
+  return tinymt64_temper(state);
+}
+
+LIBRANDOM_API void tinymt64_fill (tinymt64_state_t *state, uint64_t *out,
+                                  size_t n)
+{
+  tinymt64_state_t s = *state; /* Keep the state in registers. */
+  size_t i;
+
+  RANDOM_STATS_COUNT(RANDOM_TINYMT64, RANDOM_STATS_FILL, n);
+
+  for (i = 0; i < n; i++)
+  {
+    tinymt64_next_state(&s);
+    out[i] = tinymt64_temper(&s);
+  }
+
+  *state = s;
+}
+
+LIBRANDOM_API void tinymt64_jump (tinymt64_state_t *state, uint64_t n)
+{
+  tinymt64_state_t acc = *state;
+  tinymt_poly_t phi, g;
+  int i;
+
+  if (n < TINYMT_JUMP_MIN)
+  {
+    for (; n > 0; n--)
+      tinymt64_next_state(state);
+    return;
+  }
+
+  /* As tinymt32_jump(). */
+  tinymt64_next_state(state);
+  tinymt64_charpoly(state, &phi);
+  g = tinymt_poly_xpow(n - 1, &phi);
+
+  acc.status[0] = acc.status[1] = 0;
+  for (i = TINYMT_MEXP - 1; i >= 0; i--)
+  {
+    tinymt64_next_state(&acc);
+    if ((g.w[i / 64] >> (i % 64)) & 1)
+    {
+      acc.status[0] ^= state->status[0];
+      acc.status[1] ^= state->status[1];
+    }
+  }
+
+  state->status[0] = acc.status[0];
+  state->status[1] = acc.status[1];
+}
+
+LIBRANDOM_API int tinymt64_charpoly_params (const tinymt64_params_t *params,
+                                          uint64_t phi[2])
+{
+  tinymt64_state_t state;
+  tinymt_poly_t p;
+  int degree;
+
+  state.mat1 = params->mat1;
+  state.mat2 = params->mat2;
+  state.tmat = params->tmat;
+
+  degree = tinymt64_charpoly(&state, &p);
+  phi[0] = p.w[0];
+  phi[1] = p.w[1];
+
+  return degree;
+}
+
+LIBRANDOM_API int tinymt64_check_params (const tinymt64_params_t *params)
+{
+  tinymt64_state_t state;
+  tinymt_poly_t phi;
+
+  state.mat1 = params->mat1;
+  state.mat2 = params->mat2;
+  state.tmat = params->tmat;
+
+  return tinymt64_charpoly(&state, &phi) == TINYMT_MEXP
+         && tinymt_poly_irreducible(&phi);
+}
+
+#undef TINYMT64_SH0
+#undef TINYMT64_SH1
+#undef TINYMT64_SH8
+#undef TINYMT64_MASK
+
+#endif /* ifdef UINT64_C */
+
+#undef TINYMT_MIN_LOOP
+#undef TINYMT_PRE_LOOP
+#undef TINYMT_MEXP
+#undef TINYMT_JUMP_MIN
@@ -0,0 +1,156 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Tiny Mersenne Twister generators TinyMT32 and TinyMT64 of Saito and
+ * Matsumoto.
+ *
+ * TinyMT is a small-state relative of the Mersenne Twister: the state is 127
+ * bits, held in 16 bytes, plus the three parameters of the generator, for a
+ * period of 2^127 - 1. This makes it suitable where very many independent
+ * streams are needed at once, for example one per agent of a simulation,
+ * for which the 2.5 KB state of mt19937ar or mt19937_64 is too large.
+ *
+ * Each parameter set (mat1, mat2, tmat) defines a different generator.
+ * Streams with different parameter sets whose characteristic polynomials
+ * differ are independent in the sense of Matsumoto et al.; each
+ * implementation provides a small table of such parameter sets, the first
+ * of which is the default set of the reference implementation. The others
+ * have full period and pairwise distinct characteristic polynomials, but
+ * were drawn at random rather than found by the TinyMTDC program of the
+ * authors: their tempering parameter tmat is not optimised, so the
+ * equidistribution of their output may fall short of that of TinyMTDC sets.
+ * Such sets may be computed with TinyMTDC and checked with
+ * tinymt32_check_params() or tinymt64_check_params().
+ *
+ * A stream may also be advanced by any number of steps, in time logarithmic
+ * in the number of steps, with tinymt32_jump() and tinymt64_jump(). These
+ * compute the characteristic polynomial of the generator by the
+ * Berlekamp-Massey algorithm and apply x^n modulo it to the state by
+ * Horner's rule.
+ *
+ * See:
+ *  - Saito, M and Matsumoto, M, Tiny Mersenne Twister (TinyMT),
+ *    <http://www.math.sci.hiroshima-u.ac.jp/~m-mat/MT/TINYMT/>.
+ *  - Haramoto, H et al., Efficient Jump Ahead for F_2-Linear Random Number
+ *    Generators, INFORMS Journal on Computing 20, 385-390 (2008).
+ */
+
+#ifndef TINYMT_H_
+#define TINYMT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of built-in parameter sets of each generator. */
+#define TINYMT32_PARAMS_COUNT 16
+#define TINYMT64_PARAMS_COUNT 16
+
+/* Parameters of the tinymt32 generator. */
+typedef struct {
+  uint32_t mat1, mat2, tmat;
+} tinymt32_params_t;
+
+/* State type for the tinymt32 generator. */
+typedef struct {
+  uint32_t status[4];
+  uint32_t mat1, mat2, tmat;
+} tinymt32_state_t;
+
+/* Return built-in parameter set index, or NULL if index is not less than
+ * TINYMT32_PARAMS_COUNT. Set 0 is the default set of the reference
+ * implementation: mat1 = 0x8f7011ee, mat2 = 0xfc78ff1f, tmat = 0x3793fdff. */
+LIBRANDOM_API const tinymt32_params_t *tinymt32_params (unsigned index);
+
+/* Initialise state with the given parameters and seed, as the reference
+ * implementation. */
+LIBRANDOM_API void init_tinymt32 (tinymt32_state_t *state,
+                                  const tinymt32_params_t *params,
+                                  uint32_t seed);
+
+/* Return a 32-bit integer drawn from the uniform distribution on
+ * [0, 2^32 - 1]. */
+LIBRANDOM_API uint32_t tinymt32 (tinymt32_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of tinymt32(state). */
+LIBRANDOM_API void tinymt32_fill (tinymt32_state_t *state, uint32_t *out,
+                                  size_t n);
+
+/* Advance state by n steps, as if by n calls of tinymt32(state). */
+LIBRANDOM_API void tinymt32_jump (tinymt32_state_t *state, uint64_t n);
+
+/* Return non-zero if params give a generator of period 2^127 - 1, that is if
+ * its characteristic polynomial is irreducible (and so primitive, since
+ * 2^127 - 1 is prime) of degree 127. */
+LIBRANDOM_API int tinymt32_check_params (const tinymt32_params_t *params);
+
+/* Compute the characteristic polynomial of tinymt32 with params, storing the
+ * coefficient of x^i in bit i % 64 of phi[i / 64], and return its degree.
+ * Streams are independent if the polynomials of their parameters differ. */
+LIBRANDOM_API int tinymt32_charpoly_params (const tinymt32_params_t *params,
+                                            uint64_t phi[2]);
+
+#ifdef UINT64_C
+
+/* Parameters of the tinymt64 generator. mat1 and mat2 are 32-bit values. */
+typedef struct {
+  uint64_t mat1, mat2, tmat;
+} tinymt64_params_t;
+
+/* State type for the tinymt64 generator. The 32-bit parameters mat1 and
+ * mat2 are held in 64-bit words, so that the state is a sequence of 64-bit
+ * words. */
+typedef struct {
+  uint64_t status[2];
+  uint64_t mat1, mat2, tmat;
+} tinymt64_state_t;
+
+/* Return built-in parameter set index, or NULL if index is not less than
+ * TINYMT64_PARAMS_COUNT. Set 0 is the default set of the reference
+ * implementation: mat1 = 0xfa051f40, mat2 = 0xffd0fff4,
+ * tmat = 0x58d02ffeffbfffbc. */
+LIBRANDOM_API const tinymt64_params_t *tinymt64_params (unsigned index);
+
+/* Initialise state with the given parameters and seed, as the reference
+ * implementation. */
+LIBRANDOM_API void init_tinymt64 (tinymt64_state_t *state,
+                                  const tinymt64_params_t *params,
+                                  uint64_t seed);
+
+/* Return a 64-bit integer drawn from the uniform distribution on
+ * [0, 2^64 - 1]. */
+LIBRANDOM_API uint64_t tinymt64 (tinymt64_state_t *state);
+
+/* Fill out[0..n-1] with the next n outputs of tinymt64(state). */
+LIBRANDOM_API void tinymt64_fill (tinymt64_state_t *state, uint64_t *out,
+                                  size_t n);
+
+/* Advance state by n steps, as if by n calls of tinymt64(state). */
+LIBRANDOM_API void tinymt64_jump (tinymt64_state_t *state, uint64_t n);
+
+/* Return non-zero if params give a generator of period 2^127 - 1. */
+LIBRANDOM_API int tinymt64_check_params (const tinymt64_params_t *params);
+
+/* Compute the characteristic polynomial of tinymt64 with params, as
+ * tinymt32_charpoly_params(). */
+LIBRANDOM_API int tinymt64_charpoly_params (const tinymt64_params_t *params,
+                                            uint64_t phi[2]);
+
+#endif /* ifdef UINT64_C */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#ifdef LIBRANDOM_INLINE
+#include "tinymt.c"
+#endif /* ifdef LIBRANDOM_INLINE */
+
+#endif /* TINYMT_H_ */
@@ -0,0 +1,372 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Deviates of continuous distributions by inversion and rejection. */
+
+#include <math.h>
+
+#include "variate.h"
+#include "normal.h"
+#include "simd.h"
+#include "stats.h"
+
+/* Number of words drawn at a time, and of von Mises candidates, three words
+ * each. */
+#define BLOCK 512
+#define CANDIDATES 256
+
+#define PI 3.14159265358979323846
+#define TWO_PI 6.28318530717958647692
+
+/* Parameters of the von Mises distribution: r = s + sqrt(1 + s^2) for
+ * s = 1 / (2 kappa), and its reciprocal q. */
+typedef struct {
+  double mu, r, q;
+} von_mises_t;
+
+static von_mises_t von_mises (double mu, double kappa)
+{
+  const double s = 0.5 / kappa;
+  von_mises_t v;
+
+  v.mu = mu;
+  v.r = s + sqrt(1 + s * s);
+  v.q = 1 / v.r;
+
+  return v;
+}
+
+/* The mode of the triangular distribution as a fraction c of the interval,
+ * which is arbitrary if the interval is empty. */
+static double fraction (double low, double high, double mode)
+{
+  return high == low ? 0.5 : (mode - low) / (high - low);
+}
+
+/* cos(2 pi u) for u in [0, 1), by the C library, after the exact reduction
+ * of random_simd_sincos2pi(): the error is then relative, as it is for the
+ * batched samplers, rather than that of rounding 2 pi u. */
+static double cos2pi (double u)
+{
+  const double q = floor(4 * u + 0.5), x = TWO_PI * (u - 0.25 * q);
+
+  switch ((int) q & 3)
+  {
+    case 0:
+      return cos(x);
+    case 1:
+      return -sin(x);
+    case 2:
+      return -cos(x);
+    default:
+      return sin(x);
+  }
+}
+
+/* The loops are vectorised for each instruction set by RANDOM_SIMD_CLONES.
+ * The scalar samplers below evaluate the same expressions with the
+ * functions of the C library in place of the approximations of simd.h. */
+
+RANDOM_SIMD_INLINE void triangular_kernel (const uint64_t *restrict words,
+                                           double *restrict out, size_t n,
+                                           double low, double high, double c)
+{
+  const double d = 1 - c;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    const double u = random_simd_open(words[i]);
+    const int lower = u <= c;
+    const double v = sqrt(lower ? u * c : (1 - u) * d);
+
+    out[i] = lower ? low + (high - low) * v : high + (low - high) * v;
+  }
+}
+
+RANDOM_SIMD_INLINE void exp_kernel (double *restrict out, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    out[i] = random_simd_exp(out[i]);
+}
+
+RANDOM_SIMD_INLINE void pareto_kernel (const uint64_t *restrict words,
+                                       double *restrict out, size_t n,
+                                       double y)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    out[i] = random_simd_pow(random_simd_open(words[i]), y);
+}
+
+RANDOM_SIMD_INLINE void weibull_kernel (const uint64_t *restrict words,
+                                        double *restrict out, size_t n,
+                                        double alpha, double y)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    const double e = -random_simd_log(random_simd_open(words[i]));
+
+    out[i] = alpha * random_simd_pow(e, y);
+  }
+}
+
+/* Candidate i, from words 3 i to 3 i + 2, is the angle theta[i], and is
+ * accepted if keep[i] is non-zero, a word as wide as theta[i] so that the
+ * loop vectorises. */
+RANDOM_SIMD_INLINE void von_mises_kernel (const uint64_t *restrict words,
+                                          double *restrict theta,
+                                          uint64_t *restrict keep,
+                                          size_t n, von_mises_t v)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    const double u1 = random_simd_unit(words[3 * i]);
+    const double u2 = random_simd_unit(words[3 * i + 1]);
+    const double u3 = random_simd_unit(words[3 * i + 2]);
+    double s, z;
+
+    random_simd_sincos2pi(0.5 * u1, &s, &z);
+    {
+      const double d = z / (v.r + z);
+      const double f = (v.q + z) / (1 + v.q * z);
+      const double a = random_simd_acos(f > 1 ? 1 : (f < -1 ? -1 : f));
+      const double t = u3 > 0.5 ? v.mu + a : v.mu - a;
+      /* t less the nearest multiple of 2 pi, as floor() does not vectorise
+       * without SSE4.1, in [-pi, pi], and then in [0, 2 pi). */
+      const double k = random_simd_shifted(
+        random_simd_bits(t / TWO_PI + 0x1.8p52));
+      const double x = t - TWO_PI * k, y = x < 0 ? x + TWO_PI : x;
+
+      keep[i] = (u2 < 1 - d * d) | (u2 <= (1 - d) * random_simd_exp(d));
+      theta[i] = y < TWO_PI ? y : 0;
+    }
+  }
+}
+
+RANDOM_SIMD_INLINE void uniform_angle_kernel (const uint64_t *restrict words,
+                                              double *restrict out, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    out[i] = TWO_PI * random_simd_unit(words[i]);
+}
+
+RANDOM_SIMD_CLONES(triangular, (const uint64_t *restrict words,
+                                double *restrict out, size_t n, double low,
+                                double high, double c),
+                   triangular_kernel(words, out, n, low, high, c))
+RANDOM_SIMD_CLONES(exp, (double *restrict out, size_t n),
+                   exp_kernel(out, n))
+RANDOM_SIMD_CLONES(pareto, (const uint64_t *restrict words,
+                            double *restrict out, size_t n, double y),
+                   pareto_kernel(words, out, n, y))
+RANDOM_SIMD_CLONES(weibull, (const uint64_t *restrict words,
+                             double *restrict out, size_t n, double alpha,
+                             double y),
+                   weibull_kernel(words, out, n, alpha, y))
+RANDOM_SIMD_CLONES(von_mises, (const uint64_t *restrict words,
+                               double *restrict theta,
+                               uint64_t *restrict keep, size_t n,
+                               von_mises_t v),
+                   von_mises_kernel(words, theta, keep, n, v))
+RANDOM_SIMD_CLONES(uniform_angle, (const uint64_t *restrict words,
+                                   double *restrict out, size_t n),
+                   uniform_angle_kernel(words, out, n))
+
+void random_triangular_fill (random_t *rng, double low, double high,
+                             double mode, double *out, size_t n)
+{
+  const double c = fraction(low, high, mode);
+  uint64_t words[BLOCK];
+  size_t m;
+
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < BLOCK ? n : BLOCK;
+    random_fill64_distribution(rng, words, m);
+    RANDOM_SIMD_DISPATCH(triangular, (words, out, m, low, high, c));
+  }
+}
+
+double random_triangular (random_t *rng, double low, double high,
+                          double mode)
+{
+  const double c = fraction(low, high, mode), d = 1 - c;
+  uint64_t w;
+  double u;
+
+  random_fill64_distribution(rng, &w, 1);
+  u = random_simd_open(w);
+
+  if (u <= c)
+    return low + (high - low) * sqrt(u * c);
+  else
+    return high + (low - high) * sqrt((1 - u) * d);
+}
+
+void random_lognormvariate_fill (random_t *rng, double mu, double sigma,
+                                 double *out, size_t n)
+{
+  size_t m;
+
+  /* BLOCK is even, so the words are paired as by a single call of
+   * random_normal_fill(). */
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < BLOCK ? n : BLOCK;
+    random_normal_fill(rng, mu, sigma, out, m);
+    RANDOM_SIMD_DISPATCH(exp, (out, m));
+  }
+}
+
+double random_lognormvariate (random_t *rng, double mu, double sigma)
+{
+  uint64_t w[2];
+  double z;
+
+  random_fill64_distribution(rng, w, 2);
+  z = sqrt(-2 * log(random_simd_open(w[0])))
+      * cos2pi(random_simd_unit(w[1]));
+
+  return exp(mu + sigma * z);
+}
+
+void random_paretovariate_fill (random_t *rng, double alpha, double *out,
+                                size_t n)
+{
+  const double y = -1 / alpha;
+  uint64_t words[BLOCK];
+  size_t m;
+
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < BLOCK ? n : BLOCK;
+    random_fill64_distribution(rng, words, m);
+    RANDOM_SIMD_DISPATCH(pareto, (words, out, m, y));
+  }
+}
+
+double random_paretovariate (random_t *rng, double alpha)
+{
+  uint64_t w;
+
+  random_fill64_distribution(rng, &w, 1);
+
+  return pow(random_simd_open(w), -1 / alpha);
+}
+
+void random_weibullvariate_fill (random_t *rng, double alpha, double beta,
+                                 double *out, size_t n)
+{
+  const double y = 1 / beta;
+  uint64_t words[BLOCK];
+  size_t m;
+
+  for (; n > 0; n -= m, out += m)
+  {
+    m = n < BLOCK ? n : BLOCK;
+    random_fill64_distribution(rng, words, m);
+    RANDOM_SIMD_DISPATCH(weibull, (words, out, m, alpha, y));
+  }
+}
+
+double random_weibullvariate (random_t *rng, double alpha, double beta)
+{
+  uint64_t w;
+
+  random_fill64_distribution(rng, &w, 1);
+
+  return alpha * pow(-log(random_simd_open(w)), 1 / beta);
+}
+
+void random_vonmisesvariate_fill (random_t *rng, double mu, double kappa,
+                                  double *out, size_t n)
+{
+  const von_mises_t v = von_mises(mu, kappa);
+  uint64_t words[3 * CANDIDATES];
+  double theta[CANDIDATES];
+  uint64_t keep[CANDIDATES];
+  size_t i, m, rejected;
+
+  if (kappa <= 1e-6)
+  {
+    for (; n > 0; n -= m, out += m)
+    {
+      m = n < BLOCK ? n : BLOCK;
+      random_fill64_distribution(rng, words, m);
+      RANDOM_SIMD_DISPATCH(uniform_angle, (words, out, m));
+    }
+    return;
+  }
+
+  while (n > 0)
+  {
+    random_fill64_distribution(rng, words, 3 * CANDIDATES);
+    RANDOM_SIMD_DISPATCH(von_mises, (words, theta, keep, CANDIDATES, v));
+
+    /* Candidates after the last deviate needed are neither accepted nor
+     * rejected. */
+    for (i = rejected = 0; i < CANDIDATES && n > 0; i++)
+    {
+      if (keep[i])
+      {
+        *out++ = theta[i];
+        n--;
+      }
+      else
+      {
+        rejected++;
+      }
+    }
+    RANDOM_STATS_REJECT(rng->id, rejected);
+  }
+}
+
+double random_vonmisesvariate (random_t *rng, double mu, double kappa)
+{
+  const von_mises_t v = von_mises(mu, kappa);
+  uint64_t w[3];
+  double z, d, f, t, x;
+
+  if (kappa <= 1e-6)
+  {
+    random_fill64_distribution(rng, w, 1);
+    return TWO_PI * random_simd_unit(w[0]);
+  }
+
+  for (;;)
+  {
+    double u2;
+
+    random_fill64_distribution(rng, w, 3);
+    z = cos(PI * random_simd_unit(w[0]));
+    d = z / (v.r + z);
+    u2 = random_simd_unit(w[1]);
+    if (u2 < 1 - d * d || u2 <= (1 - d) * exp(d))
+      break;
+    RANDOM_STATS_REJECT(rng->id, 1);
+  }
+
+  f = (v.q + z) / (1 + v.q * z);
+  f = f > 1 ? 1 : (f < -1 ? -1 : f);
+  t = random_simd_unit(w[2]) > 0.5 ? mu + acos(f) : mu - acos(f);
+  x = t - TWO_PI * floor(t / TWO_PI);
+
+  return x < TWO_PI ? x : 0;
+}
+
+#undef BLOCK
+#undef CANDIDATES
+#undef PI
+#undef TWO_PI
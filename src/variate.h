@@ -0,0 +1,109 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Deviates of continuous distributions from any of the generators of
+ * generator.h, with the parameters of the functions of Python's random
+ * module.
+ *
+ * Each distribution has a batched sampler, random_*_fill(), and a scalar
+ * one. The batched samplers draw a block of words, map them to uniform
+ * deviates on (0, 1) or [0, 1) as normal.h does, and transform them by the
+ * inverse of the distribution function, in loops vectorised as in simd.h
+ * with its approximations of exp, log and pow; like those of normal.h, their
+ * results do not depend on the instruction set. The scalar samplers are the
+ * reference versions: they draw the same words, one variate at a time, and
+ * evaluate the same expressions with the functions of the C library in place
+ * of the approximations of simd.h. The two agree within
+ * the accuracy of the approximations of simd.h, which for the heavy-tailed
+ * distributions is relative, a few ulp times the magnitude of the argument
+ * of exp.
+ *
+ *  - Triangular: for u on (0, 1), with c = (mode - low) / (high - low),
+ *    low + (high - low) sqrt(u c) if u <= c, and otherwise
+ *    high + (low - high) sqrt((1 - u) (1 - c)). The batched and scalar
+ *    samplers give identical results.
+ *  - Log-normal: exp(mu + sigma z) for the standard normal deviates z of
+ *    random_normal_fill(). The scalar sampler takes z from the first of a
+ *    pair of words, with the Box-Muller transform evaluated by the C
+ *    library after the exact reduction of simd.h; the two agree within
+ *    (2 |mu| + 4 |sigma z| + 4) ulp.
+ *  - Pareto, of shape alpha on [1, inf): u^(-1 / alpha), for u on (0, 1).
+ *  - Weibull, of scale alpha and shape beta: alpha (-log u)^(1 / beta).
+ *  - Von Mises, of mean angle mu and concentration kappa, on [0, 2 pi): by
+ *    the rejection method of Best and Fisher, which takes three words for
+ *    each candidate. The batched sampler finds the candidates of a block and
+ *    whether each is accepted in a vectorised loop, then keeps those
+ *    accepted. For kappa <= 1e-6 the distribution is taken to be uniform.
+ *
+ * Words consumed are counted as outputs of the distribution API of stats.h,
+ * and rejected von Mises candidates as rejections.
+ *
+ * See:
+ *  - Best, D J and Fisher, N I, *Efficient Simulation of the von Mises
+ *    Distribution*, Applied Statistics **28**, 152-7 (1979).
+ */
+
+#ifndef VARIATE_H_
+#define VARIATE_H_
+
+#include <stddef.h>
+
+#include "generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fill out[0..n-1] with deviates of the triangular distribution on
+ * [low, high] with the given mode, one word each. */
+void random_triangular_fill (random_t *rng, double low, double high,
+                             double mode, double *out, size_t n);
+
+/* Return a deviate of the triangular distribution, from one word. */
+double random_triangular (random_t *rng, double low, double high,
+                          double mode);
+
+/* Fill out[0..n-1] with deviates of the log-normal distribution whose
+ * logarithm has mean mu and standard deviation sigma, drawing words as
+ * random_normal_fill(). */
+void random_lognormvariate_fill (random_t *rng, double mu, double sigma,
+                                 double *out, size_t n);
+
+/* Return a deviate of the log-normal distribution, from the first normal
+ * deviate of a pair of words. */
+double random_lognormvariate (random_t *rng, double mu, double sigma);
+
+/* Fill out[0..n-1] with deviates of the Pareto distribution of shape alpha,
+ * one word each. */
+void random_paretovariate_fill (random_t *rng, double alpha, double *out,
+                                size_t n);
+
+/* Return a deviate of the Pareto distribution, from one word. */
+double random_paretovariate (random_t *rng, double alpha);
+
+/* Fill out[0..n-1] with deviates of the Weibull distribution of scale alpha
+ * and shape beta, one word each. */
+void random_weibullvariate_fill (random_t *rng, double alpha, double beta,
+                                 double *out, size_t n);
+
+/* Return a deviate of the Weibull distribution, from one word. */
+double random_weibullvariate (random_t *rng, double alpha, double beta);
+
+/* Fill out[0..n-1] with deviates of the von Mises distribution of mean
+ * angle mu and concentration kappa. Candidates are drawn a block at a time,
+ * and those left over are discarded, so the words consumed are not those of
+ * n calls of random_vonmisesvariate(), although the deviates are. */
+void random_vonmisesvariate_fill (random_t *rng, double mu, double kappa,
+                                  double *out, size_t n);
+
+/* Return a deviate of the von Mises distribution, drawing three words for
+ * each candidate. */
+double random_vonmisesvariate (random_t *rng, double mu, double kappa);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* VARIATE_H_ */
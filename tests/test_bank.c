@@ -0,0 +1,155 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for structure-of-arrays banks of streams. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../src/bank.h"
+
+/* Not a multiple of the vector width, to exercise the loop remainders. */
+#define STREAMS 1003
+#define STEPS 100
+
+int main(void)
+{
+  kiss64_state_t seeder = { UINT64_C(1066149217761810),
+                            UINT64_C(362436362436362436),
+                            UINT64_C(1234567890987654321),
+                            UINT64_C(123456123456123456) };
+  uint32_t *out = malloc(STREAMS * sizeof(uint32_t));
+  uint8_t *mask = malloc(STREAMS);
+
+  /* kiss32: step all streams, then a varying subset of them. */
+  kiss32_state_t *kiss32_states = malloc(STREAMS * sizeof(kiss32_state_t));
+  kiss32_state_t *kiss32_check = malloc(STREAMS * sizeof(kiss32_state_t));
+  kiss32_bank_t kiss32_bank;
+
+  for (int i = 0; i < STREAMS; i++)
+  {
+    kiss32_states[i].mx = kiss64(&seeder);
+    kiss32_states[i].my = kiss64(&seeder) | 1;
+    kiss32_states[i].mz = kiss64(&seeder);
+    kiss32_states[i].mc = kiss64(&seeder) % UINT32_C(698769069);
+  }
+
+  assert(kiss32_bank_init(&kiss32_bank, STREAMS) == 0);
+  assert((uintptr_t) kiss32_bank.mx % RANDOM_BANK_ALIGN == 0);
+  assert((uintptr_t) kiss32_bank.mc % RANDOM_BANK_ALIGN == 0);
+  kiss32_bank_load(&kiss32_bank, kiss32_states);
+
+  for (int k = 0; k < STEPS; k++)
+  {
+    kiss32_bank_step_all(&kiss32_bank, out);
+    for (int i = 0; i < STREAMS; i++)
+      assert(out[i] == kiss32(&kiss32_states[i]));
+  }
+
+  for (int k = 0; k < STEPS; k++)
+  {
+    for (int i = 0; i < STREAMS; i++)
+    {
+      mask[i] = (i + k) % 3 == 0;
+      out[i] = UINT32_C(0xdeadbeef);
+    }
+
+    kiss32_bank_step_masked(&kiss32_bank, mask, out);
+    for (int i = 0; i < STREAMS; i++)
+      assert(out[i] == (mask[i] ? kiss32(&kiss32_states[i])
+                                : UINT32_C(0xdeadbeef)));
+  }
+
+  kiss32_bank_store(&kiss32_bank, kiss32_check);
+  assert(memcmp(kiss32_states, kiss32_check,
+                STREAMS * sizeof(kiss32_state_t)) == 0);
+  kiss32_bank_free(&kiss32_bank);
+
+  /* taus88 */
+  taus88_state_t *taus88_states = malloc(STREAMS * sizeof(taus88_state_t));
+  taus88_state_t *taus88_check = malloc(STREAMS * sizeof(taus88_state_t));
+  taus88_bank_t taus88_bank;
+
+  for (int i = 0; i < STREAMS; i++)
+  {
+    taus88_states[i].s1 = kiss64(&seeder) | 2;
+    taus88_states[i].s2 = kiss64(&seeder) | 8;
+    taus88_states[i].s3 = kiss64(&seeder) | 16;
+  }
+
+  assert(taus88_bank_init(&taus88_bank, STREAMS) == 0);
+  taus88_bank_load(&taus88_bank, taus88_states);
+
+  for (int k = 0; k < STEPS; k++)
+  {
+    for (int i = 0; i < STREAMS; i++)
+      mask[i] = (i * 7 + k) % 5 < 2;
+
+    taus88_bank_step_all(&taus88_bank, out);
+    for (int i = 0; i < STREAMS; i++)
+      assert(out[i] == taus88(&taus88_states[i]));
+
+    taus88_bank_step_masked(&taus88_bank, mask, out);
+    for (int i = 0; i < STREAMS; i++)
+    {
+      if (mask[i])
+        assert(out[i] == taus88(&taus88_states[i]));
+    }
+  }
+
+  taus88_bank_store(&taus88_bank, taus88_check);
+  assert(memcmp(taus88_states, taus88_check,
+                STREAMS * sizeof(taus88_state_t)) == 0);
+  taus88_bank_free(&taus88_bank);
+
+  /* lfsr113 */
+  lfsr113_state_t *lfsr113_states = malloc(STREAMS * sizeof(lfsr113_state_t));
+  lfsr113_state_t *lfsr113_check = malloc(STREAMS * sizeof(lfsr113_state_t));
+  lfsr113_bank_t lfsr113_bank;
+
+  for (int i = 0; i < STREAMS; i++)
+  {
+    lfsr113_states[i].s1 = kiss64(&seeder) | 2;
+    lfsr113_states[i].s2 = kiss64(&seeder) | 8;
+    lfsr113_states[i].s3 = kiss64(&seeder) | 16;
+    lfsr113_states[i].s4 = kiss64(&seeder) | 128;
+  }
+
+  assert(lfsr113_bank_init(&lfsr113_bank, STREAMS) == 0);
+  lfsr113_bank_load(&lfsr113_bank, lfsr113_states);
+
+  for (int k = 0; k < STEPS; k++)
+  {
+    for (int i = 0; i < STREAMS; i++)
+      mask[i] = (i * 7 + k) % 5 < 2;
+
+    lfsr113_bank_step_all(&lfsr113_bank, out);
+    for (int i = 0; i < STREAMS; i++)
+      assert(out[i] == lfsr113(&lfsr113_states[i]));
+
+    lfsr113_bank_step_masked(&lfsr113_bank, mask, out);
+    for (int i = 0; i < STREAMS; i++)
+    {
+      if (mask[i])
+        assert(out[i] == lfsr113(&lfsr113_states[i]));
+    }
+  }
+
+  lfsr113_bank_store(&lfsr113_bank, lfsr113_check);
+  assert(memcmp(lfsr113_states, lfsr113_check,
+                STREAMS * sizeof(lfsr113_state_t)) == 0);
+  lfsr113_bank_free(&lfsr113_bank);
+
+  /* An empty bank is valid. */
+  assert(lfsr113_bank_init(&lfsr113_bank, 0) == 0);
+  lfsr113_bank_step_all(&lfsr113_bank, out);
+  lfsr113_bank_free(&lfsr113_bank);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for random bits and bit-sliced Bernoulli trials. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+
+#include "../src/bits.h"
+
+#define WORDS 4096
+#define MASKS 100000
+
+/* Bit i of the words w. */
+static unsigned bit_of (const uint64_t *w, size_t i)
+{
+  return (unsigned) (w[i / 64] >> (i % 64)) & 1;
+}
+
+int main(void)
+{
+  uint64_t *words = malloc(WORDS * sizeof(uint64_t));
+  uint64_t *out = malloc(WORDS * sizeof(uint64_t));
+  random_bits_t bits;
+  random_t rng, copy;
+  size_t pos, i;
+
+  /* The stream is the bits of random_fill64(), from the least significant
+   * bit of each word, whatever the size of the fields taken; a 32-bit
+   * generator exercises random_fill64() pairing its outputs. */
+  const random_generator_id_t ids[] = { RANDOM_MT19937AR, RANDOM_PCG64 };
+
+  for (int g = 0; g < 2; g++)
+  {
+    assert(random_init(&rng, ids[g], 1, 2) == 0);
+    copy = rng;
+    random_fill64(&copy, words, WORDS);
+    random_bits_init(&bits, &rng);
+
+    for (pos = 0; pos < 1000; pos++)
+      assert(random_bit(&bits) == bit_of(words, pos));
+    for (unsigned k = 0; k <= 64; k++)
+    {
+      const uint64_t v = random_bits(&bits, k);
+
+      for (unsigned j = 0; j < 64; j++)
+        assert(((v >> j) & 1) == (j < k ? bit_of(words, pos + j) : 0));
+      pos += k;
+    }
+
+    /* Packed arrays, starting within a word and ending within one. */
+    random_bits_fill(&bits, out, 1000);
+    for (i = 0; i < 1024; i++)
+      assert(bit_of(out, i) == (i < 1000 ? bit_of(words, pos + i) : 0));
+    pos += 1000;
+
+    /* And whole words, from the buffer and then the generator. */
+    random_bits(&bits, 64 - pos % 64);
+    pos += 64 - pos % 64;
+    random_bits_fill(&bits, out, 64 * 200);
+    for (i = 0; i < 200; i++)
+      assert(out[i] == words[pos / 64 + i]);
+    pos += 64 * 200;
+    assert(random_bits(&bits, 3) == (words[pos / 64] & 7));
+  }
+
+  /* Trials with probabilities 0, 1 and 1/2 are exact; 1/2 takes one word,
+   * and the others none. */
+  assert(random_init(&rng, RANDOM_KISS64, 3, 4) == 0);
+  copy = rng;
+  random_fill64(&copy, words, 2);
+  random_bits_init(&bits, &rng);
+  assert(random_bernoulli64(&bits, 0) == 0);
+  assert(random_bernoulli64(&bits, -1) == 0);
+  assert(random_bernoulli64(&bits, NAN) == 0);
+  assert(random_bernoulli64(&bits, 1) == ~UINT64_C(0));
+  assert(random_bernoulli64(&bits, 0.5) == ~words[0]);
+  assert(random_bits(&bits, 64) == words[1]);
+
+  /* 0.75 = 0.11 (binary): lanes succeed at their first zero among two. */
+  copy = rng;
+  random_fill64(&copy, words, 2);
+  random_bits_init(&bits, &rng);
+  assert(random_bernoulli64(&bits, 0.75) == ~(words[0] & words[1]));
+
+  /* Frequencies, and the number of words per mask. */
+  const double probabilities[] = { 0.3, 0.5, 0.9, 1e-3, 1e-300, 0.1 };
+
+  for (size_t t = 0; t < sizeof(probabilities) / sizeof(double); t++)
+  {
+    const double p = probabilities[t];
+    const double sd = sqrt(64.0 * MASKS * p * (1 - p));
+    double ones = 0, used = 0;
+
+    random_bits_init(&bits, &rng);
+    for (i = 0; i < MASKS; i++)
+    {
+      const uint64_t before = bits.next;
+
+      ones += __builtin_popcountll(random_bernoulli64(&bits, p));
+      used += (bits.next + RANDOM_BITS_BUFFER - before) % RANDOM_BITS_BUFFER;
+    }
+
+    assert(fabs(ones - 64.0 * MASKS * p) < 5 * sd + 1);
+    assert(used / MASKS < 8);
+  }
+
+  /* Packed trials are masks of random_bernoulli64(), the last truncated. */
+  random_bits_init(&bits, &rng);
+  copy = rng;
+  random_bernoulli_fill(&bits, 0.3, out, 1000);
+  rng = copy;
+  random_bits_init(&bits, &rng);
+  for (i = 0; i < 16; i++)
+  {
+    const uint64_t mask = random_bernoulli64(&bits, 0.3);
+
+    assert(out[i] == (i < 15 ? mask : mask & ((UINT64_C(1) << 40) - 1)));
+  }
+
+  random_bernoulli_fill(&bits, 1, out, 70);
+  assert(out[0] == ~UINT64_C(0) && out[1] == 63);
+
+  free(words);
+  free(out);
+
+  return EXIT_SUCCESS;
+}
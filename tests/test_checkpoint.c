@@ -0,0 +1,257 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for checkpoints of generator states. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "../src/checkpoint.h"
+#include "../src/kiss.h"
+#include "../src/dcmt.h"
+#include "../src/mt19937.h"
+#include "../src/pcg.h"
+
+#define COUNT 5000
+
+static uint32_t load_le32 (const unsigned char *p)
+{
+  return (uint32_t) p[0] | (uint32_t) p[1] << 8
+       | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/* Compare the meaningful bytes, excluding any padding, of n states. */
+static int states_equal (const random_generator_info_t *info,
+                         const unsigned char *a, const unsigned char *b,
+                         size_t n)
+{
+  size_t used = info->state_words * (info->word_bits / 8)
+              + (info->state_index ? 4 : 0);
+
+  for (size_t i = 0; i < n; i++)
+  {
+    if (memcmp(a + i * info->state_size, b + i * info->state_size, used))
+      return 0;
+  }
+
+  return 1;
+}
+
+int main(void)
+{
+  kiss64_state_t kiss64_state = { UINT64_C(1066149217761810),
+                                  UINT64_C(362436362436362436),
+                                  UINT64_C(1234567890987654321),
+                                  UINT64_C(123456123456123456) };
+  char path[] = "/tmp/test_checkpoint_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  /* The layout of the state types is that described by the generator info. */
+  assert(offsetof(mt19937ar_state_t, mti) == 4 * MT19937AR_N);
+  assert(offsetof(mt19937_64_state_t, mti) == 8 * MT19937_64_NN);
+
+  for (int id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    const random_generator_info_t *info = random_generator_info(id);
+    size_t bytes = COUNT * info->state_size;
+    unsigned char *states = malloc(bytes);
+    unsigned char *loaded = malloc(bytes);
+    size_t count = 0;
+
+    assert(info != NULL);
+    assert(info->state_size >= info->state_words * info->word_bits / 8);
+
+    /* Arbitrary contents are enough to test a round trip, except that
+     * states with an index must be valid, so those are seeded. */
+    kiss64_fill(&kiss64_state, (uint64_t *) loaded, bytes / 8);
+    for (size_t i = 0; info->state_index && i < COUNT; i++)
+    {
+      random_t rng;
+
+      assert(random_init(&rng, id, 7, i) == 0);
+      memcpy(loaded + i * info->state_size, &rng.state, info->state_size);
+    }
+    memcpy(states, loaded, bytes);
+
+    /* Save and restore through a stream. */
+    FILE *stream = tmpfile();
+    assert(random_checkpoint_write(stream, id, states, COUNT) == 0);
+    rewind(stream);
+    memset(loaded, 0, bytes);
+    assert(random_checkpoint_read(stream, id, loaded, COUNT, &count) == 0);
+    assert(count == COUNT);
+    assert(states_equal(info, states, loaded, COUNT));
+
+    /* Reading into too small a buffer, or as another generator, fails. */
+    rewind(stream);
+    assert(random_checkpoint_read(stream, id, loaded, COUNT - 1, &count)
+           == RANDOM_CHECKPOINT_ECOUNT);
+    rewind(stream);
+    assert(random_checkpoint_read(stream, (id + 1) % RANDOM_GENERATOR_COUNT,
+                                  loaded, COUNT, &count)
+           == RANDOM_CHECKPOINT_EGENERATOR);
+
+    /* Corruption of any record is detected. */
+    fseek(stream, RANDOM_CHECKPOINT_HEADER_SIZE + bytes / 2, SEEK_SET);
+    int c = fgetc(stream);
+    fseek(stream, RANDOM_CHECKPOINT_HEADER_SIZE + bytes / 2, SEEK_SET);
+    fputc(c ^ 0x10, stream);
+    rewind(stream);
+    assert(random_checkpoint_read(stream, id, loaded, COUNT, &count)
+           == RANDOM_CHECKPOINT_ECHECKSUM);
+    fclose(stream);
+
+    /* Map a saved checkpoint without copying it. */
+    random_checkpoint_map_t map;
+    assert(random_checkpoint_save(path, id, states, COUNT) == 0);
+    assert(random_checkpoint_map(path, &map, 1) == 0);
+    assert(map.header.generator == (random_generator_id_t) id);
+    assert(map.header.count == COUNT);
+    assert(states_equal(info, states, map.states, COUNT));
+
+    /* Modifying mapped states does not modify the file. */
+    memset(map.states, 0, bytes);
+    random_checkpoint_unmap(&map);
+    assert(random_checkpoint_load(path, id, loaded, COUNT, &count) == 0);
+    assert(states_equal(info, states, loaded, COUNT));
+
+    free(states);
+    free(loaded);
+  }
+
+  /* A restored Mersenne Twister continues where the original left off. */
+  mt19937ar_state_t *mt = malloc(2 * sizeof(mt19937ar_state_t));
+  size_t count;
+
+  init_mt19937ar_r(&mt[0], UINT32_C(5489));
+  for (int i = 0; i < 1000; i++)
+  {
+    mt19937ar_r(&mt[0]);
+  }
+
+  assert(random_checkpoint_save(path, RANDOM_MT19937AR, mt, 1) == 0);
+  assert(random_checkpoint_load(path, RANDOM_MT19937AR, &mt[1], 1, &count)
+         == 0);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(mt19937ar_r(&mt[0]) == mt19937ar_r(&mt[1]));
+  }
+
+  /* So does the state of mt19937ar() itself. */
+  uint32_t outputs[5];
+
+  init_mt19937ar(UINT32_C(5489));
+  mt19937ar_get_state(&mt[0]);
+  assert(random_checkpoint_save(path, RANDOM_MT19937AR, mt, 1) == 0);
+  for (int i = 0; i < 5; i++)
+  {
+    outputs[i] = mt19937ar();
+  }
+  assert(random_checkpoint_load(path, RANDOM_MT19937AR, &mt[1], 1, &count)
+         == 0);
+  mt19937ar_set_state(&mt[1]);
+  for (int i = 0; i < 5; i++)
+  {
+    assert(mt19937ar() == outputs[i]);
+  }
+
+  /* States which would be stepped outside their arrays are rejected when
+   * read, and when mapped even without verifying the checksum. */
+  random_checkpoint_map_t map;
+  dcmt_state_t *dc = malloc(sizeof(dcmt_state_t));
+  const dcmt_params_t params = DCMT_PARAMS_MT19937;
+
+  mt[0].mti = MT19937AR_N + 1;
+  assert(random_checkpoint_save(path, RANDOM_MT19937AR, mt, 1) == 0);
+  assert(random_checkpoint_load(path, RANDOM_MT19937AR, &mt[1], 1, &count)
+         == 0);
+  mt[0].mti = -1;
+  assert(random_checkpoint_save(path, RANDOM_MT19937AR, mt, 1) == 0);
+  assert(random_checkpoint_load(path, RANDOM_MT19937AR, &mt[1], 1, &count)
+         == RANDOM_CHECKPOINT_ESTATE);
+  assert(random_checkpoint_map(path, &map, 0) == RANDOM_CHECKPOINT_ESTATE);
+  mt[0].mti = MT19937AR_N + 2;
+  assert(random_checkpoint_save(path, RANDOM_MT19937AR, mt, 1) == 0);
+  assert(random_checkpoint_map(path, &map, 1) == RANDOM_CHECKPOINT_ESTATE);
+
+  init_dcmt(dc, &params, 1);
+  assert(random_checkpoint_save(path, RANDOM_DCMT, dc, 1) == 0);
+  assert(random_checkpoint_map(path, &map, 0) == 0);
+  random_checkpoint_unmap(&map);
+  dc->params.nn = DCMT_MAX_N + 1;
+  dc->params.mexp = 32 * dc->params.nn - dc->params.rr;
+  assert(random_checkpoint_save(path, RANDOM_DCMT, dc, 1) == 0);
+  assert(random_checkpoint_load(path, RANDOM_DCMT, dc, 1, &count)
+         == RANDOM_CHECKPOINT_ESTATE);
+  assert(random_checkpoint_map(path, &map, 0) == RANDOM_CHECKPOINT_ESTATE);
+  init_dcmt(dc, &params, 1);
+  dc->mti = (int32_t) params.nn + 2;
+  assert(random_checkpoint_save(path, RANDOM_DCMT, dc, 1) == 0);
+  assert(random_checkpoint_map(path, &map, 0) == RANDOM_CHECKPOINT_ESTATE);
+  free(dc);
+
+  /* The format is little-endian regardless of the host. */
+  kiss64_state_t kiss64_states[1] = { { UINT64_C(0x0102030405060708), 0, 0,
+                                        0 } };
+  unsigned char raw[RANDOM_CHECKPOINT_HEADER_SIZE + sizeof(kiss64_state_t)];
+  FILE *stream;
+
+  assert(random_checkpoint_save(path, RANDOM_KISS64, kiss64_states, 1) == 0);
+  stream = fopen(path, "rb");
+  assert(fread(raw, sizeof(raw), 1, stream) == 1);
+  assert(fgetc(stream) == EOF);
+  fclose(stream);
+
+  assert(memcmp(raw, "LIBRNDCK", 8) == 0);
+  assert(raw[8] == RANDOM_CHECKPOINT_VERSION && raw[12] == RANDOM_KISS64);
+  assert(raw[16] == 64 && raw[20] == sizeof(kiss64_state_t) && raw[24] == 1);
+  assert(raw[64] == 0x08 && raw[65] == 0x07 && raw[71] == 0x01);
+
+  /* Records are packed, whatever the padding of the state type. */
+  mt19937_64_state_t *mt64 = calloc(1, sizeof(mt19937_64_state_t));
+  long size;
+
+  mt64->mti = 0x01020304;
+  assert(random_checkpoint_save(path, RANDOM_MT19937_64, mt64, 1) == 0);
+  stream = fopen(path, "rb");
+  assert(fread(raw, RANDOM_CHECKPOINT_HEADER_SIZE, 1, stream) == 1);
+  assert(load_le32(raw + 20) == 8 * MT19937_64_NN + 4);
+  fseek(stream, RANDOM_CHECKPOINT_HEADER_SIZE + 8 * MT19937_64_NN, SEEK_SET);
+  assert(fgetc(stream) == 0x04);
+  fseek(stream, 0, SEEK_END);
+  size = ftell(stream);
+  assert(size == RANDOM_CHECKPOINT_HEADER_SIZE + 8 * MT19937_64_NN + 4);
+  fclose(stream);
+  free(mt64);
+
+  /* 128-bit PCG values are stored low word first. */
+  pcg64_state_t pcg_states[1] = { { PCG128(UINT64_C(0x0102030405060708),
+                                           UINT64_C(0x1112131415161718)),
+                                    PCG128(0, 1) } };
+  unsigned char record[32];
+
+  assert(random_checkpoint_save(path, RANDOM_PCG64, pcg_states, 1) == 0);
+  stream = fopen(path, "rb");
+  fseek(stream, RANDOM_CHECKPOINT_HEADER_SIZE, SEEK_SET);
+  assert(fread(record, sizeof(record), 1, stream) == 1);
+  fclose(stream);
+  assert(load_le32(record) == UINT32_C(0x15161718));
+  assert(load_le32(record + 12) == UINT32_C(0x01020304));
+  assert(record[16] == 1 && record[24] == 0);
+
+  remove(path);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for the Dynamic Creator and the dcmt generator. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+#include "../src/creator.h"
+#include "../src/mt19937.h"
+
+#define MEXP 521
+#define SEED UINT64_C(4172)
+#define COUNT 3
+
+static int count_lines (const char *path)
+{
+  FILE *stream = fopen(path, "r");
+  int c, lines = 0;
+
+  assert(stream != NULL);
+  while ((c = fgetc(stream)) != EOF)
+    lines += c == '\n';
+  fclose(stream);
+
+  return lines;
+}
+
+int main(void)
+{
+  /* With the parameters of MT19937, dcmt reproduces mt19937ar. */
+  const dcmt_params_t mt19937 = DCMT_PARAMS_MT19937;
+  mt19937ar_state_t mt19937ar_state;
+  dcmt_state_t *state = malloc(sizeof(dcmt_state_t));
+  dcmt_state_t *copy = malloc(sizeof(dcmt_state_t));
+  uint32_t buffer[2000];
+
+  init_mt19937ar_r(&mt19937ar_state, UINT32_C(5489));
+  init_dcmt(state, &mt19937, UINT32_C(5489));
+  for (int i = 0; i < 2000; i++)
+  {
+    assert(dcmt(state) == mt19937ar_r(&mt19937ar_state));
+  }
+
+  /* Bulk generation must reproduce the scalar generator. */
+  *copy = *state;
+  dcmt_fill(copy, buffer, 2000);
+  for (int i = 0; i < 2000; i++)
+  {
+    assert(buffer[i] == dcmt(state));
+  }
+
+  /* Search for a few streams. */
+  dcmt_params_t params[COUNT], single, cached[COUNT];
+  unsigned k[32];
+
+  assert(dcmt_supported(MEXP));
+  assert(!dcmt_supported(19937));
+  assert(!dcmt_supported(520));
+  assert(dcmt_create(520, SEED, 0, &single) == -1);
+  assert(dcmt_create(MEXP, SEED, DCMT_MAX_ID + 1, &single) == -1);
+
+  assert(dcmt_create_parallel(MEXP, SEED, 0, COUNT, params, 2) == 0);
+  for (int i = 0; i < COUNT; i++)
+  {
+    assert(params[i].mexp == MEXP);
+    assert((params[i].aaa & DCMT_MAX_ID) == (uint32_t) i);
+    assert(dcmt_check_params(&params[i]));
+  }
+
+  /* The search does not depend on the number of threads. */
+  assert(dcmt_create(MEXP, SEED, 1, &single) == 0);
+  assert(memcmp(&single, &params[1], sizeof(single)) == 0);
+
+  /* Different streams give different sequences, once the twists have
+   * spread through the state. */
+  init_dcmt(state, &params[0], UINT32_C(5489));
+  init_dcmt(copy, &params[1], UINT32_C(5489));
+  dcmt_fill(state, buffer, 2000);
+  dcmt_fill(copy, buffer, 2000);
+  for (int i = 0; i < 100; i++)
+  {
+    assert(dcmt(state) != dcmt(copy));
+  }
+
+  /* A twist vector without its top bit does not give a full period. */
+  single = params[0];
+  single.aaa &= UINT32_C(0x7fffffff);
+  assert(!dcmt_check_params(&single));
+
+  /* The top bit of the output is equidistributed in mexp dimensions, and
+   * the tempering improves on masks of zero. */
+  int defect = 0, defect0 = 0;
+
+  assert(dcmt_equidistribution(&params[0], k) == 0);
+  assert(k[0] == MEXP);
+  for (int v = 1; v <= 32; v++)
+  {
+    assert(k[v - 1] <= (unsigned) (MEXP / v));
+    defect += MEXP / v - k[v - 1];
+  }
+
+  single = params[0];
+  single.maskB = single.maskC = 0;
+  assert(dcmt_equidistribution(&single, k) == 0);
+  for (int v = 1; v <= 32; v++)
+    defect0 += MEXP / v - k[v - 1];
+  assert(defect < defect0);
+
+  /* The parameter database. */
+  char path[] = "/tmp/librandom_dcmt_XXXXXX";
+  int fd = mkstemp(path);
+
+  assert(fd >= 0);
+  close(fd);
+  remove(path);
+
+  assert(dcmt_create_cached(path, MEXP, SEED, 0, 2, cached, 0) == 0);
+  assert(count_lines(path) == 3);
+  assert(memcmp(cached, params, 2 * sizeof(dcmt_params_t)) == 0);
+
+  /* Cached streams are not searched for, or written, again. */
+  memset(cached, 0, sizeof(cached));
+  assert(dcmt_create_cached(path, MEXP, SEED, 0, COUNT, cached, 0) == 0);
+  assert(count_lines(path) == 4);
+  assert(memcmp(cached, params, sizeof(cached)) == 0);
+
+  memset(cached, 0, sizeof(cached));
+  assert(dcmt_create_cached(path, MEXP, SEED, 0, COUNT, cached, 0) == 0);
+  assert(count_lines(path) == 4);
+  assert(memcmp(cached, params, sizeof(cached)) == 0);
+
+  /* Entries for another seed are not used. */
+  assert(dcmt_create_cached(path, MEXP, SEED + 1, 0, 1, cached, 0) == 0);
+  assert(count_lines(path) == 5);
+  assert(cached[0].aaa != params[0].aaa);
+
+  remove(path);
+  free(state);
+  free(copy);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for the C++ engines of librandom.hpp. */
+
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../src/librandom.hpp"
+
+/* Number of outputs compared in each test. */
+const std::size_t COUNT = 1000;
+
+/* The C generator, called with a copy of the engine's initial state, must
+ * reproduce the engine's output, its bulk output, its output after discard()
+ * and be usable with the distributions of <random>. */
+template <class Engine, class Generator>
+static void check_engine (Generator generator)
+{
+  static_assert(Engine::min() == 0, "min() must be constexpr");
+  static_assert(Engine::max() == ~typename Engine::result_type(0),
+                "max() must be constexpr");
+
+  typedef typename Engine::result_type result_type;
+  Engine engine;
+  typename Engine::state_type state = engine.state();
+
+  for (std::size_t i = 0; i < COUNT; i++)
+    assert(engine() == generator(&state));
+
+  /* Bulk generation, through pointers and other iterators. */
+  Engine a, b, c;
+  std::vector<result_type> bulk(COUNT), iter(COUNT);
+  a.generate(bulk.data(), bulk.data() + COUNT);
+  b.generate(iter.begin(), iter.end());
+  for (std::size_t i = 0; i < COUNT; i++)
+  {
+    result_type x = c();
+    assert(bulk[i] == x);
+    assert(iter[i] == x);
+  }
+  assert(a == c && b == c);
+
+  /* discard() */
+  Engine d;
+  d.discard(COUNT);
+  assert(d == c && !(d != c));
+  assert(d() == c());
+
+  std::uniform_int_distribution<int> die(1, 6);
+  for (std::size_t i = 0; i < COUNT; i++)
+  {
+    int x = die(d);
+    assert(1 <= x && x <= 6);
+  }
+}
+
+/* Step an engine at compile time. */
+template <class Engine>
+constexpr typename Engine::result_type constexpr_output (unsigned long long n)
+{
+  Engine engine;
+  engine.discard(n);
+  return engine();
+}
+
+int main(void)
+{
+  check_engine<librandom::kiss32_engine>(kiss32);
+  check_engine<librandom::kiss32a_engine>(kiss32a);
+  check_engine<librandom::kiss64_engine>(kiss64);
+  check_engine<librandom::taus88_engine>(taus88);
+  check_engine<librandom::lfsr113_engine>(lfsr113);
+  check_engine<librandom::lfsr258_engine>(lfsr258);
+  check_engine<librandom::mt19937ar_engine>(mt19937ar_r);
+  check_engine<librandom::mt19937_64_engine>(mt19937_64_r);
+
+  /* The small-state engines can be stepped at compile time. */
+  constexpr std::uint32_t kiss32_100 =
+    constexpr_output<librandom::kiss32_engine>(100);
+  constexpr std::uint64_t lfsr258_100 =
+    constexpr_output<librandom::lfsr258_engine>(100);
+
+  librandom::kiss32_engine kiss32_engine;
+  librandom::lfsr258_engine lfsr258_engine;
+  kiss32_engine.discard(100);
+  lfsr258_engine.discard(100);
+  assert(kiss32_engine() == kiss32_100);
+  assert(lfsr258_engine() == lfsr258_100);
+
+  /* The Mersenne Twister engines match those of the standard library. */
+  librandom::mt19937ar_engine mt32(12345);
+  librandom::mt19937_64_engine mt64(12345);
+  std::mt19937 std_mt32(12345);
+  std::mt19937_64 std_mt64(12345);
+
+  for (std::size_t i = 0; i < 10 * COUNT; i++)
+  {
+    assert(mt32() == std_mt32());
+    assert(mt64() == std_mt64());
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -5,13 +5,14 @@
 
 /* Unit tests for Marsaglia's KISS pseudo-random number generators. */
 
+#undef NDEBUG
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
 
 #include "../src/kiss.h"
 
-#undef NDEBUG
 #define _unused(x) (void)(x)
 
 int main(void)
@@ -47,6 +48,16 @@ int main(void)
   assert(kiss32a(kiss32a_state) == UINT32_C(2209597521));
   assert(kiss32a(kiss32a_state) == UINT32_C(1298124039));
 
+  /* Bulk generation must reproduce the scalar generator. */
+  uint32_t buffer32[1000];
+  kiss32a_state_t kiss32a_copy = *kiss32a_state;
+
+  kiss32a_fill(&kiss32a_copy, buffer32, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer32[i] == kiss32a(kiss32a_state));
+  }
+
 #ifdef UINT64_C
   uint64_t k;
 
@@ -73,6 +84,14 @@ int main(void)
    * https://bitbucket.org/cmcqueen1975/simplerandom/wiki/Home */
   assert(j == UINT32_C(1010846401));
 
+  kiss32_state_t kiss32_copy = *kiss32_state;
+
+  kiss32_fill(&kiss32_copy, buffer32, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer32[i] == kiss32(kiss32_state));
+  }
+
   /* Test the 64-bit multiply-with-carry kiss generator. */
   kiss64_state_t * kiss64_state;
   kiss64_state = (kiss64_state_t*) malloc(sizeof(kiss64_state_t));
@@ -94,6 +113,15 @@ int main(void)
 
   assert(k == UINT64_C(1666297717051644203));
 
+  uint64_t buffer64[1000];
+  kiss64_state_t kiss64_copy = *kiss64_state;
+
+  kiss64_fill(&kiss64_copy, buffer64, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == kiss64(kiss64_state));
+  }
+
 #endif /* ifdef UINT64_C */
 
   return EXIT_SUCCESS;
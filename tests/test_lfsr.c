@@ -5,13 +5,14 @@
 
 /* Unit tests for L'Ecuyer's LFSR pseudo-random number generators. */
 
+#undef NDEBUG
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
 
 #include "../src/lfsr.h"
 
-#undef NDEBUG
 #define _unused(x) (void)(x)
 
 #define SEED32 UINT32_C(12345)
@@ -41,6 +42,16 @@ int main(void)
 
   assert(k == UINT32_C(3639585634));
 
+  /* Bulk generation must reproduce the scalar generator. */
+  uint32_t buffer32[1000];
+  taus88_state_t taus88_copy = *taus88_state;
+
+  taus88_fill(&taus88_copy, buffer32, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer32[i] == taus88(taus88_state));
+  }
+
   /* Test the 32-bit 4 component LFSR generator. */
   lfsr113_state_t * lfsr113_state;
   lfsr113_state = (lfsr113_state_t*) malloc(sizeof(lfsr113_state_t));
@@ -60,6 +71,14 @@ int main(void)
 
   assert(k == UINT32_C(1205173390));
 
+  lfsr113_state_t lfsr113_copy = *lfsr113_state;
+
+  lfsr113_fill(&lfsr113_copy, buffer32, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer32[i] == lfsr113(lfsr113_state));
+  }
+
 #ifdef UINT64_C
   uint64_t j;
 
@@ -83,6 +102,15 @@ int main(void)
 
   assert(j == UINT64_C(2366542785984680056));
 
+  uint64_t buffer64[1000];
+  lfsr258_state_t lfsr258_copy = *lfsr258_state;
+
+  lfsr258_fill(&lfsr258_copy, buffer64, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == lfsr258(lfsr258_state));
+  }
+
 #endif /* ifdef UINT64_C */
 
   return EXIT_SUCCESS;
@@ -0,0 +1,78 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Tests of the librandom-gen program, run from the top level directory. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+
+#include "../src/generator.h"
+
+/* More than one buffer of the program, and not a whole number of them. */
+#define WORDS 300007
+
+int main(void)
+{
+  uint64_t *expected = malloc(WORDS * sizeof(uint64_t));
+  uint64_t *actual = malloc(WORDS * sizeof(uint64_t));
+  char command[256];
+  FILE *pipe;
+  random_t rng;
+
+  assert(random_generator_find("lfsr113") == RANDOM_LFSR113);
+  assert(random_generator_find("lfsr") == RANDOM_GENERATOR_COUNT);
+
+  /* Binary output through a pipe matches random_fill(). */
+  for (int id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    const random_generator_info_t *info = random_generator_info(id);
+    size_t word_size = info->word_bits / 8;
+
+    random_init(&rng, id, 2012, 10);
+    random_fill(&rng, expected, WORDS);
+
+    snprintf(command, sizeof(command),
+             "./bin/librandom-gen -g %s -s 2012 -t 10 -n %d -b 65536",
+             info->name, WORDS);
+    pipe = popen(command, "r");
+    assert(pipe != NULL);
+    assert(fread(actual, word_size, WORDS, pipe) == WORDS);
+    assert(fgetc(pipe) == EOF);
+    assert(pclose(pipe) == 0);
+    assert(memcmp(expected, actual, WORDS * word_size) == 0);
+  }
+
+  /* Text output. */
+  uint64_t x;
+
+  random_init(&rng, RANDOM_KISS64, 1, 0);
+  random_fill(&rng, expected, 1000);
+
+  pipe = popen("./bin/librandom-gen -g kiss64 -s 1 -n 1000 -f text", "r");
+  assert(pipe != NULL);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(fscanf(pipe, "%" SCNu64, &x) == 1);
+    assert(x == expected[i]);
+  }
+  assert(fscanf(pipe, "%" SCNu64, &x) == EOF);
+  assert(pclose(pipe) == 0);
+
+  /* Invalid arguments are rejected. */
+  assert(system("./bin/librandom-gen -g nosuch -n 1 2>/dev/null") != 0);
+  assert(system("./bin/librandom-gen -n -1 2>/dev/null") != 0);
+
+  free(expected);
+  free(actual);
+
+  return EXIT_SUCCESS;
+}
@@ -5,6 +5,8 @@
 
 /* Unit tests for the Mersenne Twister pseudo-random number generators. */
 
+#undef NDEBUG
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -14,7 +16,6 @@
 #include "debug.h"
 #include "../src/mt19937.h"
 
-#undef NDEBUG
 
 /* File containing expected output for the first 1000 calls to mt19937ar(). */
 const char EXPECTED_OUTPUT_32[] = "tests/test_mt19937ar.output";
@@ -63,6 +64,26 @@ int main(void)
 
   fclose(fd);
 
+  /* The reentrant and bulk routines must reproduce mt19937ar(). */
+  mt19937ar_state_t *state32 = malloc(sizeof(mt19937ar_state_t));
+  uint32_t buffer32[2000];
+
+  init_mt19937ar_by_array(init32, length);
+  init_mt19937ar_by_array_r(state32, init32, length);
+
+  mt19937ar_fill(state32, buffer32, 1);
+  mt19937ar_fill(state32, buffer32 + 1, 700);
+  mt19937ar_fill(state32, buffer32 + 701, 1299);
+  for (int i = 0; i < 2000; i++)
+  {
+    assert(buffer32[i] == mt19937ar());
+  }
+
+  for (int i = 0; i < 2000; i++)
+  {
+    assert(mt19937ar_r(state32) == mt19937ar());
+  }
+
 #ifdef UINT64_C
 
   /* Test the 64-bit Mersenne Twister generator. */
@@ -90,6 +111,26 @@ int main(void)
 
   fclose(fd);
 
+  /* The reentrant and bulk routines must reproduce mt19937_64(). */
+  mt19937_64_state_t *state64 = malloc(sizeof(mt19937_64_state_t));
+  uint64_t buffer64[1000];
+
+  init_mt19937_64_by_array(init64, length);
+  init_mt19937_64_by_array_r(state64, init64, length);
+
+  mt19937_64_fill(state64, buffer64, 1);
+  mt19937_64_fill(state64, buffer64 + 1, 400);
+  mt19937_64_fill(state64, buffer64 + 401, 599);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == mt19937_64());
+  }
+
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(mt19937_64_r(state64) == mt19937_64());
+  }
+
 #endif /* ifdef UINT64_C */
 
   return EXIT_SUCCESS;
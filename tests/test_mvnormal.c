@@ -0,0 +1,217 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for multivariate normal deviates. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "../src/mvnormal.h"
+#include "../src/normal.h"
+#include "../src/simd.h"
+
+#define D 3
+#define N 200000
+
+/* Larger than a tile of the multiplication, and odd. */
+#define BIG_D 37
+#define BIG_N 1001
+
+/* Check that A A^T reproduces the d x d covariance s. */
+static void check_factor (const random_mvnormal_t *mvn, const double *s)
+{
+  const size_t d = mvn->d;
+
+  for (size_t i = 0; i < d; i++)
+  {
+    for (size_t j = 0; j <= i; j++)
+    {
+      double sum = 0;
+
+      for (size_t k = 0; k < d; k++)
+        sum += mvn->factor[i * d + k] * mvn->factor[j * d + k];
+      assert(fabs(sum - s[i * d + j]) < 1e-12);
+    }
+  }
+}
+
+int main(void)
+{
+  /* Only the lower triangle is read. */
+  const double cov[D * D] = {
+    4.0, -99, -99,
+    1.2, 2.0, -99,
+    -0.8, 0.3, 1.0
+  };
+  const double full[D * D] = {
+    4.0, 1.2, -0.8,
+    1.2, 2.0, 0.3,
+    -0.8, 0.3, 1.0
+  };
+  const double mean[D] = { 1, -2, 0.5 };
+  random_mvnormal_t mvn;
+  random_t rng, copy;
+  double *x = malloc(BIG_N * BIG_D * sizeof(double));
+  double *y = malloc(BIG_N * BIG_D * sizeof(double));
+  double z[D];
+
+  /* A positive definite covariance has a Cholesky factor; every method
+   * reproduces it. */
+  assert(random_mvnormal_init(&mvn, D, mean, cov, RANDOM_MVNORMAL_AUTO) == 0);
+  assert(mvn.method == RANDOM_MVNORMAL_CHOLESKY);
+  assert(mvn.factor[0 * D + 1] == 0 && mvn.factor[1 * D + 2] == 0);
+  check_factor(&mvn, full);
+
+  for (int method = RANDOM_MVNORMAL_CHOLESKY; method <= RANDOM_MVNORMAL_EIGEN;
+       method++)
+  {
+    random_mvnormal_t other;
+
+    assert(random_mvnormal_init(&other, D, mean, cov, method) == 0);
+    assert(other.method == (random_mvnormal_method_t) method);
+    check_factor(&other, full);
+    random_mvnormal_free(&other);
+  }
+
+  /* The first sample is mean + A z for the first d normal deviates. */
+  assert(random_init(&rng, RANDOM_KISS64, 1, 2) == 0);
+  copy = rng;
+  random_normal_fill(&rng, 0, 1, z, D);
+  rng = copy;
+  assert(random_mvnormal_fill(&mvn, &rng, x, 1, RANDOM_ROW_MAJOR) == 0);
+  for (int j = 0; j < D; j++)
+  {
+    double sum = 0;
+
+    for (int k = 0; k <= j; k++)
+      sum += mvn.factor[j * D + k] * z[k];
+    assert(x[j] == sum + mean[j]);
+  }
+
+  /* Sample mean and covariance. */
+  double *samples = malloc(N * D * sizeof(double));
+  double m[D] = { 0 }, c[D * D] = { 0 };
+
+  assert(random_mvnormal_fill(&mvn, &rng, samples, N, RANDOM_ROW_MAJOR) == 0);
+  for (int i = 0; i < N; i++)
+  {
+    for (int j = 0; j < D; j++)
+      m[j] += samples[i * D + j] / N;
+  }
+  for (int i = 0; i < N; i++)
+  {
+    for (int j = 0; j < D; j++)
+    {
+      for (int k = 0; k < D; k++)
+        c[j * D + k] += (samples[i * D + j] - m[j])
+                        * (samples[i * D + k] - m[k]) / N;
+    }
+  }
+  for (int j = 0; j < D; j++)
+  {
+    assert(fabs(m[j] - mean[j]) < 5 * sqrt(full[j * D + j] / N));
+    for (int k = 0; k < D; k++)
+    {
+      const double sd = sqrt((full[j * D + j] * full[k * D + k]
+                              + full[j * D + k] * full[j * D + k]) / N);
+
+      assert(fabs(c[j * D + k] - full[j * D + k]) < 5 * sd);
+    }
+  }
+  free(samples);
+  random_mvnormal_free(&mvn);
+
+  /* A semi-definite covariance of rank 2: u u^T + v v^T. */
+  const double u[D] = { 1, 2, -1 }, v[D] = { 0.5, -1, 3 };
+  double rank2[D * D];
+
+  for (int j = 0; j < D; j++)
+  {
+    for (int k = 0; k < D; k++)
+      rank2[j * D + k] = u[j] * u[k] + v[j] * v[k];
+  }
+  assert(random_mvnormal_init(&mvn, D, NULL, rank2,
+                              RANDOM_MVNORMAL_CHOLESKY) == -1);
+  assert(random_mvnormal_init(&mvn, D, NULL, rank2, RANDOM_MVNORMAL_AUTO)
+         == 0);
+  assert(mvn.method == RANDOM_MVNORMAL_LDLT);
+  check_factor(&mvn, rank2);
+
+  /* Samples lie in the span of u and v. */
+  const double normal[D] = {
+    u[1] * v[2] - u[2] * v[1],
+    u[2] * v[0] - u[0] * v[2],
+    u[0] * v[1] - u[1] * v[0]
+  };
+
+  assert(random_mvnormal_fill(&mvn, &rng, x, 100, RANDOM_ROW_MAJOR) == 0);
+  for (int i = 0; i < 100; i++)
+  {
+    double dot = 0;
+
+    for (int j = 0; j < D; j++)
+      dot += normal[j] * x[i * D + j];
+    assert(fabs(dot) < 1e-12);
+  }
+  random_mvnormal_free(&mvn);
+
+  assert(random_mvnormal_init(&mvn, D, NULL, rank2, RANDOM_MVNORMAL_EIGEN)
+         == 0);
+  check_factor(&mvn, rank2);
+  random_mvnormal_free(&mvn);
+
+  /* An indefinite matrix is not a covariance. */
+  const double indefinite[4] = { 1, 2, 2, 1 };
+
+  assert(random_mvnormal_init(&mvn, 2, NULL, indefinite,
+                              RANDOM_MVNORMAL_AUTO) == -1);
+  assert(mvn.mean == NULL);
+
+  /* Layouts and instruction sets give the same samples, for dimensions
+   * spanning several tiles. */
+  double *big = malloc(BIG_D * BIG_D * sizeof(double));
+
+  for (int method = RANDOM_MVNORMAL_CHOLESKY; method <= RANDOM_MVNORMAL_EIGEN;
+       method += RANDOM_MVNORMAL_EIGEN - RANDOM_MVNORMAL_CHOLESKY)
+  {
+    for (int j = 0; j < BIG_D; j++)
+    {
+      for (int k = 0; k < BIG_D; k++)
+        big[j * BIG_D + k] = (j == k ? BIG_D : 0) + 1.0 / (1 + j + k);
+    }
+    assert(random_mvnormal_init(&mvn, BIG_D, NULL, big, method) == 0);
+
+    random_init(&rng, RANDOM_PCG64, 3, 4);
+    copy = rng;
+    assert(random_mvnormal_fill(&mvn, &rng, x, BIG_N, RANDOM_ROW_MAJOR) == 0);
+
+    for (int level = RANDOM_SIMD_GENERIC; level <= RANDOM_SIMD_AVX512;
+         level++)
+    {
+      random_simd_limit(level);
+      rng = copy;
+      assert(random_mvnormal_fill(&mvn, &rng, y, BIG_N,
+                                  RANDOM_COLUMN_MAJOR) == 0);
+      for (int i = 0; i < BIG_N; i++)
+      {
+        for (int j = 0; j < BIG_D; j++)
+          assert(x[i * BIG_D + j] == y[j * BIG_N + i]);
+      }
+    }
+    random_simd_limit(RANDOM_SIMD_AVX512);
+    random_mvnormal_free(&mvn);
+  }
+
+  free(big);
+  free(x);
+  free(y);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for uniform and normal deviates and the approximations of
+ * simd.h. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "../src/normal.h"
+#include "../src/simd.h"
+
+#define N 1000000
+
+#define TWO_PI 6.28318530717958647692
+
+/* Unit in the last place of x. */
+static double ulp (double x)
+{
+  int e;
+
+  frexp(x, &e);
+
+  return ldexp(1.0, e - 53);
+}
+
+int main(void)
+{
+  double *a = malloc(N * sizeof(double));
+  double *b = malloc(N * sizeof(double));
+  uint64_t *words = malloc(N * sizeof(uint64_t));
+  float *f = malloc(N * sizeof(float));
+  random_t rng, copy;
+
+  /* The approximations agree with libm. */
+  assert(random_init(&rng, RANDOM_KISS64, 1, 2) == 0);
+  random_fill64(&rng, words, N);
+  for (int i = 0; i < N; i++)
+  {
+    const double u = random_simd_open(words[i]);
+    const double x = ldexp(u, (int) (words[i] & 1023) - 511);
+    const double v = random_simd_unit(words[i]);
+    double s, c;
+
+    assert(u > 0 && u < 1 && v >= 0 && v < 1);
+    assert(fabs(random_simd_log(x) - log(x)) <= 2 * ulp(log(x)));
+
+    random_simd_sincos2pi(v, &s, &c);
+    assert(fabs(s - sin(TWO_PI * v)) < 2e-15);
+    assert(fabs(c - cos(TWO_PI * v)) < 2e-15);
+  }
+
+  /* Exact reduction: the zeros and extrema are exact. */
+  for (int q = 0; q < 4; q++)
+  {
+    double s, c;
+
+    random_simd_sincos2pi(q / 4.0, &s, &c);
+    assert(s == (q == 1) - (q == 3) && c == (q == 0) - (q == 2));
+  }
+
+  /* Every instruction set gives the same deviates. */
+  assert(random_init(&rng, RANDOM_PCG64_DXSM, 1, 2) == 0);
+  copy = rng;
+  random_normal_fill(&rng, 0, 1, a, N);
+
+  for (int level = RANDOM_SIMD_GENERIC; level <= RANDOM_SIMD_AVX512; level++)
+  {
+    random_simd_limit(level);
+    assert((int) random_simd_level() <= level);
+    rng = copy;
+    random_normal_fill(&rng, 0, 1, b, N);
+    assert(memcmp(a, b, N * sizeof(double)) == 0);
+  }
+  random_simd_limit(RANDOM_SIMD_AVX512);
+
+  /* The deviates are those of random_box_muller(). */
+  rng = copy;
+  random_fill64(&rng, words, N);
+  random_box_muller(words, b, N / 2);
+  assert(memcmp(a, b, N * sizeof(double)) == 0);
+
+  /* Moments, and the probability of falling below 1, of the standard normal
+   * distribution. */
+  double mean = 0, var = 0, below = 0;
+
+  for (int i = 0; i < N; i++)
+  {
+    mean += a[i];
+    var += a[i] * a[i];
+    below += a[i] < 1;
+  }
+  mean /= N;
+  var = var / N - mean * mean;
+  below /= N;
+
+  assert(fabs(mean) < 5 / sqrt(N));
+  assert(fabs(var - 1) < 5 * sqrt(2.0 / N));
+  assert(fabs(below - 0.8413447460685429) < 5 * sqrt(0.14 / N));
+
+  /* Scaling, odd lengths and single precision. */
+  rng = copy;
+  random_normal_fill(&rng, 3, 2, b, 5);
+  for (int i = 0; i < 5; i++)
+    assert(b[i] == 3 + 2 * a[i]);
+
+  rng = copy;
+  random_normal_fill_float(&rng, 0, 1, f, 1001);
+  for (int i = 0; i < 1001; i++)
+    assert(f[i] == (float) a[i]);
+
+  /* Uniform deviates. */
+  random_uniform_fill(&rng, a, N);
+  mean = 0;
+  for (int i = 0; i < N; i++)
+  {
+    assert(a[i] > 0 && a[i] < 1);
+    mean += a[i];
+  }
+  assert(fabs(mean / N - 0.5) < 5 * sqrt(1 / 12.0 / N));
+
+  free(a);
+  free(b);
+  free(words);
+  free(f);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for generic seeding and deterministic parallel filling. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../src/parallel.h"
+
+/* Not a whole number of chunks. */
+#define WORDS (7 * RANDOM_PARALLEL_CHUNK / 2)
+
+static void count_chunk (void *arg, size_t chunk)
+{
+  ((int *) arg)[chunk]++;
+}
+
+int main(void)
+{
+  unsigned char *expected = malloc(WORDS * 8);
+  unsigned char *actual = malloc(WORDS * 8);
+  unsigned threads[] = { 2, 3, 8, 0 };
+
+  for (int id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    size_t word_size = random_generator_info(id)->word_bits / 8;
+    random_config_t config = { id, UINT64_C(20121011), 3 };
+    uint64_t key[3] = { UINT64_C(20121011), 3, 2 };
+    random_t rng, rng2;
+
+    /* The same seed and stream always give the same state; different ones
+     * give different states. */
+    assert(random_init(&rng, id, 1, 2) == 0);
+    assert(random_init(&rng2, id, 1, 2) == 0);
+    assert(memcmp(&rng.state, &rng2.state,
+                  random_generator_info(id)->state_size) == 0);
+    assert(random_init(&rng2, id, 1, 3) == 0);
+    assert(memcmp(&rng.state, &rng2.state,
+                  random_generator_info(id)->state_size) != 0);
+
+    /* The output does not depend on the number of threads. */
+    assert(random_parallel_fill(&config, expected, WORDS, 1) == 0);
+    for (size_t k = 0; k < sizeof(threads) / sizeof(threads[0]); k++)
+    {
+      memset(actual, 0, WORDS * word_size);
+      assert(random_parallel_fill(&config, actual, WORDS, threads[k]) == 0);
+      assert(memcmp(expected, actual, WORDS * word_size) == 0);
+    }
+
+    /* Chunk c is generated from the key (seed, stream, c). */
+    assert(random_init_by_key(&rng, id, key, 3) == 0);
+    random_fill(&rng, actual, RANDOM_PARALLEL_CHUNK);
+    assert(memcmp(expected + 2 * RANDOM_PARALLEL_CHUNK * word_size, actual,
+                  RANDOM_PARALLEL_CHUNK * word_size) == 0);
+  }
+
+  /* random_fill() matches the generator itself. */
+  random_t rng;
+  lfsr113_state_t lfsr113_state;
+  uint32_t *out32 = (uint32_t *) actual;
+
+  random_init(&rng, RANDOM_LFSR113, 12345, 0);
+  lfsr113_state = rng.state.lfsr113;
+  random_fill(&rng, out32, 1000);
+  for (int i = 0; i < 1000; i++)
+    assert(out32[i] == lfsr113(&lfsr113_state));
+
+  /* Seeds are corrected to satisfy the requirements of each generator. */
+  for (uint64_t seed = 0; seed < 10000; seed++)
+  {
+    random_init(&rng, RANDOM_KISS32, seed, 0);
+    assert(rng.state.kiss32.my != 0);
+    assert(rng.state.kiss32.mc < UINT32_C(698769069));
+
+    random_init(&rng, RANDOM_KISS32A, seed, 0);
+    assert(rng.state.kiss32a.my != 0 && rng.state.kiss32a.mc <= 1);
+    assert(rng.state.kiss32a.mz < (UINT32_C(1) << 31));
+    assert(rng.state.kiss32a.mw < (UINT32_C(1) << 31));
+    assert(rng.state.kiss32a.mz % 7559 != 0);
+    assert(rng.state.kiss32a.mw % 7559 != 0);
+
+    random_init(&rng, RANDOM_TAUS88, seed, 0);
+    assert(rng.state.taus88.s1 > 1 && rng.state.taus88.s2 > 7);
+    assert(rng.state.taus88.s3 > 15);
+
+    random_init(&rng, RANDOM_LFSR258, seed, 0);
+    assert(rng.state.lfsr258.s1 > 1 && rng.state.lfsr258.s2 > 511);
+    assert(rng.state.lfsr258.s3 > 4095 && rng.state.lfsr258.s4 > 131071);
+    assert(rng.state.lfsr258.s5 > 8388607);
+  }
+
+  assert(random_init(&rng, RANDOM_GENERATOR_COUNT, 0, 0) == -1);
+
+  /* Every chunk is run exactly once. */
+  int counts[1000] = { 0 };
+
+  random_parallel_for(1000, 7, count_chunk, counts);
+  for (int i = 0; i < 1000; i++)
+    assert(counts[i] == 1);
+
+  free(expected);
+  free(actual);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for the permuted congruential generators. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "../src/pcg.h"
+
+#define SEED 42
+#define STREAM 54
+
+static const uint64_t deltas[] = { 0, 1, 2, 1000, 123457 };
+
+int main(void)
+{
+  /* Test pcg32 against the reference implementation, pcg32-demo of
+   * pcg-c. */
+  static const uint32_t pcg32_expected[6] = {
+    UINT32_C(0xa15c02b7), UINT32_C(0x7b47f409), UINT32_C(0xba1d3330),
+    UINT32_C(0x83d2f293), UINT32_C(0xbfa4784b), UINT32_C(0xcbed606e)
+  };
+  pcg32_state_t pcg32_state, pcg32_copy;
+  uint32_t buffer32[1000];
+
+  init_pcg32(&pcg32_state, SEED, STREAM);
+  for (int i = 0; i < 6; i++)
+  {
+    assert(pcg32(&pcg32_state) == pcg32_expected[i]);
+  }
+
+  /* Bulk generation must reproduce the scalar generator. */
+  pcg32_copy = pcg32_state;
+  pcg32_fill(&pcg32_copy, buffer32, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer32[i] == pcg32(&pcg32_state));
+  }
+
+  /* Advancing must reproduce stepping, and wrap around the period. */
+  init_pcg32(&pcg32_state, SEED, STREAM);
+  pcg32_copy = pcg32_state;
+  pcg32_advance(&pcg32_copy, 5);
+  for (int i = 0; i < 5; i++)
+    pcg32(&pcg32_state);
+  assert(pcg32(&pcg32_copy) == pcg32(&pcg32_state));
+
+  pcg32_advance(&pcg32_copy, -UINT64_C(6));
+  assert(pcg32(&pcg32_copy) == pcg32_expected[0]);
+
+  /* Test pcg64 against the reference implementation, pcg64-demo of
+   * pcg-c. */
+  static const uint64_t pcg64_expected[6] = {
+    UINT64_C(0x86b1da1d72062b68), UINT64_C(0x1304aa46c9853d39),
+    UINT64_C(0xa3670e9e0dd50358), UINT64_C(0xf9090e529a7dae00),
+    UINT64_C(0xc85b9fd837996f2c), UINT64_C(0x606121f8e3919196)
+  };
+  pcg64_state_t pcg64_state, pcg64_copy;
+  uint64_t buffer64[1000];
+
+  init_pcg64(&pcg64_state, PCG128(0, SEED), PCG128(0, STREAM));
+  for (int i = 0; i < 6; i++)
+  {
+    assert(pcg64(&pcg64_state) == pcg64_expected[i]);
+  }
+
+  pcg64_copy = pcg64_state;
+  pcg64_fill(&pcg64_copy, buffer64, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == pcg64(&pcg64_state));
+  }
+
+  for (size_t j = 0; j < sizeof(deltas) / sizeof(deltas[0]); j++)
+  {
+    init_pcg64(&pcg64_state, PCG128(0, SEED), PCG128(0, STREAM));
+    pcg64_copy = pcg64_state;
+    pcg64_advance(&pcg64_copy, PCG128(0, deltas[j]));
+    for (uint64_t i = 0; i < deltas[j]; i++)
+      pcg64(&pcg64_state);
+    assert(pcg64(&pcg64_copy) == pcg64(&pcg64_state));
+  }
+
+  /* Stepping back by advancing 2^128 - 7 steps. */
+  pcg64_advance(&pcg64_copy, PCG128(UINT64_MAX, -UINT64_C(7)));
+  init_pcg64(&pcg64_state, PCG128(0, SEED), PCG128(0, STREAM));
+  pcg64_advance(&pcg64_state, PCG128(0, UINT64_C(123457) - 6));
+  assert(pcg64(&pcg64_copy) == pcg64(&pcg64_state));
+
+  /* Different streams give different sequences. */
+  init_pcg64(&pcg64_state, PCG128(0, SEED), PCG128(0, STREAM));
+  init_pcg64(&pcg64_copy, PCG128(0, SEED), PCG128(0, STREAM + 1));
+  for (int i = 0; i < 100; i++)
+  {
+    assert(pcg64(&pcg64_state) != pcg64(&pcg64_copy));
+  }
+
+  /* Test pcg64_dxsm: the output follows the DXSM permutation of NumPy's
+   * PCG64DXSM, seeded as pcg64. */
+  static const uint64_t pcg64_dxsm_expected[3] = {
+    UINT64_C(0xf0847c9518bddb90), UINT64_C(0x8e7d5f5514ba8aaa),
+    UINT64_C(0x86fbd36f8028f6fd)
+  };
+  pcg64_dxsm_state_t dxsm_state, dxsm_copy;
+
+  init_pcg64_dxsm(&dxsm_state, PCG128(0, SEED), PCG128(0, STREAM));
+  for (int i = 0; i < 3; i++)
+  {
+    assert(pcg64_dxsm(&dxsm_state) == pcg64_dxsm_expected[i]);
+  }
+
+  dxsm_copy = dxsm_state;
+  pcg64_dxsm_fill(&dxsm_copy, buffer64, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == pcg64_dxsm(&dxsm_state));
+  }
+
+  for (size_t j = 0; j < sizeof(deltas) / sizeof(deltas[0]); j++)
+  {
+    init_pcg64_dxsm(&dxsm_state, PCG128(0, SEED), PCG128(0, STREAM));
+    dxsm_copy = dxsm_state;
+    pcg64_dxsm_advance(&dxsm_copy, PCG128(0, deltas[j]));
+    for (uint64_t i = 0; i < deltas[j]; i++)
+      pcg64_dxsm(&dxsm_state);
+    assert(pcg64_dxsm(&dxsm_copy) == pcg64_dxsm(&dxsm_state));
+  }
+
+  /* Advances compose: 2^40 steps as two of 2^39. */
+  init_pcg64_dxsm(&dxsm_state, PCG128(0, SEED), PCG128(0, STREAM));
+  dxsm_copy = dxsm_state;
+  pcg64_dxsm_advance(&dxsm_state, PCG128(0, UINT64_C(1) << 40));
+  pcg64_dxsm_advance(&dxsm_copy, PCG128(0, UINT64_C(1) << 39));
+  pcg64_dxsm_advance(&dxsm_copy, PCG128(0, UINT64_C(1) << 39));
+  assert(pcg64_dxsm(&dxsm_copy) == pcg64_dxsm(&dxsm_state));
+
+  /* Test lcg128: the output is the high half of the state of pcg64. */
+  lcg128_state_t lcg128_state, lcg128_copy;
+
+  init_lcg128(&lcg128_state, PCG128(0, SEED), PCG128(0, STREAM));
+  assert(lcg128(&lcg128_state) == UINT64_C(0x10af065f4ea96e85));
+  assert(lcg128(&lcg128_state) == UINT64_C(0x8c68363963ccebd8));
+  assert(lcg128(&lcg128_state) == UINT64_C(0xc17f1c9974cfdc46));
+
+#ifdef PCG_HAS_UINT128
+  init_lcg128(&lcg128_state, PCG128(0, SEED), PCG128(0, STREAM));
+  init_pcg64(&pcg64_state, PCG128(0, SEED), PCG128(0, STREAM));
+  for (int i = 0; i < 100; i++)
+  {
+    pcg64(&pcg64_state);
+    assert(lcg128(&lcg128_state) == (uint64_t) (pcg64_state.state >> 64));
+  }
+#endif
+
+  lcg128_copy = lcg128_state;
+  lcg128_fill(&lcg128_copy, buffer64, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == lcg128(&lcg128_state));
+  }
+
+  lcg128_copy = lcg128_state;
+  lcg128_advance(&lcg128_copy, PCG128(0, 1000));
+  for (int i = 0; i < 1000; i++)
+    lcg128(&lcg128_state);
+  assert(lcg128(&lcg128_copy) == lcg128(&lcg128_state));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,252 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for random permutations and sampling without replacement. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../src/shuffle.h"
+
+/* Larger than RANDOM_SHUFFLE_BLOCK for 4-byte elements. */
+#define N 100000
+
+/* More than two chunks of random_shuffle_parallel(). */
+#define PARALLEL_N (5 * RANDOM_SHUFFLE_CHUNK / 2)
+
+#define TRIALS 60000
+
+/* Upper 0.1% point of the chi-squared distribution with 5 and 9 degrees of
+ * freedom. */
+#define CHI2_5 20.52
+#define CHI2_9 27.88
+
+static double chi2 (const unsigned *counts, unsigned n, double expected)
+{
+  double sum = 0;
+
+  for (unsigned i = 0; i < n; i++)
+    sum += (counts[i] - expected) * (counts[i] - expected) / expected;
+
+  return sum;
+}
+
+/* Check that a[0..n-1] is a permutation of 0, ..., n - 1. */
+static void check_permutation (const uint32_t *a, size_t n)
+{
+  unsigned char *seen = calloc(n, 1);
+
+  for (size_t i = 0; i < n; i++)
+  {
+    assert(a[i] < n);
+    assert(!seen[a[i]]);
+    seen[a[i]] = 1;
+  }
+
+  free(seen);
+}
+
+static void iota (uint32_t *a, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    a[i] = (uint32_t) i;
+}
+
+int main(void)
+{
+  uint32_t *a = malloc(PARALLEL_N * sizeof(uint32_t));
+  uint32_t *b = malloc(PARALLEL_N * sizeof(uint32_t));
+  unsigned counts[10];
+  random_t rng;
+
+  for (int id = 0; id < RANDOM_GENERATOR_COUNT; id++)
+  {
+    assert(random_init(&rng, id, 1, 2) == 0);
+
+    iota(a, N);
+    random_shuffle(&rng, a, N, sizeof(uint32_t));
+    check_permutation(a, N);
+
+    iota(a, N);
+    assert(random_shuffle_blocked(&rng, a, N, sizeof(uint32_t)) == 0);
+    check_permutation(a, N);
+  }
+
+  /* Each of the 6 permutations of 3 elements is equally likely. */
+  assert(random_init(&rng, RANDOM_KISS64, 1, 2) == 0);
+  memset(counts, 0, sizeof(counts));
+  for (int t = 0; t < TRIALS; t++)
+  {
+    uint32_t p[3] = { 0, 1, 2 };
+
+    random_shuffle(&rng, p, 3, sizeof(uint32_t));
+    counts[p[0] * 2 + (p[1] > p[2])]++;
+  }
+  assert(chi2(counts, 6, TRIALS / 6.0) < CHI2_5);
+
+  /* Shuffles of any element size. */
+  {
+    unsigned char bytes[3 * 1000];
+
+    for (int i = 0; i < 1000; i++)
+    {
+      bytes[3 * i] = (unsigned char) i;
+      bytes[3 * i + 1] = (unsigned char) (i >> 8);
+      bytes[3 * i + 2] = (unsigned char) (i + 1);
+    }
+    random_shuffle(&rng, bytes, 1000, 3);
+    memset(a, 0, 1000 * sizeof(uint32_t));
+    for (int i = 0; i < 1000; i++)
+    {
+      assert(bytes[3 * i + 2] == (unsigned char) (bytes[3 * i] + 1));
+      a[i] = bytes[3 * i] | (uint32_t) bytes[3 * i + 1] << 8;
+    }
+    check_permutation(a, 1000);
+  }
+
+  /* The blocked shuffle sends the first element to each tenth of the array
+   * equally often. */
+  memset(counts, 0, sizeof(counts));
+  for (int t = 0; t < 200; t++)
+  {
+    iota(a, N);
+    assert(random_shuffle_blocked(&rng, a, N, sizeof(uint32_t)) == 0);
+    for (size_t i = 0; i < N; i++)
+    {
+      if (a[i] == 0)
+        counts[i * 10 / N]++;
+    }
+  }
+  assert(chi2(counts, 10, 20.0) < CHI2_9);
+
+  /* Elements larger than RANDOM_SHUFFLE_BLOCK are each a bucket of their
+   * own, and both orders of two of them occur. */
+  const size_t big = RANDOM_SHUFFLE_BLOCK + 8;
+  unsigned char *c = malloc(3 * big);
+  uint32_t label;
+  int swapped = 0;
+
+  assert(c != NULL);
+  for (int t = 0; t < 64; t++)
+  {
+    for (uint32_t i = 0; i < 3; i++)
+      memcpy(c + i * big, &i, sizeof(i));
+    assert(random_shuffle_blocked(&rng, c, 2, big) == 0);
+    memcpy(&label, c, sizeof(label));
+    assert(label < 2);
+    swapped += label == 1;
+  }
+  assert(swapped > 0 && swapped < 64);
+
+  random_config_t big_config = { RANDOM_PCG64_DXSM, UINT64_C(20121011), 3 };
+
+  for (uint32_t i = 0; i < 3; i++)
+    memcpy(c + i * big, &i, sizeof(i));
+  assert(random_shuffle_blocked(&rng, c, 3, big) == 0);
+  assert(random_shuffle_parallel(&big_config, c, 3, big, 2) == 0);
+  for (uint32_t i = 0, seen = 0; i < 3; i++)
+  {
+    memcpy(&label, c + i * big, sizeof(label));
+    assert(label < 3 && !(seen & 1u << label));
+    seen |= 1u << label;
+  }
+  free(c);
+
+  /* The parallel shuffle does not depend on the number of threads. */
+  random_config_t config = { RANDOM_PCG64_DXSM, UINT64_C(20121011), 3 };
+  unsigned threads[] = { 2, 3, 0 };
+
+  iota(a, PARALLEL_N);
+  assert(random_shuffle_parallel(&config, a, PARALLEL_N, sizeof(uint32_t),
+                                 1) == 0);
+  check_permutation(a, PARALLEL_N);
+  for (size_t k = 0; k < sizeof(threads) / sizeof(threads[0]); k++)
+  {
+    iota(b, PARALLEL_N);
+    assert(random_shuffle_parallel(&config, b, PARALLEL_N, sizeof(uint32_t),
+                                   threads[k]) == 0);
+    assert(memcmp(a, b, PARALLEL_N * sizeof(uint32_t)) == 0);
+  }
+
+  config.id = RANDOM_GENERATOR_COUNT;
+  assert(random_shuffle_parallel(&config, a, 10, sizeof(uint32_t), 1) == -1);
+
+  /* Floyd's algorithm gives distinct integers, each equally likely. */
+  uint64_t sample[1000];
+
+  assert(random_sample(&rng, 10, 11, sample) == -1);
+  assert(random_sample(&rng, 10, 0, sample) == 0);
+
+  assert(random_sample(&rng, 1000, 1000, sample) == 0);
+  for (int i = 0; i < 1000; i++)
+    a[i] = (uint32_t) sample[i];
+  check_permutation(a, 1000);
+
+  assert(random_sample(&rng, UINT64_MAX, 1000, sample) == 0);
+  for (int i = 0; i < 1000; i++)
+  {
+    for (int j = 0; j < i; j++)
+      assert(sample[i] != sample[j]);
+  }
+
+  memset(counts, 0, sizeof(counts));
+  for (int t = 0; t < TRIALS / 3; t++)
+  {
+    assert(random_sample(&rng, 10, 3, sample) == 0);
+    assert(sample[0] != sample[1] && sample[0] != sample[2]
+           && sample[1] != sample[2]);
+    for (int i = 0; i < 3; i++)
+      counts[sample[i]]++;
+  }
+  assert(chi2(counts, 10, TRIALS / 10.0) < CHI2_9);
+
+  /* A reservoir holds every element until it is full, then each element of
+   * the stream equally often. */
+  random_reservoir_t reservoir;
+  uint32_t items[3], stream[10];
+
+  iota(stream, 10);
+  random_reservoir_init(&reservoir, &rng, items, 3, sizeof(uint32_t));
+  random_reservoir_add(&reservoir, stream, 2);
+  assert(random_reservoir_count(&reservoir) == 2);
+  assert(items[0] == 0 && items[1] == 1);
+
+  memset(counts, 0, sizeof(counts));
+  for (int t = 0; t < TRIALS / 3; t++)
+  {
+    random_reservoir_init(&reservoir, &rng, items, 3, sizeof(uint32_t));
+    random_reservoir_add(&reservoir, stream, 10);
+    assert(random_reservoir_count(&reservoir) == 3);
+    for (int i = 0; i < 3; i++)
+      counts[items[i]]++;
+  }
+  assert(chi2(counts, 10, TRIALS / 10.0) < CHI2_9);
+
+  /* The sample does not depend on how the stream is divided. */
+  uint32_t whole[5], pieces[5];
+  random_t rng2;
+
+  iota(a, N);
+  assert(random_init(&rng, RANDOM_MT19937_64, 1, 2) == 0);
+  rng2 = rng;
+
+  random_reservoir_init(&reservoir, &rng, whole, 5, sizeof(uint32_t));
+  random_reservoir_add(&reservoir, a, N);
+
+  random_reservoir_init(&reservoir, &rng2, pieces, 5, sizeof(uint32_t));
+  for (size_t i = 0; i < N; i += 777)
+    random_reservoir_add(&reservoir, a + i, N - i < 777 ? N - i : 777);
+
+  assert(memcmp(whole, pieces, sizeof(whole)) == 0);
+
+  free(a);
+  free(b);
+
+  return EXIT_SUCCESS;
+}
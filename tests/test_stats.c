@@ -0,0 +1,124 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for the instrumentation of the generators.
+ *
+ * The generators are compiled into this test in header-only mode with the
+ * instrumentation enabled, so that it is tested whether or not the library
+ * itself was built with LIBRANDOM_STATS.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#undef NDEBUG
+
+#define LIBRANDOM_INLINE
+#ifndef LIBRANDOM_STATS
+#define LIBRANDOM_STATS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <assert.h>
+
+#include "../src/kiss.h"
+#include "../src/mt19937.h"
+#include "../src/stats.h"
+
+static void *draw (void *arg)
+{
+  kiss64_state_t *state = arg;
+
+  for (int i = 0; i < 500; i++)
+    kiss64(state);
+
+  return NULL;
+}
+
+int main(void)
+{
+  kiss64_state_t kiss64_state = { UINT64_C(1066149217761810),
+                                  UINT64_C(362436362436362436),
+                                  UINT64_C(1234567890987654321),
+                                  UINT64_C(123456123456123456) };
+  mt19937_64_state_t mt19937_64_state;
+  uint64_t out[1000];
+  random_stats_t stats;
+  pthread_t thread;
+
+  random_stats_reset();
+  random_stats_snapshot(&stats);
+  assert(stats.outputs[RANDOM_KISS64][RANDOM_STATS_SCALAR] == 0);
+
+  /* Counts of each API. */
+  for (int i = 0; i < 10; i++)
+    kiss64(&kiss64_state);
+  kiss64_fill(&kiss64_state, out, 1000);
+
+  random_stats_snapshot(&stats);
+  assert(stats.outputs[RANDOM_KISS64][RANDOM_STATS_SCALAR] == 10);
+  assert(stats.outputs[RANDOM_KISS64][RANDOM_STATS_FILL] == 1000);
+  assert(stats.outputs[RANDOM_KISS64][RANDOM_STATS_DISTRIBUTION] == 0);
+  assert(stats.outputs[RANDOM_KISS32][RANDOM_STATS_SCALAR] == 0);
+
+  /* Regenerations of the Mersenne Twister, one per NN outputs. */
+  init_mt19937_64_r(&mt19937_64_state, UINT64_C(5489));
+  mt19937_64_fill(&mt19937_64_state, out, 1000);
+  for (int i = 0; i < 248; i++)
+    mt19937_64_r(&mt19937_64_state);
+
+  random_stats_snapshot(&stats);
+  assert(stats.outputs[RANDOM_MT19937_64][RANDOM_STATS_FILL] == 1000);
+  assert(stats.outputs[RANDOM_MT19937_64][RANDOM_STATS_SCALAR] == 248);
+  assert(stats.regenerations[RANDOM_MT19937_64] == 4);
+  assert(stats.regeneration_cycles[RANDOM_MT19937_64] > 0);
+  assert(stats.regenerations[RANDOM_KISS64] == 0);
+
+  mt19937_64_r(&mt19937_64_state);
+  random_stats_snapshot(&stats);
+  assert(stats.regenerations[RANDOM_MT19937_64] == 5);
+
+  /* Rejections. */
+  RANDOM_STATS_REJECT(RANDOM_KISS32, 3);
+  random_stats_snapshot(&stats);
+  assert(stats.rejections[RANDOM_KISS32] == 3);
+
+  /* Counts of other threads, including those which have exited. */
+  assert(pthread_create(&thread, NULL, draw, &kiss64_state) == 0);
+  assert(pthread_join(thread, NULL) == 0);
+
+  random_stats_snapshot(&stats);
+  assert(stats.outputs[RANDOM_KISS64][RANDOM_STATS_SCALAR] == 510);
+
+  /* Export. */
+  FILE *stream = tmpfile();
+  char line[256];
+  int found = 0;
+
+  assert(random_stats_export(stream, &stats) == 0);
+  rewind(stream);
+  while (fgets(line, sizeof(line), stream))
+  {
+    if (strcmp(line, "librandom_outputs_total"
+                     "{generator=\"kiss64\",api=\"scalar\"} 510\n") == 0)
+      found++;
+    if (strcmp(line, "librandom_regenerations_total"
+                     "{generator=\"mt19937_64\"} 5\n") == 0)
+      found++;
+    assert(strstr(line, "kiss32a") == NULL);
+  }
+  assert(found == 2);
+  fclose(stream);
+
+  /* Reset. */
+  random_stats_reset();
+  random_stats_snapshot(&stats);
+  assert(stats.outputs[RANDOM_KISS64][RANDOM_STATS_SCALAR] == 0);
+  assert(stats.regenerations[RANDOM_MT19937_64] == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for the combined Tausworthe generator templates. */
+
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+
+#include "../src/tausworthe.hpp"
+#include "../src/lfsr.h"
+
+#define SEED32 UINT32_C(12345)
+#define SEED64 UINT64_C(12345987654321)
+
+using librandom::tausworthe_component;
+using librandom::tausworthe_engine;
+
+/* The full period conditions are checked at compile time. */
+static_assert(tausworthe_component<31, 13, 12>::admissible(32), "");
+static_assert(!tausworthe_component<31, 13, 12>::admissible(16), "");
+static_assert(!tausworthe_component<31, 16, 12>::admissible(32), "2q < k");
+static_assert(!tausworthe_component<31, 13, 19>::admissible(32), "s <= k-q");
+static_assert(tausworthe_component<63, 1, 10>::full_period(), "");
+static_assert(!tausworthe_component<31, 2, 12>::full_period(), "reducible");
+static_assert(!tausworthe_component<29, 3, 4>::full_period(), "reducible");
+static_assert(!tausworthe_component<28, 3, 15>::full_period(), "gcd(s, 2^k-1)");
+
+/* Step every generator at compile time. */
+template <class Engine>
+constexpr typename Engine::result_type constexpr_output (unsigned long long n)
+{
+  Engine engine;
+  engine.discard(n);
+  return engine();
+}
+
+/* The template instance must be bit-identical to the C generator. */
+template <class Engine, class State, class Generator>
+static typename Engine::result_type check_identical (
+  const typename Engine::state_type &seeds, State state, Generator generator)
+{
+  typename Engine::result_type x = 0;
+  Engine engine(seeds);
+
+  for (int i = 0; i < 1000000; i++)
+  {
+    x = engine();
+    assert(x == generator(&state));
+  }
+
+  /* Bulk generation must reproduce the scalar generator. */
+  std::vector<typename Engine::result_type> buffer(1000);
+  Engine copy(engine);
+
+  copy.generate(buffer.data(), buffer.data() + buffer.size());
+  for (std::size_t i = 0; i < buffer.size(); i++)
+    assert(buffer[i] == engine());
+  assert(copy == engine);
+
+  return x;
+}
+
+int main(void)
+{
+  taus88_state_t taus88_state = { SEED32, SEED32, SEED32 };
+  lfsr113_state_t lfsr113_state = { SEED32, SEED32, SEED32, SEED32 };
+  lfsr258_state_t lfsr258_state = { SEED64, SEED64, SEED64, SEED64, SEED64 };
+
+  /* The expected values are those of test_lfsr.c. */
+  assert(check_identical<librandom::taus88_tausworthe>(
+           { SEED32, SEED32, SEED32 }, taus88_state, taus88)
+         == UINT32_C(3639585634));
+  assert(check_identical<librandom::lfsr113_tausworthe>(
+           { SEED32, SEED32, SEED32, SEED32 }, lfsr113_state, lfsr113)
+         == UINT32_C(1205173390));
+  assert(check_identical<librandom::lfsr258_tausworthe>(
+           { SEED64, SEED64, SEED64, SEED64, SEED64 }, lfsr258_state, lfsr258)
+         == UINT64_C(2366542785984680056));
+
+  /* Seeding keeps the top k bits of each component non-zero. */
+  librandom::lfsr258_tausworthe lfsr258_engine(1);
+  for (std::size_t j = 0; j < lfsr258_engine.component_count; j++)
+    assert(lfsr258_engine.state()[j] > 1);
+
+  /* Combinations other than the three of lfsr.h. */
+  typedef tausworthe_engine<std::uint64_t,
+                            tausworthe_component<63,  1, 10>,
+                            tausworthe_component<55, 24,  5> > two_component;
+  constexpr std::uint64_t x = constexpr_output<two_component>(100);
+  two_component two;
+  two.discard(100);
+  assert(two() == x);
+
+  constexpr std::uint32_t y =
+    constexpr_output<librandom::lfsr113_tausworthe>(100);
+  librandom::lfsr113_tausworthe lfsr113_engine;
+  lfsr113_engine.discard(100);
+  assert(lfsr113_engine() == y);
+
+  return EXIT_SUCCESS;
+}
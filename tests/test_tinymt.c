@@ -0,0 +1,120 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for the Tiny Mersenne Twister generators. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "../src/tinymt.h"
+
+#define SEED 1
+
+static const uint64_t jumps[] = { 0, 1, 2, 507, 508, 1000, 123457 };
+
+int main(void)
+{
+  /* Test the 32-bit generator against the reference implementation. */
+  tinymt32_state_t state32, copy32;
+  uint32_t buffer32[1000];
+
+  init_tinymt32(&state32, tinymt32_params(0), SEED);
+  assert(tinymt32(&state32) == UINT32_C(2545341989));
+  assert(tinymt32(&state32) == UINT32_C(981918433));
+  assert(tinymt32(&state32) == UINT32_C(3715302833));
+
+  /* Bulk generation must reproduce the scalar generator. */
+  copy32 = state32;
+  tinymt32_fill(&copy32, buffer32, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer32[i] == tinymt32(&state32));
+  }
+
+  /* Jumping ahead must reproduce stepping. */
+  for (size_t j = 0; j < sizeof(jumps) / sizeof(jumps[0]); j++)
+  {
+    init_tinymt32(&state32, tinymt32_params(1), SEED);
+    copy32 = state32;
+    tinymt32_jump(&copy32, jumps[j]);
+    for (uint64_t i = 0; i < jumps[j]; i++)
+      tinymt32(&state32);
+    for (int i = 0; i < 4; i++)
+      assert(tinymt32(&copy32) == tinymt32(&state32));
+  }
+
+  /* Every built-in parameter set has full period, and gives a different
+   * generator, whose characteristic polynomial differs from those of the
+   * others. */
+  uint64_t phi[TINYMT32_PARAMS_COUNT][2];
+
+  assert(tinymt32_params(TINYMT32_PARAMS_COUNT) == NULL);
+  for (unsigned k = 0; k < TINYMT32_PARAMS_COUNT; k++)
+  {
+    assert(tinymt32_check_params(tinymt32_params(k)));
+    assert(tinymt32_charpoly_params(tinymt32_params(k), phi[k]) == 127);
+    init_tinymt32(&state32, tinymt32_params(k), SEED);
+    buffer32[k] = tinymt32(&state32);
+    for (unsigned l = 0; l < k; l++)
+    {
+      assert(buffer32[l] != buffer32[k]);
+      assert(phi[l][0] != phi[k][0] || phi[l][1] != phi[k][1]);
+    }
+  }
+
+  tinymt32_params_t bad32 = { 0, 0, 0 };
+  assert(!tinymt32_check_params(&bad32));
+
+  /* Test the 64-bit generator against the reference implementation. */
+  tinymt64_state_t state64, copy64;
+  uint64_t buffer64[1000];
+
+  init_tinymt64(&state64, tinymt64_params(0), SEED);
+  assert(tinymt64(&state64) == UINT64_C(15503804787016557143));
+  assert(tinymt64(&state64) == UINT64_C(17280942441431881838));
+  assert(tinymt64(&state64) == UINT64_C(2177846447079362065));
+
+  copy64 = state64;
+  tinymt64_fill(&copy64, buffer64, 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    assert(buffer64[i] == tinymt64(&state64));
+  }
+
+  for (size_t j = 0; j < sizeof(jumps) / sizeof(jumps[0]); j++)
+  {
+    init_tinymt64(&state64, tinymt64_params(1), SEED);
+    copy64 = state64;
+    tinymt64_jump(&copy64, jumps[j]);
+    for (uint64_t i = 0; i < jumps[j]; i++)
+      tinymt64(&state64);
+    for (int i = 0; i < 4; i++)
+      assert(tinymt64(&copy64) == tinymt64(&state64));
+  }
+
+  uint64_t phi64[TINYMT64_PARAMS_COUNT][2];
+
+  assert(tinymt64_params(TINYMT64_PARAMS_COUNT) == NULL);
+  for (unsigned k = 0; k < TINYMT64_PARAMS_COUNT; k++)
+  {
+    assert(tinymt64_check_params(tinymt64_params(k)));
+    assert(tinymt64_charpoly_params(tinymt64_params(k), phi64[k]) == 127);
+    init_tinymt64(&state64, tinymt64_params(k), SEED);
+    buffer64[k] = tinymt64(&state64);
+    for (unsigned l = 0; l < k; l++)
+    {
+      assert(buffer64[l] != buffer64[k]);
+      assert(phi64[l][0] != phi64[k][0] || phi64[l][1] != phi64[k][1]);
+    }
+  }
+
+  tinymt64_params_t bad64 = { 0, 0, 0 };
+  assert(!tinymt64_check_params(&bad64));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,222 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* Unit tests for deviates of continuous distributions and the
+ * approximations of simd.h they use. */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "../src/variate.h"
+#include "../src/normal.h"
+#include "../src/simd.h"
+
+#define N 200000
+
+#define PI 3.14159265358979323846
+#define TWO_PI 6.28318530717958647692
+
+/* Unit in the last place of x, including subnormal x. */
+static double ulp (double x)
+{
+  int e;
+
+  frexp(x, &e);
+
+  return e - 53 < -1074 ? 0x1p-1074 : ldexp(1.0, e - 53);
+}
+
+/* Sample mean and variance of x[0..n-1]. */
+static void moments (const double *x, size_t n, double *mean, double *var)
+{
+  double m = 0, v = 0;
+
+  for (size_t i = 0; i < n; i++)
+    m += x[i];
+  m /= n;
+  for (size_t i = 0; i < n; i++)
+    v += (x[i] - m) * (x[i] - m);
+
+  *mean = m;
+  *var = v / n;
+}
+
+/* Whether the angles x and y differ by at most tol, modulo 2 pi. */
+static int same_angle (double x, double y, double tol)
+{
+  const double d = fabs(x - y);
+
+  return d <= tol || TWO_PI - d <= tol;
+}
+
+/* Check that the batched sampler, called by the macro FILL(out, n), gives
+ * the same deviates for every instruction set, and the scalar sampler
+ * SCALAR() deviates y close to every step-th deviate x of the batch by
+ * CLOSE(x, y). */
+#define CHECK_SAMPLER(FILL, SCALAR, CLOSE, step) \
+  do { \
+    random_init(&rng, RANDOM_PCG64, 5, 6); \
+    copy = rng; \
+    FILL(a, N); \
+    for (int level = RANDOM_SIMD_GENERIC; level <= RANDOM_SIMD_AVX512; \
+         level++) \
+    { \
+      random_simd_limit(level); \
+      rng = copy; \
+      FILL(b, N); \
+      assert(memcmp(a, b, N * sizeof(double)) == 0); \
+    } \
+    random_simd_limit(RANDOM_SIMD_AVX512); \
+    rng = copy; \
+    for (int i = 0; i < N; i += step) \
+    { \
+      const double y = SCALAR(); \
+      assert(CLOSE(a[i], y)); \
+    } \
+  } while (0)
+
+int main(void)
+{
+  double *a = malloc(N * sizeof(double));
+  double *b = malloc(N * sizeof(double));
+  uint64_t *words = malloc(N * sizeof(uint64_t));
+  random_t rng, copy;
+  double mean, var;
+
+  /* exp, pow and acos agree with libm. */
+  assert(random_init(&rng, RANDOM_KISS64, 1, 2) == 0);
+  random_fill64(&rng, words, N);
+  for (int i = 0; i < N; i++)
+  {
+    const double u = random_simd_open(words[i]);
+    const double x = -745 + 1454 * u, y = 2 * u - 1;
+    const double p = ldexp(u, (int) (words[i] & 63) - 31);
+    const double e = 16 * random_simd_unit(words[i] << 12) - 8;
+
+    assert(fabs(random_simd_exp(x) - exp(x)) <= ulp(exp(x)));
+    assert(fabs(random_simd_exp(y) - exp(y)) <= ulp(exp(y)));
+    assert(fabs(random_simd_acos(y) - acos(y)) <= ulp(acos(y)));
+    assert(fabs(random_simd_pow(p, e) - pow(p, e))
+           <= (2 * fabs(e * log(p)) + 2) * ulp(pow(p, e)));
+  }
+
+  assert(random_simd_exp(0) == 1);
+  assert(random_simd_exp(1e-300) == 1);
+  assert(random_simd_exp(710) == HUGE_VAL);
+  assert(random_simd_exp(-HUGE_VAL) == 0 && random_simd_exp(HUGE_VAL)
+         == HUGE_VAL);
+  assert(random_simd_exp(-745) == exp(-745));
+  assert(random_simd_acos(1) == 0 && random_simd_acos(-1) == acos(-1.0));
+  assert(random_simd_acos(0) == acos(0.0));
+
+#define TRIANGULAR_FILL(out, n) \
+  random_triangular_fill(&rng, 1, 4, 1.5, out, n)
+#define TRIANGULAR() random_triangular(&rng, 1, 4, 1.5)
+#define EQUAL(x, y) ((x) == (y))
+  CHECK_SAMPLER(TRIANGULAR_FILL, TRIANGULAR, EQUAL, 1);
+  moments(a, N, &mean, &var);
+  assert(fabs(mean - 6.5 / 3) < 5 * sqrt(7.75 / 18 / N));
+  assert(fabs(var - 7.75 / 18) < 0.01);
+  for (int i = 0; i < N; i++)
+    assert(a[i] >= 1 && a[i] <= 4);
+
+  /* An empty interval, and modes at the ends. */
+  random_triangular_fill(&rng, 2, 2, 2, a, 10);
+  for (int i = 0; i < 10; i++)
+    assert(a[i] == 2);
+  random_triangular_fill(&rng, 0, 1, 0, a, N);
+  moments(a, N, &mean, &var);
+  assert(fabs(mean - 1 / 3.0) < 5 * sqrt(1 / 18.0 / N));
+
+  /* Log-normal deviates: the scalar sampler takes the first of each pair of
+   * normal deviates, and agrees within the documented bound, in which
+   * sigma z = log(y) - mu. */
+#define LOGNORMAL_FILL(out, n) \
+  random_lognormvariate_fill(&rng, 0.5, 0.75, out, n)
+#define LOGNORMAL() random_lognormvariate(&rng, 0.5, 0.75)
+#define LOGNORMAL_CLOSE(x, y) \
+  (fabs((x) - (y)) <= (1 + 4 * fabs(log(y) - 0.5) + 4) * ulp(y))
+  CHECK_SAMPLER(LOGNORMAL_FILL, LOGNORMAL, LOGNORMAL_CLOSE, 2);
+  moments(a, N, &mean, &var);
+  {
+    const double m = exp(0.5 + 0.75 * 0.75 / 2);
+    const double v = (exp(0.75 * 0.75) - 1) * m * m;
+
+    assert(fabs(mean - m) < 5 * sqrt(v / N));
+  }
+
+  /* The lognormal deviates are the exponentials of the normal ones. */
+  rng = copy;
+  random_normal_fill(&rng, 0.5, 0.75, b, 1001);
+  rng = copy;
+  random_lognormvariate_fill(&rng, 0.5, 0.75, a, 1001);
+  for (int i = 0; i < 1001; i++)
+    assert(a[i] == random_simd_exp(b[i]));
+
+  /* Pareto deviates of shape 3, within the error bound of pow, and no more
+   * than 2^(53 / 3), for the least uniform deviate. */
+#define PARETO_FILL(out, n) random_paretovariate_fill(&rng, 3, out, n)
+#define PARETO() random_paretovariate(&rng, 3)
+#define POW_CLOSE(x, y, r) (fabs((x) - (y)) <= (2 * fabs(r) + 4) * ulp(y))
+#define PARETO_CLOSE(x, y) POW_CLOSE(x, y, log(y))
+  CHECK_SAMPLER(PARETO_FILL, PARETO, PARETO_CLOSE, 1);
+  moments(a, N, &mean, &var);
+  for (int i = 0; i < N; i++)
+    assert(a[i] >= 1 && a[i] <= 1.000001 * pow(2, 53 / 3.0));
+  assert(fabs(mean - 1.5) < 0.02);
+
+  /* Weibull deviates of scale 2 and shape 1.5: mean 2 gamma(5 / 3). */
+#define WEIBULL_FILL(out, n) random_weibullvariate_fill(&rng, 2, 1.5, out, n)
+#define WEIBULL() random_weibullvariate(&rng, 2, 1.5)
+#define WEIBULL_CLOSE(x, y) POW_CLOSE(x, y, log((y) / 2))
+  CHECK_SAMPLER(WEIBULL_FILL, WEIBULL, WEIBULL_CLOSE, 1);
+  moments(a, N, &mean, &var);
+  {
+    const double m = 2 * tgamma(5 / 3.0);
+    const double v = 4 * tgamma(7 / 3.0) - m * m;
+
+    assert(fabs(mean - m) < 5 * sqrt(v / N));
+  }
+
+  /* Von Mises deviates: the mean resultant length for kappa = 2 is
+   * I1(2) / I0(2). Angles are compared modulo 2 pi. */
+#define VON_MISES_FILL(out, n) \
+  random_vonmisesvariate_fill(&rng, 1, 2, out, n)
+#define VON_MISES() random_vonmisesvariate(&rng, 1, 2)
+#define VON_MISES_CLOSE(x, y) same_angle(x, y, 1e-13)
+  CHECK_SAMPLER(VON_MISES_FILL, VON_MISES, VON_MISES_CLOSE, 1);
+  {
+    double c = 0, s = 0;
+
+    for (int i = 0; i < N; i++)
+    {
+      assert(a[i] >= 0 && a[i] < TWO_PI);
+      c += cos(a[i]);
+      s += sin(a[i]);
+    }
+    assert(fabs(atan2(s, c) - 1) < 0.01);
+    assert(fabs(sqrt(c * c + s * s) / N - 0.6977746579640082) < 0.005);
+  }
+
+  /* Negligible concentration: uniform angles, one word each. */
+  random_init(&rng, RANDOM_PCG64, 5, 6);
+  copy = rng;
+  random_vonmisesvariate_fill(&rng, 1, 1e-9, a, N);
+  rng = copy;
+  assert(random_vonmisesvariate(&rng, 1, 1e-9) == a[0]);
+  moments(a, N, &mean, &var);
+  assert(fabs(mean - PI) < 5 * sqrt(PI * PI / 3 / N));
+
+  free(a);
+  free(b);
+  free(words);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,445 @@
+/* Copyright (C) 2012-2015, C G Wrench. All rights reserved.
+ * This file is part of librandom and is released under the BSD 2-Clause
+ * License. See the file COPYING for the full license text.
+ */
+
+/* librandom-gen: write the output of a generator to stdout or a file.
+ *
+ * Usage: librandom-gen [-g generator] [-s seed] [-t stream] [-n count]
+ *                      [-f binary|text] [-b buffer size] [-o file] [-l]
+ *
+ * Writes count words (unlimited by default) of the named generator, seeded
+ * by random_init(seed, stream), either as raw native-endian binary words or
+ * as decimal text, one word per line. Suitable for feeding statistical test
+ * batteries and data pipelines, e.g.
+ *
+ *     librandom-gen -g lfsr258 -s 42 | dieharder -a -g 200
+ *
+ * Words are generated by a separate thread into a ring of large page-aligned
+ * buffers, while the main thread writes the previous buffer. When binary
+ * output goes to a pipe on Linux, buffers are passed to the pipe with
+ * vmsplice(), which maps the pages into the pipe instead of copying them;
+ * see write_splice() below.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "generator.h"
+
+#define PROGRAM "librandom-gen"
+
+/* Number of buffers in the ring, and default size of each in bytes. */
+#define NBUFFERS 3
+#define BUFFER_SIZE (1 << 20)
+
+/* Maximum length of a word in decimal, plus a newline. */
+#define TEXT_WIDTH 21
+
+typedef struct {
+  unsigned char *data;
+  size_t length; /* Bytes of data; zero marks the end of the output. */
+  int full;
+} buffer_t;
+
+typedef struct {
+  random_t rng;
+  int text;
+  size_t word_size;
+  uintmax_t count; /* Words remaining, if limited. */
+  int limited;
+  size_t size;     /* Capacity of each buffer in bytes. */
+  unsigned char *words; /* Scratch space for text output. */
+  buffer_t buffers[NBUFFERS];
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  int stop;
+} output_t;
+
+static void usage (FILE *stream)
+{
+  fprintf(stream,
+    "Usage: " PROGRAM " [options]\n"
+    "Write the output of a librandom generator to stdout or a file.\n\n"
+    "  -g NAME    generator (default mt19937_64); see -l\n"
+    "  -s SEED    seed (default 0)\n"
+    "  -t STREAM  substream (default 0)\n"
+    "  -n COUNT   number of words to write (default unlimited)\n"
+    "  -f FORMAT  binary (native-endian words, default) or text (decimal)\n"
+    "  -b BYTES   size of each output buffer (default %d)\n"
+    "  -o FILE    write to FILE rather than stdout\n"
+    "  -l         list the generators and exit\n"
+    "  -h         display this help and exit\n", BUFFER_SIZE);
+}
+
+static int parse_number (const char *arg, uintmax_t *value)
+{
+  char *end;
+
+  errno = 0;
+  *value = strtoumax(arg, &end, 0);
+
+  return errno == 0 && end != arg && *end == '\0' && arg[0] != '-';
+}
+
+/* Format words[0..n-1] as decimal lines into out, returning the length. */
+static size_t format_text (const unsigned char *words, size_t word_size,
+                           size_t n, unsigned char *out)
+{
+  unsigned char *p = out;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    unsigned char digits[TEXT_WIDTH];
+    unsigned char *d = digits + sizeof(digits);
+    uint64_t x;
+
+    if (word_size == 4)
+      x = ((const uint32_t *) words)[i];
+    else
+      x = ((const uint64_t *) words)[i];
+
+    *--d = '\n';
+    do
+    {
+      *--d = (unsigned char) ('0' + x % 10);
+      x /= 10;
+    } while (x != 0);
+
+    memcpy(p, d, (size_t) (digits + sizeof(digits) - d));
+    p += digits + sizeof(digits) - d;
+  }
+
+  return (size_t) (p - out);
+}
+
+/* Generator thread: fill each free buffer of the ring in turn. */
+static void *generate (void *arg)
+{
+  output_t *o = arg;
+  size_t k;
+
+  for (k = 0; ; k = (k + 1) % NBUFFERS)
+  {
+    buffer_t *b = &o->buffers[k];
+    size_t n = o->text ? o->size / TEXT_WIDTH : o->size / o->word_size;
+    int stop;
+
+    pthread_mutex_lock(&o->lock);
+    while (b->full && !o->stop)
+      pthread_cond_wait(&o->cond, &o->lock);
+    stop = o->stop;
+    pthread_mutex_unlock(&o->lock);
+
+    if (stop)
+      break;
+
+    if (o->limited)
+    {
+      if (n > o->count)
+        n = (size_t) o->count;
+      o->count -= n;
+    }
+
+    if (o->text)
+    {
+      random_fill(&o->rng, o->words, n);
+      b->length = format_text(o->words, o->word_size, n, b->data);
+    }
+    else
+    {
+      random_fill(&o->rng, b->data, n);
+      b->length = n * o->word_size;
+    }
+
+    pthread_mutex_lock(&o->lock);
+    b->full = 1;
+    pthread_cond_broadcast(&o->cond);
+    pthread_mutex_unlock(&o->lock);
+
+    if (n == 0)
+      break;
+  }
+
+  return NULL;
+}
+
+static int write_all (int fd, const unsigned char *data, size_t length)
+{
+  while (length > 0)
+  {
+    ssize_t w = write(fd, data, length);
+
+    if (w < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+
+    data += w;
+    length -= (size_t) w;
+  }
+
+  return 0;
+}
+
+#ifdef __linux__
+
+/* Pass data to the pipe fd by mapping its pages rather than copying them.
+ * The pages remain referenced by the pipe until the reader consumes them, so
+ * a buffer may only be reused once the pipe can no longer hold any of it.
+ * Since each buffer is at least as large as the pipe, this is the case once
+ * the whole of the following buffer has been spliced: main() therefore
+ * releases each buffer one buffer late. */
+static int write_splice (int fd, const unsigned char *data, size_t length)
+{
+  while (length > 0)
+  {
+    struct iovec iov;
+    ssize_t w;
+
+    iov.iov_base = (void *) data;
+    iov.iov_len = length;
+    w = vmsplice(fd, &iov, 1, 0);
+
+    if (w < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+
+    data += w;
+    length -= (size_t) w;
+  }
+
+  return 0;
+}
+
+#endif /* ifdef __linux__ */
+
+static void release (output_t *o, buffer_t *b)
+{
+  pthread_mutex_lock(&o->lock);
+  b->full = 0;
+  pthread_cond_broadcast(&o->cond);
+  pthread_mutex_unlock(&o->lock);
+}
+
+int main (int argc, char *argv[])
+{
+  const char *name = "mt19937_64";
+  const char *path = NULL;
+  uintmax_t seed = 0, stream = 0, count = 0, size = BUFFER_SIZE;
+  int limited = 0, text = 0, splice = 0;
+  random_generator_id_t id;
+  output_t o;
+  pthread_t thread;
+  buffer_t *previous = NULL;
+  int fd = STDOUT_FILENO;
+  int status = EXIT_SUCCESS;
+  struct stat st;
+  size_t k;
+  int c;
+
+  while ((c = getopt(argc, argv, "g:s:t:n:f:b:o:lh")) != -1)
+  {
+    switch (c)
+    {
+      case 'g':
+        name = optarg;
+        break;
+      case 's':
+        if (!parse_number(optarg, &seed))
+          goto invalid;
+        break;
+      case 't':
+        if (!parse_number(optarg, &stream))
+          goto invalid;
+        break;
+      case 'n':
+        if (!parse_number(optarg, &count))
+          goto invalid;
+        limited = 1;
+        break;
+      case 'f':
+        if (strcmp(optarg, "text") == 0)
+          text = 1;
+        else if (strcmp(optarg, "binary") == 0)
+          text = 0;
+        else
+          goto invalid;
+        break;
+      case 'b':
+        if (!parse_number(optarg, &size) || size < 4096 || size > SIZE_MAX / 2)
+          goto invalid;
+        break;
+      case 'o':
+        path = optarg;
+        break;
+      case 'l':
+        for (c = 0; c < RANDOM_GENERATOR_COUNT; c++)
+          printf("%s\n", random_generator_info(c)->name);
+        return EXIT_SUCCESS;
+      case 'h':
+        usage(stdout);
+        return EXIT_SUCCESS;
+      default:
+        usage(stderr);
+        return 2;
+    }
+  }
+
+  if (optind != argc)
+  {
+    usage(stderr);
+    return 2;
+  }
+
+  id = random_generator_find(name);
+  if (id == RANDOM_GENERATOR_COUNT)
+  {
+    fprintf(stderr, PROGRAM ": unknown generator '%s'; see -l\n", name);
+    return 2;
+  }
+
+  if (path != NULL)
+  {
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+    {
+      fprintf(stderr, PROGRAM ": %s: %s\n", path, strerror(errno));
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* A closed pipe simply ends the output. */
+  signal(SIGPIPE, SIG_IGN);
+
+#ifdef __linux__
+  if (!text && fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode))
+  {
+    /* Enlarge the pipe towards the buffer size, and the buffers to at least
+     * the size of the pipe, as required by write_splice(). */
+    int pipe_size = fcntl(fd, F_SETPIPE_SZ, (int) size);
+
+    if (pipe_size < 0)
+      pipe_size = fcntl(fd, F_GETPIPE_SZ);
+    if (pipe_size > 0)
+    {
+      if ((uintmax_t) pipe_size > size)
+        size = (uintmax_t) pipe_size;
+      splice = 1;
+    }
+  }
+#else
+  (void) st;
+#endif /* ifdef __linux__ */
+
+  /* Page-aligned buffers of a whole number of pages. */
+  size = (size + 4095) / 4096 * 4096;
+
+  memset(&o, 0, sizeof(o));
+  random_init(&o.rng, id, seed, stream);
+  o.text = text;
+  o.word_size = random_generator_info(id)->word_bits / 8;
+  o.count = count;
+  o.limited = limited;
+  o.size = (size_t) size;
+  pthread_mutex_init(&o.lock, NULL);
+  pthread_cond_init(&o.cond, NULL);
+
+  if (text && (o.words = malloc(o.size / TEXT_WIDTH * o.word_size)) == NULL)
+    goto nomem;
+  for (k = 0; k < NBUFFERS; k++)
+  {
+    void *data;
+
+    if (posix_memalign(&data, 4096, o.size))
+      goto nomem;
+    o.buffers[k].data = data;
+  }
+
+  if (pthread_create(&thread, NULL, generate, &o))
+  {
+    fprintf(stderr, PROGRAM ": cannot create thread\n");
+    return EXIT_FAILURE;
+  }
+
+  for (k = 0; ; k = (k + 1) % NBUFFERS)
+  {
+    buffer_t *b = &o.buffers[k];
+    int error;
+
+    pthread_mutex_lock(&o.lock);
+    while (!b->full)
+      pthread_cond_wait(&o.cond, &o.lock);
+    pthread_mutex_unlock(&o.lock);
+
+    if (b->length == 0)
+      break;
+
+#ifdef __linux__
+    if (splice)
+      error = write_splice(fd, b->data, b->length);
+    else
+#endif /* ifdef __linux__ */
+      error = write_all(fd, b->data, b->length);
+
+    if (error)
+    {
+      if (errno != EPIPE)
+      {
+        fprintf(stderr, PROGRAM ": write error: %s\n", strerror(errno));
+        status = EXIT_FAILURE;
+      }
+      break;
+    }
+
+    if (splice)
+    {
+      if (previous != NULL)
+        release(&o, previous);
+      previous = b;
+    }
+    else
+    {
+      release(&o, b);
+    }
+  }
+
+  pthread_mutex_lock(&o.lock);
+  o.stop = 1;
+  pthread_cond_broadcast(&o.cond);
+  pthread_mutex_unlock(&o.lock);
+  pthread_join(thread, NULL);
+
+  if (path != NULL && close(fd) != 0)
+  {
+    fprintf(stderr, PROGRAM ": %s: %s\n", path, strerror(errno));
+    status = EXIT_FAILURE;
+  }
+
+  return status;
+
+invalid:
+  fprintf(stderr, PROGRAM ": invalid argument to -%c: '%s'\n", c, optarg);
+  return 2;
+
+nomem:
+  fprintf(stderr, PROGRAM ": out of memory\n");
+  return EXIT_FAILURE;
+}